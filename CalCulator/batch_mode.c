@@ -0,0 +1,333 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "math_ops.h"
+#include "expression_eval.h"
+#include "resistor_calc.h"
+#include "capacitor_calc.h"
+#include "inductor_calc.h"
+#include "parallel.h"
+#include "file_map.h"
+#include "batch_mode.h"
+
+#define BATCH_MAX_ARGS  64
+#define BATCH_CHUNK     (4u << 20)   /* bytes of input handed to the pool at once */
+
+/* ────────────────────────────────────────────────
+   REQUEST TABLE
+   Numeric requests receive their arguments already
+   parsed (SI prefixes applied); text requests get
+   the raw remainder of the line.
+   ──────────────────────────────────────────────── */
+
+typedef const char *(*num_fn)(const double *a, int n, double *result);
+typedef const char *(*text_fn)(const char *s, size_t len, double *result);
+
+static const char *op_add(const double *a, int n, double *r) { (void)n; *r = a[0] + a[1]; return NULL; }
+static const char *op_sub(const double *a, int n, double *r) { (void)n; *r = a[0] - a[1]; return NULL; }
+static const char *op_mul(const double *a, int n, double *r) { (void)n; *r = a[0] * a[1]; return NULL; }
+
+static const char *op_div(const double *a, int n, double *r) {
+    (void)n;
+    if (a[1] == 0.0) return "division by zero";
+    *r = a[0] / a[1];
+    return NULL;
+}
+
+static const char *op_pow(const double *a, int n, double *r) { (void)n; *r = pow(a[0], a[1]); return NULL; }
+
+static const char *op_sqrt(const double *a, int n, double *r) {
+    (void)n;
+    if (a[0] < 0.0) return "square root of a negative number";
+    *r = sqrt(a[0]);
+    return NULL;
+}
+
+static const char *op_log10(const double *a, int n, double *r) {
+    (void)n;
+    if (a[0] <= 0.0) return "logarithm of zero or a negative number";
+    *r = log10(a[0]);
+    return NULL;
+}
+
+/* Ohm's law: the name says what is computed, the arguments are the knowns */
+static const char *op_ohm_v(const double *a, int n, double *r) { (void)n; *r = a[0] * a[1]; return NULL; }
+
+static const char *op_ohm_i(const double *a, int n, double *r) {
+    (void)n;
+    if (a[1] == 0.0) return "division by zero (R = 0)";
+    *r = a[0] / a[1];
+    return NULL;
+}
+
+static const char *op_ohm_r(const double *a, int n, double *r) {
+    (void)n;
+    if (a[1] == 0.0) return "division by zero (I = 0)";
+    *r = a[0] / a[1];
+    return NULL;
+}
+
+static const char *op_ohm_p(const double *a, int n, double *r) { (void)n; *r = a[0] * a[1]; return NULL; }
+
+static const char *op_series(const double *a, int n, double *r) { *r = series_total(a, n); return NULL; }
+
+static const char *op_parallel(const double *a, int n, double *r) {
+    for (int i = 0; i < n; i++)
+        if (a[i] == 0.0) return "zero value in parallel combination";
+    *r = parallel_total(a, n);
+    return NULL;
+}
+
+static const char *op_xc(const double *a, int n, double *r) {
+    (void)n;
+    if (a[0] == 0.0 || a[1] == 0.0) return "invalid input";
+    *r = 1.0 / (2.0 * M_PI * a[0] * a[1]);
+    return NULL;
+}
+
+static const char *op_xl(const double *a, int n, double *r) { (void)n; *r = 2.0 * M_PI * a[0] * a[1]; return NULL; }
+static const char *op_tau_rc(const double *a, int n, double *r) { (void)n; *r = a[0] * a[1]; return NULL; }
+
+static const char *op_tau_rl(const double *a, int n, double *r) {
+    (void)n;
+    if (a[1] == 0.0) return "resistance cannot be zero";
+    *r = a[0] / a[1];
+    return NULL;
+}
+
+static const char *op_charge(const double *a, int n, double *r) { (void)n; *r = a[0] * a[1]; return NULL; }
+static const char *op_energy(const double *a, int n, double *r) { (void)n; *r = 0.5 * a[0] * a[1] * a[1]; return NULL; }
+
+static const char *op_expr(const char *s, size_t len, double *r) {
+    char buf[256];
+    if (len >= sizeof(buf)) return "expression too long";
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+
+    expr_set_quiet(1);
+    if (expr_cache_eval(buf, r)) return expr_last_error()[0] ? expr_last_error() : "out of memory";
+    return NULL;
+}
+
+static const char *op_smd_r(const char *s, size_t len, double *r) {
+    return smd_resistor_value(s, len, r) ? NULL : "unknown SMD resistor code";
+}
+
+static const char *op_smd_c(const char *s, size_t len, double *r) {
+    return smd_capacitor_value(s, len, r) ? NULL : "unknown capacitor code";
+}
+
+static const char *op_smd_l(const char *s, size_t len, double *r) {
+    return smd_inductor_value(s, len, r) ? NULL : "unknown inductor code";
+}
+
+typedef struct {
+    const char *name;
+    int min_args, max_args;     /* numeric requests only */
+    num_fn num;
+    text_fn text;
+    const char *usage;
+} batch_op_t;
+
+static const batch_op_t ops[] = {
+    {"expr",     0, 0, NULL, op_expr,  "<expression>"},
+    {"add",      2, 2, op_add, NULL,   "a b"},
+    {"sub",      2, 2, op_sub, NULL,   "a b"},
+    {"mul",      2, 2, op_mul, NULL,   "a b"},
+    {"div",      2, 2, op_div, NULL,   "a b"},
+    {"pow",      2, 2, op_pow, NULL,   "x y"},
+    {"sqrt",     1, 1, op_sqrt, NULL,  "x"},
+    {"log10",    1, 1, op_log10, NULL, "x"},
+    {"ohm_v",    2, 2, op_ohm_v, NULL, "I R"},
+    {"ohm_i",    2, 2, op_ohm_i, NULL, "V R"},
+    {"ohm_r",    2, 2, op_ohm_r, NULL, "V I"},
+    {"ohm_p",    2, 2, op_ohm_p, NULL, "V I"},
+    {"series",   1, BATCH_MAX_ARGS, op_series, NULL,   "v1 v2 ... (R/L in series, C in parallel)"},
+    {"parallel", 1, BATCH_MAX_ARGS, op_parallel, NULL, "v1 v2 ... (R/L in parallel, C in series)"},
+    {"xc",       2, 2, op_xc, NULL,     "f C"},
+    {"xl",       2, 2, op_xl, NULL,     "f L"},
+    {"tau_rc",   2, 2, op_tau_rc, NULL, "R C"},
+    {"tau_rl",   2, 2, op_tau_rl, NULL, "L R"},
+    {"charge",   2, 2, op_charge, NULL, "C V"},
+    {"energy_c", 2, 2, op_energy, NULL, "C V"},
+    {"energy_l", 2, 2, op_energy, NULL, "L I"},
+    {"smd_r",    0, 0, NULL, op_smd_r,  "<code>"},
+    {"smd_c",    0, 0, NULL, op_smd_c,  "<code>"},
+    {"smd_l",    0, 0, NULL, op_smd_l,  "<code>"},
+    {NULL, 0, 0, NULL, NULL, NULL}
+};
+
+void batch_print_help(void) {
+    printf("Batch requests (one per line, values accept T,G,M,k,m,u,n,p,f):\n");
+    for (int i = 0; ops[i].name; i++)
+        printf("  %-9s %s\n", ops[i].name, ops[i].usage);
+}
+
+/* ────────────────────────────────────────────────
+   SINGLE REQUEST
+   ──────────────────────────────────────────────── */
+
+int batch_find_numeric(const char *name) {
+    for (int i = 0; ops[i].name; i++)
+        if (ops[i].num && strcmp(ops[i].name, name) == 0) return i;
+    return -1;
+}
+
+const char *batch_eval_numeric(int request, const double *args, int n, double *result) {
+    const batch_op_t *op = &ops[request];
+    if (n < op->min_args) return "missing argument";
+    if (n > op->max_args) return "too many arguments";
+    return op->num(args, n, result);
+}
+
+static const char *eval_request(const char *p, const char *end, double *result) {
+    const char *name = p;
+    while (p < end && !isspace((unsigned char)*p)) p++;
+    size_t name_len = p - name;
+    while (p < end && isspace((unsigned char)*p)) p++;
+
+    const batch_op_t *op = NULL;
+    for (int i = 0; ops[i].name; i++) {
+        if (strlen(ops[i].name) == name_len && memcmp(ops[i].name, name, name_len) == 0) {
+            op = &ops[i];
+            break;
+        }
+    }
+    if (!op) return "unknown request";
+
+    if (op->text) {
+        while (end > p && isspace((unsigned char)end[-1])) end--;
+        if (p == end) return "missing argument";
+        return op->text(p, end - p, result);
+    }
+
+    double args[BATCH_MAX_ARGS];
+    int n = 0;
+    while (p < end) {
+        const char *t = p;
+        size_t used;
+        while (p < end && !isspace((unsigned char)*p)) p++;
+
+        if (n == op->max_args) return "too many arguments";
+        args[n++] = parse_prefix_n(t, p - t, &used);
+        if (used == 0) return "bad number";
+        while (p < end && isspace((unsigned char)*p)) p++;
+    }
+    if (n < op->min_args) return "missing argument";
+    return op->num(args, n, result);
+}
+
+size_t batch_eval_line(const char *line, size_t len, char *out, size_t cap) {
+    const char *p = line, *end = line + len;
+    while (p < end && isspace((unsigned char)*p)) p++;
+    if (end > p && end[-1] == '\r') end--;
+
+    if (p == end || *p == '#') {
+        if (cap) out[0] = '\0';
+        return 0;
+    }
+
+    double result;
+    const char *err = eval_request(p, end, &result);
+    size_t n = err ? (size_t)snprintf(out, cap, "error: %s", err)
+                   : format_shortest(out, cap, result);
+    return n < cap ? n : cap - 1;
+}
+
+/* ────────────────────────────────────────────────
+   STREAMING DRIVER
+   Input is read in BATCH_CHUNK pieces cut at a line
+   boundary. Each piece is split into tasks of whole
+   lines; every task writes into its own buffer and
+   the buffers are written out in task order.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    const char *data;
+    size_t size;
+    int n_tasks;
+    file_out_t *outs;
+} batch_chunk_t;
+
+static void batch_task(void *ctx, int task) {
+    batch_chunk_t *c = ctx;
+    file_out_t *o = &c->outs[task];
+    size_t begin = file_line_start(c->data, c->size, c->size / c->n_tasks * task);
+    size_t stop = task == c->n_tasks - 1 ? c->size
+                : file_line_start(c->data, c->size, c->size / c->n_tasks * (task + 1));
+
+    expr_set_quiet(1);
+    o->len = 0;
+    o->failed = 0;
+    while (begin < stop) {
+        const char *nl = memchr(c->data + begin, '\n', stop - begin);
+        size_t len = nl ? (size_t)(nl - (c->data + begin)) : stop - begin;
+        if (!file_out_reserve(o, BATCH_LINE_OUT + 1)) return;
+        o->len += batch_eval_line(c->data + begin, len, o->buf + o->len, BATCH_LINE_OUT);
+        o->buf[o->len++] = '\n';
+        begin += len + 1;
+    }
+}
+
+int batch_run(const char *in_path, const char *out_path) {
+    FILE *in = strcmp(in_path, "-") == 0 ? stdin : fopen(in_path, "rb");
+    if (!in) { fprintf(stderr, "Error: cannot open %s\n", in_path); return 1; }
+    FILE *out = strcmp(out_path, "-") == 0 ? stdout : fopen(out_path, "wb");
+    if (!out) { fprintf(stderr, "Error: cannot create %s\n", out_path); if (in != stdin) fclose(in); return 1; }
+
+    int n_tasks = par_threads() * 4;
+    size_t cap = BATCH_CHUNK, have = 0;
+    char *data = malloc(cap);
+    file_out_t *outs = calloc(n_tasks, sizeof(file_out_t));
+    int rc = 0;
+    if (!data || !outs) { fprintf(stderr, "Error: out of memory\n"); rc = 1; goto done; }
+
+    for (;;) {
+        size_t got = fread(data + have, 1, cap - have, in);
+        have += got;
+        if (ferror(in)) { fprintf(stderr, "Error: reading %s failed\n", in_path); rc = 1; break; }
+        int eof = got == 0 || feof(in);
+
+        /* Hand over complete lines only; at EOF the last line may lack '\n' */
+        size_t usable = have;
+        if (!eof) {
+            while (usable > 0 && data[usable - 1] != '\n') usable--;
+            if (usable == 0) {          /* one line longer than the buffer */
+                char *bigger = realloc(data, cap * 2);
+                if (!bigger) { fprintf(stderr, "Error: out of memory\n"); rc = 1; break; }
+                data = bigger;
+                cap *= 2;
+                continue;
+            }
+        }
+
+        if (usable > 0) {
+            batch_chunk_t chunk = { data, usable, n_tasks, outs };
+            if (usable < (size_t)n_tasks * 64) chunk.n_tasks = 1;   /* not worth splitting */
+            par_for(chunk.n_tasks, batch_task, &chunk);
+            for (int t = 0; t < chunk.n_tasks; t++)
+                if (outs[t].failed) rc = 1;
+            if (rc) { fprintf(stderr, "Error: out of memory\n"); break; }
+            for (int t = 0; !rc && t < chunk.n_tasks; t++)
+                if (fwrite(outs[t].buf, 1, outs[t].len, out) != outs[t].len) rc = 2;
+            if (rc) break;
+        }
+
+        memmove(data, data + usable, have - usable);
+        have -= usable;
+        if (eof) break;
+    }
+
+done:
+    if (outs)
+        for (int t = 0; t < n_tasks; t++) free(outs[t].buf);
+    free(outs);
+    free(data);
+    if (in != stdin) fclose(in);
+    if (out != stdout) { if (fclose(out) != 0 && !rc) rc = 2; }
+    else if (fflush(out) != 0 && !rc) rc = 2;
+    if (rc == 2) fprintf(stderr, "Error: writing %s failed\n", out_path);
+    return rc != 0;
+}
@@ -0,0 +1,37 @@
+#ifndef BATCH_MODE_H
+#define BATCH_MODE_H
+
+#include <stddef.h>
+
+/* Non-interactive front end: one request per line, e.g.
+       expr (45k*33)+(22-21)
+       ohm_v 10m 4.7k
+       parallel 1k 2.2k 4.7k
+       smd_r 49C
+   Each request produces exactly one result line (the shortest digits that
+   round-trip the double result, or "error: ..." on failure;
+   blank and '#' comment lines produce an empty line). */
+
+#define BATCH_LINE_OUT 128      /* longest result line, NUL included */
+
+/* Evaluate one request (no newline needed) into out, NUL-terminated.
+   Returns the length written. Thread-safe. */
+size_t batch_eval_line(const char *line, size_t len, char *out, size_t cap);
+
+/* Numeric requests for front ends that already hold binary arguments:
+   batch_find_numeric("ohm_v") gives the request to pass to
+   batch_eval_numeric(), or -1 if there is no numeric request of that
+   name. batch_eval_numeric() returns NULL, or the error text. */
+int batch_find_numeric(const char *name);
+const char *batch_eval_numeric(int request, const double *args, int n, double *result);
+
+/* Stream requests from in_path to out_path ("-" for stdin/stdout) on the
+   worker pool, keeping output in input order. Returns 0 on success, or
+   1 after telling stderr why (unreadable input, out of memory, a failed
+   write); only result lines go to out_path. */
+int batch_run(const char *in_path, const char *out_path);
+
+/* List the request names and their arguments */
+void batch_print_help(void);
+
+#endif
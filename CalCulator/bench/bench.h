@@ -0,0 +1,16 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/* Shared timing and allocation counting for the bench/ programs.
+   Allocation counts come from the linker-wrapped malloc family, so the
+   programs must be linked with
+       -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+   (the Makefile does this). Only calls made from code linked into the
+   benchmark are seen, which is exactly the calculator code under test. */
+
+#include <stddef.h>
+
+double bench_now(void);            /* monotonic seconds */
+unsigned long bench_allocs(void);  /* malloc/calloc/realloc calls so far */
+
+#endif
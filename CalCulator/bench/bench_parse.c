@@ -0,0 +1,83 @@
+/*
+ * parse_with_prefix() throughput: the previous sscanf-based parser against
+ * parse_prefix_n(), plus a precision check on values float could not hold.
+ *
+ * Built by `make bench` as build/bench_parse.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "../math_ops.h"
+
+/* The parser as it was before parse_prefix_n(), kept as the baseline */
+static float legacy_parse(const char *input) {
+    float value = 0.0;
+    char suffix = '\0';
+    char cleaned[20];
+    int i = 0;
+    while (input[i] && i < 19 && (isdigit(input[i]) || input[i] == '.' || isalpha(input[i]))) {
+        cleaned[i] = input[i];
+        i++;
+    }
+    cleaned[i] = '\0';
+    int n = sscanf(cleaned, "%f%c", &value, &suffix);
+    if (n != 2) return value;
+    switch (suffix) {
+        case 'T': return value * 1e12;
+        case 'G': return value * 1e9;
+        case 'M': return value * 1e6;
+        case 'k': case 'K': return value * 1e3;
+        case 'm': return value * 1e-3;
+        case 'u': case 'U': return value * 1e-6;
+        case 'n': return value * 1e-9;
+        case 'p': return value * 1e-12;
+        case 'f': return value * 1e-15;
+        default:  return value;
+    }
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+    static const char *inputs[] = {
+        "4.7k", "10M", "2.2u", "330", "0.1", "47n", "1.5m", "100p", "3.3G", "4.7001k",
+        "12", "220k", "68", "1e3", "0.022u", "1T", "15f", "9.1", "560", "2.49k"
+    };
+    const int n_inputs = sizeof(inputs) / sizeof(inputs[0]);
+    const long iters = 5000000;
+    size_t lens[32];
+    volatile double sink = 0.0;
+
+    for (int i = 0; i < n_inputs; i++) lens[i] = strlen(inputs[i]);
+
+    double t0 = now_sec();
+    for (long i = 0; i < iters; i++)
+        sink += legacy_parse(inputs[i % n_inputs]);
+    double t_legacy = now_sec() - t0;
+
+    t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        int k = i % n_inputs;
+        sink += parse_prefix_n(inputs[k], lens[k], NULL);
+    }
+    double t_new = now_sec() - t0;
+
+    printf("legacy sscanf parser : %7.1f ns/op  %6.1f Mop/s\n",
+           t_legacy / iters * 1e9, iters / t_legacy / 1e6);
+    printf("parse_prefix_n       : %7.1f ns/op  %6.1f Mop/s\n",
+           t_new / iters * 1e9, iters / t_new / 1e6);
+    printf("speedup              : %7.1fx\n\n", t_legacy / t_new);
+
+    printf("%-10s %-22s %-22s\n", "input", "legacy (float)", "parse_prefix_n");
+    for (int i = 0; i < n_inputs; i++)
+        printf("%-10s %-22.17g %-22.17g\n", inputs[i], (double)legacy_parse(inputs[i]),
+               parse_prefix_n(inputs[i], lens[i], NULL));
+
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Shared-memory ring latency: p50 / p99 / max of single round trips for
+ * each kind of request, then the cost per request when 64 are pipelined.
+ *
+ *   build/bench_shm            server on a thread of this process
+ *   build/bench_shm NAME       against `electronics_calc --shm NAME`
+ *
+ * Built by `make bench` as build/bench_shm.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../shm_ring.h"
+
+#define ROUNDS   20000
+#define WARMUP   1000
+#define PIPELINE 64
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void *server_thread(void *name) {
+    shm_serve(name);
+    return NULL;
+}
+
+typedef struct {
+    const char *label;
+    shm_request_t req;
+    double expect;
+} bench_case_t;
+
+static int latency(shm_client_t *c, const bench_case_t *bc) {
+    static long long t[ROUNDS];
+    shm_reply_t rep;
+    int wrong = 0;
+
+    for (int i = 0; i < WARMUP; i++)
+        if (shm_call(c, &bc->req, &rep) != 0) return -1;
+    for (int i = 0; i < ROUNDS; i++) {
+        long long t0 = now_ns();
+        if (shm_call(c, &bc->req, &rep) != 0) return -1;
+        t[i] = now_ns() - t0;
+        wrong += rep.status != 0 || fabs(rep.value - bc->expect) > 1e-12 * fabs(bc->expect);
+    }
+    qsort(t, ROUNDS, sizeof t[0], cmp_ll);
+    printf("%-22s %9lld %9lld %9lld %7d\n", bc->label, t[ROUNDS / 2], t[ROUNDS * 99 / 100],
+           t[ROUNDS - 1], wrong);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    char name[64];
+    pthread_t tid;
+    int own = argc < 2;
+
+    if (own) {
+        snprintf(name, sizeof name, "/calc_bench_%d", (int)getpid());
+        if (pthread_create(&tid, NULL, server_thread, name) != 0) return 1;
+    } else {
+        snprintf(name, sizeof name, "%s", argv[1]);
+    }
+
+    shm_client_t *c = NULL;
+    for (int tries = 0; !c && tries < (own ? 50 : 1); tries++) {
+        if (tries) usleep(20000);
+        c = shm_client_open(name);
+    }
+    if (!c) return 1;
+
+    shm_request_t compile = { .op = SHM_OP_COMPILE };
+    shm_reply_t rep;
+    snprintf(compile.text, sizeof compile.text, "V, R1, R2: V/(R1+R2)*R2");
+    if (shm_call(c, &compile, &rep) != 0 || rep.status) {
+        printf("compile failed: %s\n", rep.error);
+        return 1;
+    }
+
+    bench_case_t cases[] = {
+        { "ohm_v",        { .op = SHM_OP_OHM_V, .n = 2, .arg = { 10e-3, 4.7e3 } }, 47.0 },
+        { "parallel x3",  { .op = SHM_OP_PARALLEL, .n = 3, .arg = { 1e3, 2.2e3, 4.7e3 } },
+          1.0 / (1.0 / 1e3 + 1.0 / 2.2e3 + 1.0 / 4.7e3) },
+        { "xl",           { .op = SHM_OP_XL, .n = 2, .arg = { 50.0, 10e-3 } }, 2.0 * M_PI * 50.0 * 10e-3 },
+        { "expr by id",   { .op = SHM_OP_EXPR, .id = rep.id, .n = 3, .arg = { 5.0, 1e3, 2e3 } },
+          5.0 / 3e3 * 2e3 },
+    };
+
+    printf("%d round trips per request (ns)\n", ROUNDS);
+    printf("%-22s %9s %9s %9s %7s\n", "request", "p50", "p99", "max", "wrong");
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++)
+        if (latency(c, &cases[i]) != 0) { printf("server went away\n"); return 1; }
+
+    long long t0 = now_ns();
+    for (int r = 0; r < ROUNDS / PIPELINE; r++) {
+        for (int i = 0; i < PIPELINE; i++) shm_submit(c, &cases[i % 4].req);
+        for (int i = 0; i < PIPELINE; i++) shm_receive(c, &rep);
+    }
+    long long total = now_ns() - t0;
+    printf("\npipelined %-12d %9.1f ns/request\n", PIPELINE,
+           (double)total / (ROUNDS / PIPELINE * PIPELINE));
+
+    shm_client_close(c);
+    if (own) {
+        shm_stop();
+        pthread_join(tid, NULL);
+    }
+    return 0;
+}
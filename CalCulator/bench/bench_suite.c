@@ -0,0 +1,645 @@
+/*
+ * Micro-benchmark suite for the calculator kernels.
+ *
+ *   make bench                          build and run, write bench_results.json
+ *   build/bench_suite --json out.json   same, explicit output
+ *   build/bench_suite --baseline old.json [--threshold 10]
+ *                                       also flag kernels >10% slower than old.json
+ *   build/bench_suite --filter expr     only kernels whose name contains "expr"
+ *
+ * Every kernel runs a fixed number of operations on fixed inputs (fixed RNG
+ * seed), once to warm up and then BENCH_REPS times; the median is reported
+ * so runs are comparable between releases.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "bench.h"
+#include "../math_ops.h"
+#include "../expression_eval.h"
+#include "../expr_jit.h"
+#include "../resistor_calc.h"
+#include "../digital_logic.h"
+#include "../reduce.h"
+#include "../network.h"
+#include "../eseries.h"
+#include "../bom_decode.h"
+#include "../truth_table.h"
+#include "../bool_expr.h"
+#include "../logic_sim.h"
+#include "../num_convert.h"
+#include "../bit_buffer.h"
+#include "../transient.h"
+#include "../freq_sweep.h"
+#include "../monte_carlo.h"
+
+#define BENCH_REPS 5
+
+static volatile double sink;
+
+/* ────────────────────────────────────────────────
+   KERNELS
+   Each runs 'ops' operations.
+   ──────────────────────────────────────────────── */
+
+static const char *const values[] = {
+    "4.7k", "10M", "2.2u", "330", "0.1", "47n", "1.5m", "100p",
+    "3.3G", "4.7001k", "12", "220k", "68", "1e3", "0.022u", "15f"
+};
+#define N_VALUES (sizeof(values) / sizeof(values[0]))
+
+static const char *const example_expr = "((45k*33)+(22-21)/((45k-44k)*(23m+44k)))";
+
+#define ARRAY_N 1024
+static double array_a[ARRAY_N], array_b[ARRAY_N], array_c[ARRAY_N], array_out[ARRAY_N];
+
+static long k_parse_with_prefix(long ops) {
+    for (long i = 0; i < ops; i++) sink += parse_with_prefix(values[i % N_VALUES]);
+    return ops;
+}
+
+static long k_parse_prefix_n(long ops) {
+    static size_t lens[N_VALUES];
+    if (!lens[0]) for (size_t i = 0; i < N_VALUES; i++) lens[i] = strlen(values[i]);
+    for (long i = 0; i < ops; i++) sink += parse_prefix_n(values[i % N_VALUES], lens[i % N_VALUES], NULL);
+    return ops;
+}
+
+static const char *const numbers[] = {
+    "0xDEADBEEFCAFEF00D", "18446744073709551615", "0b1011001110001111", "0x7FFF",
+    "4096", "0755", "0x00000000FFFFFFFF", "1234567890123"
+};
+#define N_NUMBERS (sizeof(numbers) / sizeof(numbers[0]))
+
+static long k_num_parse(long ops) {
+    static size_t lens[N_NUMBERS];
+    if (!lens[0]) for (size_t i = 0; i < N_NUMBERS; i++) lens[i] = strlen(numbers[i]);
+    for (long i = 0; i < ops; i++) {
+        uint64_t v;
+        num_parse(numbers[i % N_NUMBERS], lens[i % N_NUMBERS], NUM_AUTO, &v);
+        sink += (double)v;
+    }
+    return ops;
+}
+
+static long k_num_format(long ops) {
+    static const int bases[4] = { 2, 8, 10, 16 };
+    char buf[NUM_MAX_CHARS];
+    uint64_t v = 0x9E3779B97F4A7C15ull;
+    for (long i = 0; i < ops; i++) {
+        v = v * 6364136223846793005ull + 1442695040888963407ull;
+        sink += num_format(v >> (i & 63), bases[i & 3], 0, 0, buf);
+    }
+    return ops;
+}
+
+static long k_print_with_prefix(long ops) {
+    /* stdout goes to /dev/null while the kernel runs */
+    fflush(stdout);
+    int saved = dup(1), null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, 1);
+    for (long i = 0; i < ops; i++) print_with_prefix(array_a[i % ARRAY_N], "Ω");
+    fflush(stdout);
+    dup2(saved, 1);
+    close(saved);
+    close(null_fd);
+    return ops;
+}
+
+static long k_format_with_prefix(long ops) {
+    char buf[64];
+    for (long i = 0; i < ops; i++) sink += format_with_prefix(buf, sizeof(buf), array_a[i % ARRAY_N], "Ω");
+    return ops;
+}
+
+static long k_evaluate_expression(long ops) {
+    for (long i = 0; i < ops; i++) sink += evaluate_expression(example_expr);
+    return ops;
+}
+
+/* Same shape as example_expr with different numbers: one cache miss,
+   then hits that still parse every literal */
+static char varied_expr[16][64];
+
+static long k_expr_cache_varied(long ops) {
+    double r;
+    for (long i = 0; i < ops; i++) {
+        expr_cache_eval(varied_expr[i & 15], &r);
+        sink += r;
+    }
+    return ops;
+}
+
+static expr_program_t *example_prog, *vars_prog, *shared_prog;
+static expr_jit_t *vars_jit, *shared_jit;
+
+static long k_expr_run(long ops) {
+    for (long i = 0; i < ops; i++) sink += expr_run(example_prog);
+    return ops;
+}
+
+static long k_expr_eval_batch(long ops) {
+    const double *cols[3] = { array_a, array_b, array_c };
+    for (long i = 0; i < ops; i += ARRAY_N) {
+        expr_eval_batch(vars_prog, cols, ARRAY_N, array_out);
+        sink += array_out[0];
+    }
+    return (ops + ARRAY_N - 1) / ARRAY_N * ARRAY_N;
+}
+
+/* Repeated subterms and constant subtrees, left to the optimizer */
+static long k_expr_eval_batch_shared(long ops) {
+    const double *cols[3] = { array_a, array_b, array_c };
+    for (long i = 0; i < ops; i += ARRAY_N) {
+        expr_eval_batch(shared_prog, cols, ARRAY_N, array_out);
+        sink += array_out[0];
+    }
+    return (ops + ARRAY_N - 1) / ARRAY_N * ARRAY_N;
+}
+
+static long k_expr_jit_batch(long ops) {
+    const double *cols[3] = { array_a, array_b, array_c };
+    for (long i = 0; i < ops; i += ARRAY_N) {
+        expr_jit_eval_batch(vars_jit, cols, ARRAY_N, array_out);
+        sink += array_out[0];
+    }
+    return (ops + ARRAY_N - 1) / ARRAY_N * ARRAY_N;
+}
+
+static long k_expr_jit_batch_shared(long ops) {
+    const double *cols[3] = { array_a, array_b, array_c };
+    for (long i = 0; i < ops; i += ARRAY_N) {
+        expr_jit_eval_batch(shared_jit, cols, ARRAY_N, array_out);
+        sink += array_out[0];
+    }
+    return (ops + ARRAY_N - 1) / ARRAY_N * ARRAY_N;
+}
+
+static long k_expr_jit_scalar(long ops) {
+    double vars[3];
+    for (long i = 0; i < ops; i++) {
+        int r = i & (ARRAY_N - 1);
+        vars[0] = array_a[r];
+        vars[1] = array_b[r];
+        vars[2] = array_c[r];
+        sink += expr_jit_eval(vars_jit, vars);
+    }
+    return ops;
+}
+
+static long k_expr_eval_grad(long ops) {
+    double vars[3], grad[3];
+    for (long i = 0; i < ops; i++) {
+        int r = i & (ARRAY_N - 1);
+        vars[0] = array_a[r];
+        vars[1] = array_b[r];
+        vars[2] = array_c[r];
+        sink += expr_eval_grad(vars_prog, vars, grad) + grad[1];
+    }
+    return ops;
+}
+
+static long k_series_total(long ops) {
+    for (long i = 0; i < ops; i++) sink += series_total(array_a, ARRAY_N);
+    return ops;
+}
+
+static long k_parallel_total(long ops) {
+    for (long i = 0; i < ops; i++) sink += parallel_total(array_a, ARRAY_N);
+    return ops;
+}
+
+#define BIG_N (1 << 22)
+static double *big_array;
+
+static long k_sum_array(long ops) {
+    for (long i = 0; i < ops; i += BIG_N) sink += sum_array(big_array, BIG_N);
+    return (ops + BIG_N - 1) / BIG_N * BIG_N;
+}
+
+static long k_reciprocal_sum_array(long ops) {
+    for (long i = 0; i < ops; i += BIG_N) sink += reciprocal_sum_array(big_array, BIG_N);
+    return (ops + BIG_N - 1) / BIG_N * BIG_N;
+}
+
+/* Byte kernels over the bytes of big_array: two 16 MiB halves */
+#define BYTES_N ((long)BIG_N * 4)
+static unsigned char *bytes_out;
+
+static long k_bitbuf(long ops, int op, uint64_t k) {
+    const unsigned char *a = (const unsigned char *)big_array;
+    if (!bytes_out && !(bytes_out = malloc(BYTES_N))) return ops;
+    for (long i = 0; i < ops; i += BYTES_N) {
+        bitbuf_op(op, a, a + BYTES_N, bytes_out, BYTES_N, k);
+        sink += bytes_out[i & 4095];
+    }
+    return (ops + BYTES_N - 1) / BYTES_N * BYTES_N;
+}
+
+static long k_bitbuf_xor(long ops) { return k_bitbuf(ops, BITBUF_XOR, 0); }
+static long k_bitbuf_rol(long ops) { return k_bitbuf(ops, BITBUF_ROL, 13); }
+
+static long k_bitbuf_popcount(long ops) {
+    for (long i = 0; i < ops; i += 2 * BYTES_N)
+        sink += bitbuf_popcount((const unsigned char *)big_array, 2 * BYTES_N);
+    return (ops + 2 * BYTES_N - 1) / (2 * BYTES_N) * (2 * BYTES_N);
+}
+
+static long k_bitbuf_hamming(long ops) {
+    const unsigned char *a = (const unsigned char *)big_array;
+    for (long i = 0; i < ops; i += BYTES_N) sink += bitbuf_hamming(a, a + BYTES_N, BYTES_N);
+    return (ops + BYTES_N - 1) / BYTES_N * BYTES_N;
+}
+
+/* Underdamped series RLC step response, voltage and current */
+static long k_transient(long ops) {
+    static const tran_circuit_t rlc = { TRAN_RLC, 10, 1e-3, 100e-9, 5, 0, 0 };
+    for (long i = 0; i < ops; i += ARRAY_N) {
+        tran_samples(&rlc, 10e6, (uint64_t)i, ARRAY_N, array_out, array_c);
+        sink += array_out[0];
+    }
+    return (ops + ARRAY_N - 1) / ARRAY_N * ARRAY_N;
+}
+
+/* Series RLC over a 1 Hz - 1 GHz log grid: |Z| and phase */
+static long k_freq_sweep(long ops) {
+    static const fs_circuit_t rlc = { FS_SERIES, 10, 1e-3, 100e-9 };
+    const fs_grid_t grid = { FS_LOG, 1, 1e9, (uint64_t)ops };
+    const fs_result_t out = { NULL, NULL, NULL, array_out, array_c };
+    for (long i = 0; i < ops; i += ARRAY_N) {
+        fs_sweep(&rlc, &grid, (uint64_t)i, ops - i < ARRAY_N ? (size_t)(ops - i) : ARRAY_N, &out);
+        sink += array_out[0];
+    }
+    return ops;
+}
+
+/* Divider with a 2 % gaussian supply and 5 % / 1 % resistors */
+static long k_monte_carlo(long ops) {
+    static const mc_param_t parts[3] = {
+        { "V", 5, 2, MC_GAUSSIAN }, { "R1", 10e3, 5, MC_UNIFORM }, { "R2", 4.7e3, 1, MC_GAUSSIAN }
+    };
+    mc_result_t res;
+    if (mc_run("V*R2/(R1+R2)", parts, 3, (uint64_t)ops, 12345, &res) == 0) sink += res.percentile[3];
+    return ops;
+}
+
+static long k_color_decode(long ops) {
+    static const char *const codes[][4] = {
+        {"red", "violet", "yellow", "gold"}, {"brown", "black", "red", "silver"},
+        {"Yellow", "Violet", "Brown", "Gold"}, {"orange", "white", "green", "brown"}
+    };
+    double ohms, tol;
+    for (long i = 0; i < ops; i++) {
+        color_decode(codes[i & 3], 4, &ohms, &tol);
+        sink += ohms;
+    }
+    return ops;
+}
+
+static long k_color_encode(long ops) {
+    const char *bands[4];
+    for (long i = 0; i < ops; i++) {
+        color_encode(array_a[i % ARRAY_N], bands);
+        sink += bands[0][0];
+    }
+    return ops;
+}
+
+static unsigned char band_buf[ARRAY_N * 5];
+
+static long k_color_encode_array(long ops) {
+    for (long i = 0; i < ops; i += ARRAY_N) sink += color_encode_array(array_a, ARRAY_N, 5, band_buf);
+    return (ops + ARRAY_N - 1) / ARRAY_N * ARRAY_N;
+}
+
+static long k_color_decode_array(long ops) {
+    color_encode_array(array_a, ARRAY_N, 5, band_buf);
+    for (long i = 0; i < ops; i += ARRAY_N) sink += color_decode_array(band_buf, ARRAY_N, 5, array_out);
+    return (ops + ARRAY_N - 1) / ARRAY_N * ARRAY_N;
+}
+
+static long k_smd_code(long ops) {
+    char code[8];
+    for (long i = 0; i < ops; i++) sink += smd_resistor_code(array_a[i % ARRAY_N], (i & 1) ? SMD_STYLE_EIA96 : SMD_STYLE_4DIGIT, code);
+    return ops;
+}
+
+static long k_bom_decode_line(long ops) {
+    static const char *const lines[] = { "472,R", "\"4R7\",L", "104,C", "49C,Resistor", "1001,R", "225,C" };
+    char out[64];
+    int invalid;
+    for (long i = 0; i < ops; i++) {
+        const char *l = lines[i % 6];
+        sink += bom_decode_line(l, strlen(l), out, sizeof(out), &invalid);
+    }
+    return ops;
+}
+
+static long k_smd_decode(long ops) {
+    static const char *const codes[] = { "472", "1001", "49C", "01A", "103", "4992", "68X", "220" };
+    double ohms = 0;
+    for (long i = 0; i < ops; i++) {
+        const char *c = codes[i & 7];
+        smd_resistor_value(c, strlen(c), &ohms);
+        sink += ohms;
+    }
+    return ops;
+}
+
+static long k_gate_eval(long ops) {
+    int in[3];
+    int acc = 0;
+    for (long i = 0; i < ops; i++) {
+        in[0] = i & 1; in[1] = (i >> 1) & 1; in[2] = (i >> 2) & 1;
+        acc += gate_eval((int)((i >> 3) % 7), in, 3);
+    }
+    sink += acc;
+    return ops;
+}
+
+#define GRID         64
+#define GRID_QUERIES 8
+static res_network_t *grid_net;
+
+/* 64 x 64 mesh of 1 Ω resistors, corner-to-corner and diagonal queries */
+static long k_network_grid(long ops) {
+    if (!grid_net) {
+        int n_e = 2 * GRID * (GRID - 1), e = 0;
+        int *a = malloc(n_e * sizeof(int)), *b = malloc(n_e * sizeof(int));
+        double *r = malloc(n_e * sizeof(double));
+        for (int y = 0; y < GRID; y++)
+            for (int x = 0; x < GRID; x++) {
+                if (x + 1 < GRID) { a[e] = y * GRID + x; b[e] = a[e] + 1; r[e++] = 1.0; }
+                if (y + 1 < GRID) { a[e] = y * GRID + x; b[e] = a[e] + GRID; r[e++] = 1.0; }
+            }
+        grid_net = network_create(GRID * GRID, n_e, a, b, r);
+        free(a); free(b); free(r);
+    }
+
+    int from[GRID_QUERIES], to[GRID_QUERIES];
+    double out[GRID_QUERIES];
+    for (int q = 0; q < GRID_QUERIES; q++) {
+        from[q] = q * (GRID + 1);
+        to[q] = GRID * GRID - 1 - q * (GRID + 1);
+    }
+    for (long i = 0; i < ops; i += GRID_QUERIES) {
+        network_resistance(grid_net, GRID_QUERIES, from, to, out);
+        sink += out[0];
+    }
+    return (ops + GRID_QUERIES - 1) / GRID_QUERIES * GRID_QUERIES;
+}
+
+static long k_eseries_best(long ops) {
+    eseries_combo_t best[10];
+    for (long i = 0; i < ops; i++) {
+        eseries_best(192, array_a[i % ARRAY_N], 3, 10, best);
+        sink += best[0].value;
+    }
+    return ops;
+}
+
+/* 24-input XOR, counted on all threads */
+static long k_truth_table(long ops) {
+    static tt_program_t *xor24;
+    if (!xor24) xor24 = tt_gate_program(4, 24);
+    long rows = 1L << 24;
+    for (long i = 0; i < ops; i += rows) sink += tt_count_ones(xor24, 0);
+    return (ops + rows - 1) / rows * rows;
+}
+
+/* Exact minimization of a fixed 16-variable function */
+static long k_bool_minimize(long ops) {
+    static uint64_t *on;
+    if (!on) {
+        bool_expr_t *e = bool_parse("A B C ^ D E | F G' H | (I ^ J) K L | M N' O P | A' P ^ C' M | B' G (J + O)");
+        on = bool_on_set(e);
+        bool_free(e);
+    }
+    for (long i = 0; i < ops; i++) {
+        bool_cube_t *cubes;
+        sink += bool_minimize(16, on, NULL, BOOL_EXACT, &cubes);
+        free(cubes);
+    }
+    return ops;
+}
+
+/* 16-bit counter plus 16-bit LFSR, 4096 vectors of random inputs */
+static long k_logic_sim(long ops) {
+    static logic_sim_t *sim;
+    if (!sim) {
+        char text[4096];
+        int len = sprintf(text, "INPUT en seed\nOUTPUT q15 r0\nBUF c0 en\nXOR fb r0 r2 r3 r5 seed\n");
+        for (int i = 0; i < 16; i++) {
+            char src[8];
+            sprintf(src, i < 15 ? "r%d" : "fb", i + 1);
+            len += sprintf(text + len, "TFF q%d c%d\nAND c%d c%d q%d\nDFF r%d %s\n",
+                           i, i, i + 1, i, i, i, src);
+        }
+        sim = lsim_parse(text);
+    }
+    if (sim && lsim_run(sim, 4096, (uint64_t)ops, LSIM_RANDOM, 1) == 0)
+        sink += lsim_output_count(sim, 0);
+    return ops;
+}
+
+typedef struct {
+    const char *name;
+    long (*fn)(long ops);       /* returns the operations actually run */
+    long ops;                   /* operations per repetition */
+} kernel_t;
+
+static const kernel_t kernels[] = {
+    {"parse_with_prefix",      k_parse_with_prefix,   2000000},
+    {"parse_prefix_n",         k_parse_prefix_n,      2000000},
+    {"num_parse",              k_num_parse,           5000000},
+    {"num_format",             k_num_format,          5000000},
+    {"print_with_prefix",      k_print_with_prefix,    500000},
+    {"format_with_prefix",     k_format_with_prefix,  1000000},
+    {"evaluate_expression",    k_evaluate_expression,  100000},
+    {"expr_cache/varied",      k_expr_cache_varied,    200000},
+    {"expr_run",               k_expr_run,            2000000},
+    {"expr_eval_batch/row",    k_expr_eval_batch,     4194304},
+    {"expr_eval_batch/shared", k_expr_eval_batch_shared, 4194304},
+    {"expr_jit/batch_row",     k_expr_jit_batch,      4194304},
+    {"expr_jit/shared_row",    k_expr_jit_batch_shared, 4194304},
+    {"expr_jit/scalar",        k_expr_jit_scalar,     4194304},
+    {"expr_eval_grad/3var",    k_expr_eval_grad,      1048576},
+    {"series_total/1024",      k_series_total,          20000},
+    {"parallel_total/1024",    k_parallel_total,        20000},
+    {"sum_array/elem",         k_sum_array,          16777216},
+    {"reciprocal_sum/elem",    k_reciprocal_sum_array, 16777216},
+    {"transient_rlc/sample",   k_transient,          16777216},
+    {"freq_sweep/point",       k_freq_sweep,          4194304},
+    {"monte_carlo/trial",      k_monte_carlo,         2000000},
+    {"bitbuf_xor/byte",        k_bitbuf_xor,         67108864},
+    {"bitbuf_rol/byte",        k_bitbuf_rol,         67108864},
+    {"bitbuf_popcount/byte",   k_bitbuf_popcount,   134217728},
+    {"bitbuf_hamming/byte",    k_bitbuf_hamming,     67108864},
+    {"color_decode",           k_color_decode,        1000000},
+    {"color_encode",           k_color_encode,         500000},
+    {"color_encode_array/elem", k_color_encode_array, 4194304},
+    {"color_decode_array/elem", k_color_decode_array, 4194304},
+    {"smd_decode",             k_smd_decode,          2000000},
+    {"smd_code",               k_smd_code,            2000000},
+    {"bom_decode_line",        k_bom_decode_line,     2000000},
+    {"gate_eval",              k_gate_eval,           5000000},
+    {"truth_table/row",        k_truth_table,       335544320},
+    {"logic_sim/cycle",        k_logic_sim,            100000},
+    {"bool_minimize/16var",    k_bool_minimize,            20},
+    {"eseries_best/E192",      k_eseries_best,            400},
+    {"network_grid/query",     k_network_grid,             32},
+    {NULL, NULL, 0}
+};
+
+/* ────────────────────────────────────────────────
+   RUNNER
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    double ns_per_op;
+    double ops_per_sec;
+    double allocs_per_op;
+    long ops;                       /* completed in the median repetition */
+} result_t;
+
+typedef struct {
+    double ns_per_op;
+    long done;
+} sample_t;
+
+static int cmp_sample(const void *a, const void *b) {
+    double x = ((const sample_t *)a)->ns_per_op, y = ((const sample_t *)b)->ns_per_op;
+    return (x > y) - (x < y);
+}
+
+/* A kernel may stop short of the ops asked for (on a time budget), so
+   every rate uses the count it reports as done */
+static result_t run_kernel(const kernel_t *k, int quick) {
+    long ops = quick ? k->ops / 20 + 1 : k->ops;
+    sample_t t[BENCH_REPS];
+    double total = 0;
+    result_t r;
+
+    k->fn(ops / 10 + 1);                            /* warm-up */
+
+    unsigned long a0 = bench_allocs();
+    for (int rep = 0; rep < BENCH_REPS; rep++) {
+        double t0 = bench_now();
+        long done = k->fn(ops);
+        t[rep].done = done > 0 ? done : 1;
+        t[rep].ns_per_op = (bench_now() - t0) / t[rep].done * 1e9;
+        total += t[rep].done;
+    }
+    unsigned long allocs = bench_allocs() - a0;
+
+    qsort(t, BENCH_REPS, sizeof(sample_t), cmp_sample);
+    r.ns_per_op = t[BENCH_REPS / 2].ns_per_op;
+    r.ops_per_sec = 1e9 / r.ns_per_op;
+    r.allocs_per_op = (double)allocs / total;
+    r.ops = t[BENCH_REPS / 2].done;
+    return r;
+}
+
+/* ns_per_op recorded for 'name' in a previous JSON report, or -1 */
+static double baseline_ns(const char *json, const char *name) {
+    char key[96];
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+    const char *p = json ? strstr(json, key) : NULL;
+    if (!p) return -1;
+    p = strstr(p, "\"ns_per_op\":");
+    return p ? atof(p + 12) : -1;
+}
+
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc(n + 1);
+    if (buf) buf[fread(buf, 1, n, f)] = '\0';
+    fclose(f);
+    return buf;
+}
+
+int main(int argc, char **argv) {
+    const char *json_path = "bench_results.json", *baseline_path = NULL, *filter = NULL;
+    double threshold = 10.0;
+    int quick = 0, regressions = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_path = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline_path = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else if (strcmp(argv[i], "--quick") == 0) quick = 1;
+        else { fprintf(stderr, "usage: %s [--json FILE] [--baseline FILE] [--threshold PCT] [--filter STR] [--quick]\n", argv[0]); return 1; }
+    }
+
+    char *baseline = baseline_path ? read_file(baseline_path) : NULL;
+    if (baseline_path && !baseline) { fprintf(stderr, "cannot read %s\n", baseline_path); return 1; }
+
+    /* Fixed inputs: same values on every run */
+    srand(12345);
+    for (int i = 0; i < ARRAY_N; i++) {
+        array_a[i] = 1.0 + rand() % 100000 / 10.0;
+        array_b[i] = 1.0 + rand() % 100000 / 10.0;
+        array_c[i] = 1.0 + rand() % 100000 / 10.0;
+    }
+    big_array = malloc(BIG_N * sizeof(double));
+    if (!big_array) return 1;
+    for (int i = 0; i < BIG_N; i++) big_array[i] = 1.0 + rand() % 100000 / 10.0;
+
+    const char *names[] = { "V", "R1", "R2" };
+    example_prog = expr_compile(example_expr);
+    for (int i = 0; i < 16; i++)
+        snprintf(varied_expr[i], sizeof varied_expr[i], "((%dk*%d)+(22-%d)/((45k-44k)*(%dm+44k)))",
+                 40 + i, 30 + i, i, 20 + i);
+    vars_prog = expr_compile_vars("V/(R1+R2)*R2", names, 3);
+    shared_prog = expr_compile_vars("(V/(R1+R2)*R2)*(V/(R1+R2)*R2)/4+(V/(R1+R2)*R2)*1k/(2k+2k)", names, 3);
+    if (!example_prog || !vars_prog || !shared_prog) return 1;
+    vars_jit = expr_jit_compile(vars_prog);
+    shared_jit = expr_jit_compile(shared_prog);
+    if (!vars_jit || !shared_jit) return 1;
+
+    FILE *json = fopen(json_path, "w");
+    if (!json) { fprintf(stderr, "cannot write %s\n", json_path); return 1; }
+    fprintf(json, "{\n  \"suite\": \"electronics_calc\",\n  \"reps\": %d,\n  \"results\": [", BENCH_REPS);
+
+    printf("%-24s %12s %14s %12s\n", "kernel", "ns/op", "ops/s", "allocs/op");
+    int first = 1;
+    for (const kernel_t *k = kernels; k->name; k++) {
+        if (filter && !strstr(k->name, filter)) continue;
+        result_t r = run_kernel(k, quick);
+
+        printf("%-24s %12.2f %14.0f %12.3f", k->name, r.ns_per_op, r.ops_per_sec, r.allocs_per_op);
+        double base = baseline_ns(baseline, k->name);
+        if (base > 0) {
+            double change = (r.ns_per_op / base - 1.0) * 100.0;
+            printf("  %+6.1f%%", change);
+            if (change > threshold) { printf("  REGRESSION"); regressions++; }
+        }
+        printf("\n");
+
+        fprintf(json, "%s\n    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f, "
+                      "\"allocs_per_op\": %.4f, \"ops\": %ld}",
+                first ? "" : ",", k->name, r.ns_per_op, r.ops_per_sec, r.allocs_per_op, r.ops);
+        first = 0;
+    }
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    printf("\nresults written to %s\n", json_path);
+
+    expr_free(example_prog);
+    expr_jit_free(shared_jit);
+    expr_jit_free(vars_jit);
+    expr_free(vars_prog);
+    expr_free(shared_prog);
+    free(big_array);
+    network_free(grid_net);
+    free(baseline);
+    if (regressions) printf("%d kernel(s) regressed by more than %.0f%%\n", regressions, threshold);
+    return regressions ? 2 : 0;
+}
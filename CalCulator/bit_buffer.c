@@ -0,0 +1,444 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bit_buffer.h"
+#include "file_map.h"
+#include "parallel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITBUF_X86 1
+#endif
+
+#define BLOCK    (256u << 10)         /* bytes per task, stays in L2 */
+#define PAR_MIN  (1u << 20)           /* below this one thread is faster */
+#define WINDOW   ((size_t)64 << 20)   /* output bytes buffered per write */
+
+typedef unsigned char u8;
+
+static inline uint64_t load_be64(const u8 *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline void store_be64(u8 *p, uint64_t v) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    memcpy(p, &v, 8);
+}
+
+/* ────────────────────────────────────────────────
+   KERNELS
+   logic:  d = a op b
+   run:    d[j] = s[j] << r | s[j+1] >> (8-r), r in 0..8,
+           so s[len] must be readable
+   pop:    set bits of a, or of a ^ b
+   ──────────────────────────────────────────────── */
+
+static void logic_scalar(int op, const u8 *a, const u8 *b, u8 *d, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x, y = 0;
+        memcpy(&x, a + i, 8);
+        if (op != BITBUF_NOT) memcpy(&y, b + i, 8);
+        switch (op) {
+            case BITBUF_AND: x &= y; break;
+            case BITBUF_OR:  x |= y; break;
+            case BITBUF_XOR: x ^= y; break;
+            default:         x = ~x; break;
+        }
+        memcpy(d + i, &x, 8);
+    }
+    for (; i < n; i++) {
+        switch (op) {
+            case BITBUF_AND: d[i] = a[i] & b[i]; break;
+            case BITBUF_OR:  d[i] = a[i] | b[i]; break;
+            case BITBUF_XOR: d[i] = a[i] ^ b[i]; break;
+            default:         d[i] = (u8)~a[i]; break;
+        }
+    }
+}
+
+static void run_scalar(const u8 *s, u8 *d, size_t len, int r) {
+    size_t j = 0;
+    for (; j + 8 <= len; j += 8)
+        store_be64(d + j, load_be64(s + j) << r | (uint64_t)(s[j + 8] >> (8 - r)));
+    for (; j < len; j++)
+        d[j] = (u8)(s[j] << r | s[j + 1] >> (8 - r));
+}
+
+static inline __attribute__((always_inline))
+uint64_t pop_words(const u8 *a, const u8 *b, size_t n) {
+    uint64_t count = 0;
+    size_t i = 0;
+    uint64_t x, y;
+    if (b) {
+        for (; i + 8 <= n; i += 8) {
+            memcpy(&x, a + i, 8);
+            memcpy(&y, b + i, 8);
+            count += (uint64_t)__builtin_popcountll(x ^ y);
+        }
+        for (; i < n; i++) count += (uint64_t)__builtin_popcount(a[i] ^ b[i]);
+    } else {
+        for (; i + 8 <= n; i += 8) {
+            memcpy(&x, a + i, 8);
+            count += (uint64_t)__builtin_popcountll(x);
+        }
+        for (; i < n; i++) count += (uint64_t)__builtin_popcount(a[i]);
+    }
+    return count;
+}
+
+static uint64_t pop_scalar(const u8 *a, const u8 *b, size_t n) {
+    return pop_words(a, b, n);
+}
+
+#ifdef BITBUF_X86
+
+__attribute__((target("popcnt")))
+static uint64_t pop_popcnt(const u8 *a, const u8 *b, size_t n) {
+    return pop_words(a, b, n);
+}
+
+#define AVX_LOOP(EXPR) do {                                             \
+        for (; i + 32 <= n; i += 32) {                                  \
+            __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));   \
+            __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));   \
+            _mm256_storeu_si256((__m256i *)(d + i), EXPR);              \
+        }                                                               \
+    } while (0)
+
+__attribute__((target("avx2")))
+static void logic_avx2(int op, const u8 *a, const u8 *b, u8 *d, size_t n) {
+    size_t i = 0;
+    switch (op) {
+        case BITBUF_AND: AVX_LOOP(_mm256_and_si256(x, y)); break;
+        case BITBUF_OR:  AVX_LOOP(_mm256_or_si256(x, y)); break;
+        case BITBUF_XOR: AVX_LOOP(_mm256_xor_si256(x, y)); break;
+        default: {
+            const __m256i ones = _mm256_set1_epi8(-1);
+            for (; i + 32 <= n; i += 32) {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+                _mm256_storeu_si256((__m256i *)(d + i), _mm256_xor_si256(x, ones));
+            }
+            break;
+        }
+    }
+    logic_scalar(op, a + i, op == BITBUF_NOT ? NULL : b + i, d + i, n - i);
+}
+
+/* 16-bit lane shifts plus a byte mask give a per-byte shift */
+__attribute__((target("avx2")))
+static void run_avx2(const u8 *s, u8 *d, size_t len, int r) {
+    const __m128i cl = _mm_cvtsi32_si128(r), cr = _mm_cvtsi32_si128(8 - r);
+    const __m256i ml = _mm256_set1_epi8((char)(0xFF << r));
+    const __m256i mr = _mm256_set1_epi8((char)(0xFF >> (8 - r)));
+    size_t j = 0;
+    for (; j + 32 <= len; j += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(s + j));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(s + j + 1));
+        __m256i hi = _mm256_and_si256(_mm256_sll_epi16(x, cl), ml);
+        __m256i lo = _mm256_and_si256(_mm256_srl_epi16(y, cr), mr);
+        _mm256_storeu_si256((__m256i *)(d + j), _mm256_or_si256(hi, lo));
+    }
+    run_scalar(s + j, d + j, len - j, r);
+}
+
+/* Nibble lookup popcount (Mula): byte counts pile up for at most 8
+   vectors, then vpsadbw folds them into four 64-bit sums */
+__attribute__((target("avx2,popcnt")))
+static uint64_t pop_avx2(const u8 *a, const u8 *b, size_t n) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F), zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    size_t i = 0;
+
+    while (i + 32 <= n) {
+        __m256i cnt = zero;
+        for (int k = 0; k < 8 && i + 32 <= n; k++, i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(a + i));
+            if (b) v = _mm256_xor_si256(v, _mm256_loadu_si256((const __m256i *)(b + i)));
+            __m256i lo = _mm256_and_si256(v, low);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+            cnt = _mm256_add_epi8(cnt, _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo),
+                                                       _mm256_shuffle_epi8(lut, hi)));
+        }
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, zero));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + pop_words(a + i, b ? b + i : NULL, n - i);
+}
+
+#endif
+
+typedef void (*logic_fn)(int op, const u8 *a, const u8 *b, u8 *d, size_t n);
+typedef void (*run_fn)(const u8 *s, u8 *d, size_t len, int r);
+typedef uint64_t (*pop_fn)(const u8 *a, const u8 *b, size_t n);
+
+static logic_fn pick_logic_fn(void) {
+#ifdef BITBUF_X86
+    if (__builtin_cpu_supports("avx2")) return logic_avx2;
+#endif
+    return logic_scalar;
+}
+
+static run_fn pick_run_fn(void) {
+#ifdef BITBUF_X86
+    if (__builtin_cpu_supports("avx2")) return run_avx2;
+#endif
+    return run_scalar;
+}
+
+static pop_fn pick_pop_fn(void) {
+#ifdef BITBUF_X86
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return pop_avx2;
+    if (__builtin_cpu_supports("popcnt")) return pop_popcnt;
+#endif
+    return pop_scalar;
+}
+
+/* ────────────────────────────────────────────────
+   RANGES
+   Every output byte depends only on its index, so any
+   range of the output can be produced on its own.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    int op;                     /* BITBUF_*, with ROR turned into ROL */
+    const u8 *a, *b;
+    size_t n;
+    size_t q;                   /* shifts: whole bytes (n = everything) */
+    int r;                      /* shifts: remaining bits, 0..7 */
+    logic_fn logic;
+    run_fn run;
+    pop_fn pop;
+    u8 *dst;                    /* output byte j goes to dst[j - base] */
+    size_t base, lo, hi;        /* range [lo, hi) of output / input */
+    uint64_t *parts;            /* counts per block */
+} bitbuf_job_t;
+
+/* Narrow [*s, *e) to [lo, hi); nonzero if anything is left */
+static int clip(size_t lo, size_t hi, size_t *s, size_t *e) {
+    if (*s < lo) *s = lo;
+    if (*e > hi) *e = hi;
+    return *s < *e;
+}
+
+/* Left shift / rotate: out[j] = bit string from byte j + q, shifted by r */
+static void shl_range(const bitbuf_job_t *j, size_t lo, size_t hi, u8 *out) {
+    const u8 *a = j->a;
+    size_t n = j->n, q = j->q, s, e;
+    int r = j->r, rot = j->op == BITBUF_ROL;
+    if (q >= n) { memset(out, 0, hi - lo); return; }
+
+    s = 0, e = n - q - 1;
+    if (clip(lo, hi, &s, &e)) j->run(a + s + q, out + (s - lo), e - s, r);
+    s = n - q - 1, e = n - q;
+    if (clip(lo, hi, &s, &e)) out[s - lo] = (u8)(a[n - 1] << r | (rot ? a[0] >> (8 - r) : 0));
+    s = n - q, e = n;
+    if (clip(lo, hi, &s, &e)) {
+        if (rot) j->run(a + s + q - n, out + (s - lo), e - s, r);
+        else memset(out + (s - lo), 0, e - s);
+    }
+}
+
+/* Right shift: out[j] = a[j-q-1] << (8-r) | a[j-q] >> r, zeros before */
+static void shr_range(const bitbuf_job_t *j, size_t lo, size_t hi, u8 *out) {
+    const u8 *a = j->a;
+    size_t n = j->n, q = j->q, s, e;
+    if (q >= n) { memset(out, 0, hi - lo); return; }
+
+    s = 0, e = q;
+    if (clip(lo, hi, &s, &e)) memset(out + (s - lo), 0, e - s);
+    s = q, e = q + 1;
+    if (clip(lo, hi, &s, &e)) out[s - lo] = (u8)(a[0] >> j->r);
+    s = q + 1, e = n;
+    if (clip(lo, hi, &s, &e)) j->run(a + s - q - 1, out + (s - lo), e - s, 8 - j->r);
+}
+
+static void op_range(const bitbuf_job_t *j, size_t lo, size_t hi) {
+    u8 *out = j->dst + (lo - j->base);
+    switch (j->op) {
+        case BITBUF_SHL: case BITBUF_ROL: shl_range(j, lo, hi, out); break;
+        case BITBUF_SHR: shr_range(j, lo, hi, out); break;
+        default: j->logic(j->op, j->a + lo, j->b ? j->b + lo : NULL, out, hi - lo);
+    }
+}
+
+static void op_task(void *ctx, int task) {
+    bitbuf_job_t *j = ctx;
+    size_t lo = j->lo + (size_t)task * BLOCK;
+    op_range(j, lo, j->hi - lo < BLOCK ? j->hi : lo + BLOCK);
+}
+
+static void pop_task(void *ctx, int task) {
+    bitbuf_job_t *j = ctx;
+    size_t lo = j->lo + (size_t)task * BLOCK;
+    size_t len = j->hi - lo < BLOCK ? j->hi - lo : BLOCK;
+    j->parts[task] = j->pop(j->a + lo, j->b ? j->b + lo : NULL, len);
+}
+
+static int n_blocks(const bitbuf_job_t *j) {
+    return (int)((j->hi - j->lo + BLOCK - 1) / BLOCK);
+}
+
+/* Output bytes [j->lo, j->hi) into j->dst */
+static void run_ops(bitbuf_job_t *j) {
+    int n_tasks = n_blocks(j);
+    if (j->hi - j->lo >= PAR_MIN)
+        par_for(n_tasks, op_task, j);
+    else
+        for (int t = 0; t < n_tasks; t++) op_task(j, t);
+}
+
+static void job_init(bitbuf_job_t *j, int op, const u8 *a, const u8 *b, size_t n, uint64_t k) {
+    memset(j, 0, sizeof *j);
+    j->a = a, j->b = b, j->n = n, j->hi = n;
+    j->logic = pick_logic_fn();
+    j->run = pick_run_fn();
+    j->pop = pick_pop_fn();
+
+    uint64_t bits = (uint64_t)n * 8;
+    if (op == BITBUF_ROL || op == BITBUF_ROR) {
+        k = bits ? k % bits : 0;
+        if (op == BITBUF_ROR && k) k = bits - k;
+        op = BITBUF_ROL;
+    } else if ((op == BITBUF_SHL || op == BITBUF_SHR) && k >= bits) {
+        k = bits;               /* everything shifted out */
+    }
+    j->op = op;
+    j->q = (size_t)(k / 8);
+    j->r = (int)(k % 8);
+}
+
+/* ────────────────────────────────────────────────
+   BUFFERS
+   ──────────────────────────────────────────────── */
+
+void bitbuf_op(int op, const unsigned char *a, const unsigned char *b, unsigned char *dst, size_t n, uint64_t k) {
+    bitbuf_job_t j;
+    if (n == 0) return;
+    job_init(&j, op, a, b, n, k);
+    j.dst = dst;
+    run_ops(&j);
+}
+
+static uint64_t count_bits(const u8 *a, const u8 *b, size_t n) {
+    bitbuf_job_t j;
+    if (n == 0) return 0;
+    job_init(&j, BITBUF_XOR, a, b, n, 0);
+
+    int blocks = n_blocks(&j);
+    uint64_t local[64];
+    j.parts = blocks <= 64 ? local : malloc(blocks * sizeof(uint64_t));
+    if (!j.parts) return j.pop(a, b, n);    /* out of memory: one pass */
+
+    if (n >= PAR_MIN)
+        par_for(blocks, pop_task, &j);
+    else
+        for (int t = 0; t < blocks; t++) pop_task(&j, t);
+
+    uint64_t total = 0;
+    for (int t = 0; t < blocks; t++) total += j.parts[t];
+    if (j.parts != local) free(j.parts);
+    return total;
+}
+
+uint64_t bitbuf_popcount(const unsigned char *a, size_t n) {
+    return count_bits(a, NULL, n);
+}
+
+uint64_t bitbuf_hamming(const unsigned char *a, const unsigned char *b, size_t n) {
+    return count_bits(a, b, n);
+}
+
+/* ────────────────────────────────────────────────
+   FILES
+   ──────────────────────────────────────────────── */
+
+static int needs_b(int op) {
+    return op == BITBUF_AND || op == BITBUF_OR || op == BITBUF_XOR;
+}
+
+/* Map a_path and, if given, b_path; sizes must agree */
+static int map_operands(const char *a_path, const char *b_path, file_map_t *a, file_map_t *b) {
+    memset(b, 0, sizeof *b);
+    int rc = file_map(a_path, a);
+    if (rc) { printf("Error: cannot read %s (%s)\n", a_path, file_map_error(rc)); return 1; }
+    if (!b_path) return 0;
+    if ((rc = file_map(b_path, b)) != 0) {
+        printf("Error: cannot read %s (%s)\n", b_path, file_map_error(rc));
+        file_unmap(a);
+        return 1;
+    }
+    if (a->size != b->size) {
+        printf("Error: %s is %zu bytes but %s is %zu bytes\n", a_path, a->size, b_path, b->size);
+        file_unmap(a);
+        file_unmap(b);
+        return 1;
+    }
+    return 0;
+}
+
+int bitbuf_file(int op, const char *a_path, const char *b_path, const char *out_path, uint64_t k, uint64_t *bytes) {
+    if (op < BITBUF_AND || op > BITBUF_ROR) { printf("Error: unknown operation\n"); return 1; }
+    if (needs_b(op) && !b_path) { printf("Error: this operation needs two files\n"); return 1; }
+    if (!needs_b(op)) b_path = NULL;
+
+    file_map_t a, b;
+    if (map_operands(a_path, b_path, &a, &b)) return 1;
+    FILE *out = strcmp(out_path, "-") == 0 ? stdout : fopen(out_path, "wb");
+    if (!out) {
+        printf("Error: cannot create %s\n", out_path);
+        file_unmap(&a);
+        file_unmap(&b);
+        return 1;
+    }
+
+    size_t n = a.size;
+    *bytes = n;
+    u8 *buf = n ? malloc(n < WINDOW ? n : WINDOW) : NULL;
+    int rc = 0;
+    if (n && !buf) { printf("Error: out of memory\n"); rc = 1; }
+
+    bitbuf_job_t j;
+    job_init(&j, op, (const u8 *)a.data, (const u8 *)b.data, n, k);
+    j.dst = buf;
+    for (size_t pos = 0; !rc && pos < n; pos = j.hi) {
+        j.base = j.lo = pos;
+        j.hi = n - pos < WINDOW ? n : pos + WINDOW;
+        run_ops(&j);
+        if (fwrite(buf, 1, j.hi - pos, out) != j.hi - pos) {
+            printf("Error: writing %s failed\n", out_path);
+            rc = 1;
+        }
+    }
+
+    free(buf);
+    file_unmap(&a);
+    file_unmap(&b);
+    if (out != stdout) {
+        if (fclose(out) != 0 && !rc) { printf("Error: writing %s failed\n", out_path); rc = 1; }
+    } else {
+        fflush(out);
+    }
+    return rc;
+}
+
+int bitbuf_count_file(const char *a_path, const char *b_path, uint64_t *bits, uint64_t *bytes) {
+    file_map_t a, b;
+    if (map_operands(a_path, b_path, &a, &b)) return 1;
+    *bits = count_bits((const u8 *)a.data, (const u8 *)b.data, a.size);
+    *bytes = a.size;
+    file_unmap(&a);
+    file_unmap(&b);
+    return 0;
+}
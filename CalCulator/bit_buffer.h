@@ -0,0 +1,44 @@
+#ifndef BIT_BUFFER_H
+#define BIT_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Bitwise operations over whole buffers and files (firmware images,
+   bitmaps, masks).
+
+   For shifts and rotates the buffer is one long bit string: byte 0 first,
+   most significant bit first, so a left shift moves bits towards byte 0,
+   exactly like shifting a big-endian number n bytes wide. Shifts fill
+   with zeros; rotates wrap around the whole buffer.
+
+   Large buffers are cut into fixed blocks and run on the worker pool,
+   using AVX2 when the CPU has it; results never depend on either. */
+
+#define BITBUF_AND 0
+#define BITBUF_OR  1
+#define BITBUF_XOR 2
+#define BITBUF_NOT 3            /* b unused */
+#define BITBUF_SHL 4            /* shifts and rotates by k bits, b unused */
+#define BITBUF_SHR 5
+#define BITBUF_ROL 6
+#define BITBUF_ROR 7
+
+/* dst[0..n) = a op b. dst may be a or b for AND/OR/XOR/NOT, but must not
+   overlap a for shifts and rotates. */
+void bitbuf_op(int op, const unsigned char *a, const unsigned char *b, unsigned char *dst, size_t n, uint64_t k);
+
+uint64_t bitbuf_popcount(const unsigned char *a, size_t n);                         /* set bits */
+uint64_t bitbuf_hamming(const unsigned char *a, const unsigned char *b, size_t n);  /* differing bits */
+
+/* out_path = a_path op b_path (b_path NULL for NOT and shifts). Both
+   operands must be the same size; the output has that size too, stored
+   in *bytes ("-" = stdin/stdout). Returns 0 on success. */
+int bitbuf_file(int op, const char *a_path, const char *b_path, const char *out_path, uint64_t k, uint64_t *bytes);
+
+/* Set bits of a_path, or with b_path the Hamming distance between two
+   files of the same size. *bytes gets the size compared. Returns 0 on
+   success. */
+int bitbuf_count_file(const char *a_path, const char *b_path, uint64_t *bits, uint64_t *bytes);
+
+#endif
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "math_ops.h"
+#include "parallel.h"
+#include "file_map.h"
+#include "resistor_calc.h"
+#include "capacitor_calc.h"
+#include "inductor_calc.h"
+#include "bom_decode.h"
+
+#define BOM_WINDOW (64u << 20)          /* bytes of input decoded per round */
+
+/* ────────────────────────────────────────────────
+   ONE LINE
+   Fields are decoded in place; only the output is
+   written.
+   ──────────────────────────────────────────────── */
+
+/* Strip spaces and one pair of surrounding quotes */
+static void trim_field(const char **s, size_t *len) {
+    const char *p = *s, *e = *s + *len;
+    while (p < e && (*p == ' ' || *p == '\t')) p++;
+    while (e > p && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) e--;
+    if (e - p >= 2 && *p == '"' && e[-1] == '"') { p++; e--; }
+    *s = p;
+    *len = (size_t)(e - p);
+}
+
+size_t bom_decode_line(const char *line, size_t len, char *out, size_t cap, int *invalid) {
+    *invalid = 0;
+    trim_field(&line, &len);
+    if (len == 0 || line[0] == '#' || cap < len + BOM_LINE_EXTRA) {
+        if (cap) out[0] = '\0';
+        return 0;
+    }
+
+    const char *comma = memchr(line, ',', len);
+    const char *code = line, *type = comma ? comma + 1 : line + len;
+    size_t code_len = comma ? (size_t)(comma - line) : len;
+    size_t type_len = (size_t)(line + len - type);
+    trim_field(&code, &code_len);
+    trim_field(&type, &type_len);
+
+    size_t n = 0;
+    memcpy(out, code, code_len);
+    n += code_len;
+    out[n++] = ',';
+
+    if (type_len == 4 && strncasecmp(type, "type", 4) == 0) {       /* header */
+        memcpy(out + n, "type,value", 10);
+        n += 10;
+        out[n] = '\0';
+        return n;
+    }
+
+    char kind = type_len ? (char)toupper((unsigned char)type[0]) : '?';
+    double value = 0;
+    int ok;
+    switch (kind) {
+        case 'R': ok = smd_resistor_value(code, code_len, &value) != SMD_INVALID; break;
+        case 'C': ok = smd_capacitor_value(code, code_len, &value); break;
+        case 'L': ok = smd_inductor_value(code, code_len, &value); break;
+        default:  ok = 0; kind = '?';
+    }
+    out[n++] = kind;
+    out[n++] = ',';
+
+    if (ok) {
+        n += format_shortest(out + n, cap - n, value);
+    } else {
+        memcpy(out + n, "error", 6);
+        n += 5;
+        *invalid = 1;
+    }
+    return n;
+}
+
+/* ────────────────────────────────────────────────
+   DRIVER
+   The file is mapped once and walked in BOM_WINDOW
+   pieces cut at line boundaries. Each piece is split
+   across the worker pool, and the per-task outputs
+   are written in task order.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    file_out_t out;
+    size_t lines, invalid;
+} bom_out_t;
+
+typedef struct {
+    const char *data;
+    size_t size;
+    int n_tasks;
+    bom_out_t *outs;
+} bom_chunk_t;
+
+static void bom_task(void *ctx, int task) {
+    bom_chunk_t *c = ctx;
+    bom_out_t *o = &c->outs[task];
+    size_t begin = file_line_start(c->data, c->size, c->size / c->n_tasks * task);
+    size_t stop = task == c->n_tasks - 1 ? c->size
+                : file_line_start(c->data, c->size, c->size / c->n_tasks * (task + 1));
+
+    file_out_t *b = &o->out;
+    b->len = 0;
+    while (begin < stop) {
+        const char *nl = memchr(c->data + begin, '\n', stop - begin);
+        size_t len = nl ? (size_t)(nl - (c->data + begin)) : stop - begin;
+        int invalid;
+        if (!file_out_reserve(b, len + BOM_LINE_EXTRA + 1)) return;
+        b->len += bom_decode_line(c->data + begin, len, b->buf + b->len, len + BOM_LINE_EXTRA, &invalid);
+        b->buf[b->len++] = '\n';
+        o->lines++;
+        o->invalid += invalid;
+        begin += len + 1;
+    }
+}
+
+int bom_run(const char *in_path, const char *out_path) {
+    file_map_t in;
+    int rc = file_map(in_path, &in);
+    if (rc) { fprintf(stderr, "Error: cannot read %s (%s)\n", in_path, file_map_error(rc)); return 1; }
+    const char *data = in.data;
+    size_t size = in.size;
+    FILE *out = strcmp(out_path, "-") == 0 ? stdout : fopen(out_path, "wb");
+    if (!out) {
+        fprintf(stderr, "Error: cannot create %s\n", out_path);
+        file_unmap(&in);
+        return 1;
+    }
+
+    /* rc: 1 = out of memory, 2 = writing failed */
+    int n_tasks = par_threads() * 4;
+    bom_out_t *outs = calloc(n_tasks, sizeof(bom_out_t));
+    size_t lines = 0, invalid = 0;
+    if (!outs) rc = 1;
+
+    for (size_t pos = 0; !rc && pos < size; ) {
+        size_t end = pos + BOM_WINDOW < size ? file_line_start(data, size, pos + BOM_WINDOW) : size;
+        bom_chunk_t chunk = { data + pos, end - pos, n_tasks, outs };
+        if (chunk.size < (size_t)n_tasks * 64) chunk.n_tasks = 1;      /* not worth splitting */
+        par_for(chunk.n_tasks, bom_task, &chunk);
+        for (int t = 0; t < chunk.n_tasks; t++)
+            if (outs[t].out.failed) rc = 1;
+        for (int t = 0; !rc && t < chunk.n_tasks; t++)
+            if (fwrite(outs[t].out.buf, 1, outs[t].out.len, out) != outs[t].out.len) rc = 2;
+        pos = end;
+    }
+
+    if (outs)
+        for (int t = 0; t < n_tasks; t++) {
+            lines += outs[t].lines;
+            invalid += outs[t].invalid;
+            free(outs[t].out.buf);
+        }
+    free(outs);
+    file_unmap(&in);
+    if (out != stdout) { if (fclose(out) != 0 && !rc) rc = 2; }
+    else if (fflush(out) != 0 && !rc) rc = 2;
+
+    if (rc == 1) fprintf(stderr, "Error: out of memory\n");
+    else if (rc == 2) fprintf(stderr, "Error: writing %s failed\n", out_path);
+    else fprintf(stderr, "%zu lines decoded, %zu invalid markings\n", lines, invalid);
+    return rc != 0;
+}
@@ -0,0 +1,28 @@
+#ifndef BOM_DECODE_H
+#define BOM_DECODE_H
+
+#include <stddef.h>
+
+/* Bill-of-materials marking decoder. Each input line is "code,type" with
+   type R, C or L (or any word starting with one, e.g. "Resistor"); fields
+   may be quoted or padded with spaces:
+       472,R
+       "4R7",L
+       104,C
+   Each line produces "code,type,value" with the value in ohms, farads or
+   henries (shortest round-trip digits), or "code,type,error" when the
+   marking is invalid. A "code,type" header line is passed through with a
+   value column added; blank and '#' lines stay empty. */
+
+/* Decode one line (no newline needed) into out; returns the length
+   written, or 0 for an empty output line. cap must be at least
+   len + BOM_LINE_EXTRA. Thread-safe. */
+#define BOM_LINE_EXTRA 40
+size_t bom_decode_line(const char *line, size_t len, char *out, size_t cap, int *invalid);
+
+/* Memory-map in_path and decode it on the worker pool into out_path ("-"
+   for stdout), keeping input order. Returns 0 on success, or 1 after
+   telling stderr why (unreadable input, out of memory, a failed write). */
+int bom_run(const char *in_path, const char *out_path);
+
+#endif
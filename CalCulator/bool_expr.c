@@ -0,0 +1,776 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <strings.h>
+#include <stdatomic.h>
+#include "parallel.h"
+#include "bool_expr.h"
+
+/* ────────────────────────────────────────────────
+   PARSER
+   Pass 1 collects the variable names so that they
+   can be numbered alphabetically; pass 2 compiles
+   the expression to a truth-table program.
+   ──────────────────────────────────────────────── */
+
+static const char *const gate_names[] = { "AND", "OR", "NAND", "NOR", "XOR", "XNOR", "NOT" };
+
+typedef struct {
+    const char *s;
+    size_t pos;
+    bool_expr_t *e;
+    int failed;
+} parser_t;
+
+static void fail(parser_t *p, const char *msg) {
+    if (!p->failed) printf("Error: %s at position %zu\n", msg, p->pos + 1);
+    p->failed = 1;
+}
+
+static void skip_ws(parser_t *p) {
+    while (isspace((unsigned char)p->s[p->pos])) p->pos++;
+}
+
+static int is_name_start(char c) { return isalpha((unsigned char)c) || c == '_'; }
+static int is_name_char(char c)  { return isalnum((unsigned char)c) || c == '_'; }
+
+/* Gate number if s[0..len) names a gate and is followed by '(' */
+static int gate_call(const char *s, size_t len, const char *after) {
+    while (isspace((unsigned char)*after)) after++;
+    if (*after != '(') return -1;
+    for (int g = 0; g < 7; g++)
+        if (strlen(gate_names[g]) == len && strncasecmp(s, gate_names[g], len) == 0) return g;
+    return -1;
+}
+
+static int cmp_name(const void *a, const void *b) {
+    return strcmp((const char *)a, (const char *)b);
+}
+
+static int collect_names(bool_expr_t *e, const char *s) {
+    for (size_t i = 0; s[i]; ) {
+        if (!is_name_start(s[i])) { i++; continue; }
+        size_t start = i;
+        while (is_name_char(s[i])) i++;
+        size_t len = i - start;
+        if (gate_call(s + start, len, s + i) >= 0) continue;
+        if (len >= BOOL_NAME_LEN) { printf("Error: variable name too long\n"); return 0; }
+
+        int known = 0;
+        for (int v = 0; v < e->n_vars && !known; v++)
+            known = strlen(e->names[v]) == len && strncmp(e->names[v], s + start, len) == 0;
+        if (known) continue;
+        if (e->n_vars == TT_MAX_INPUTS) { printf("Error: more than %d variables\n", TT_MAX_INPUTS); return 0; }
+        memcpy(e->names[e->n_vars], s + start, len);
+        e->names[e->n_vars++][len] = '\0';
+    }
+    qsort(e->names, e->n_vars, BOOL_NAME_LEN, cmp_name);
+    return 1;
+}
+
+static int parse_or(parser_t *p);
+
+static int emit(parser_t *p, int op, int a, int b) {
+    if (p->failed) return -1;
+    int s = tt_emit(p->e->prog, op, a, b);
+    if (s < 0) fail(p, "expression too large");
+    return s;
+}
+
+/* Gate over already-parsed arguments, same semantics as gate_eval() */
+static int emit_gate(parser_t *p, int gate, const int *args, int n) {
+    static const int chain_op[6] = { TT_AND, TT_OR, TT_AND, TT_OR, TT_XOR, TT_XOR };
+    if (gate == 6) return n == 1 ? emit(p, TT_NOT, args[0], 0) : (fail(p, "NOT takes one argument"), -1);
+    int s = args[0];
+    for (int i = 1; i < n; i++) s = emit(p, chain_op[gate], s, args[i]);
+    if (gate == 2 || gate == 3 || gate == 5) s = emit(p, TT_NOT, s, 0);
+    return s;
+}
+
+static int parse_primary(parser_t *p) {
+    skip_ws(p);
+    const char *s = p->s;
+    char c = s[p->pos];
+
+    if (c == '(') {
+        p->pos++;
+        int v = parse_or(p);
+        skip_ws(p);
+        if (s[p->pos] != ')') { fail(p, "missing ')'"); return -1; }
+        p->pos++;
+        return v;
+    }
+    if (c == '0' || c == '1') {
+        p->pos++;
+        return emit(p, c == '1' ? TT_CONST1 : TT_CONST0, 0, 0);
+    }
+    if (!is_name_start(c)) { fail(p, c ? "unexpected character" : "unexpected end of expression"); return -1; }
+
+    size_t start = p->pos;
+    while (is_name_char(s[p->pos])) p->pos++;
+    size_t len = p->pos - start;
+    int gate = gate_call(s + start, len, s + p->pos);
+
+    if (gate < 0) {
+        for (int v = 0; v < p->e->n_vars; v++)
+            if (strlen(p->e->names[v]) == len && strncmp(p->e->names[v], s + start, len) == 0) return v;
+        fail(p, "unknown variable");
+        return -1;
+    }
+
+    int args[64], n = 0;
+    skip_ws(p);
+    p->pos++;                                   /* '(' */
+    for (;;) {
+        if (n == 64) { fail(p, "too many gate arguments"); return -1; }
+        args[n++] = parse_or(p);
+        if (p->failed) return -1;
+        skip_ws(p);
+        if (s[p->pos] == ',') { p->pos++; continue; }
+        if (s[p->pos] == ')') { p->pos++; break; }
+        fail(p, "expected ',' or ')'");
+        return -1;
+    }
+    return emit_gate(p, gate, args, n);
+}
+
+static int parse_unary(parser_t *p) {
+    skip_ws(p);
+    char c = p->s[p->pos];
+    if (c == '!' || c == '~') {
+        p->pos++;
+        int v = parse_unary(p);
+        return emit(p, TT_NOT, v, 0);
+    }
+    int v = parse_primary(p);
+    skip_ws(p);
+    while (!p->failed && p->s[p->pos] == '\'') {
+        p->pos++;
+        v = emit(p, TT_NOT, v, 0);
+        skip_ws(p);
+    }
+    return v;
+}
+
+static int parse_and(parser_t *p) {
+    int v = parse_unary(p);
+    while (!p->failed) {
+        skip_ws(p);
+        char c = p->s[p->pos];
+        if (c == '&' || c == '*' || c == '.') p->pos++;
+        else if (!(is_name_start(c) || c == '(' || c == '!' || c == '~' || c == '0' || c == '1')) break;
+        v = emit(p, TT_AND, v, parse_unary(p));     /* explicit or implicit AND */
+    }
+    return v;
+}
+
+static int parse_xor(parser_t *p) {
+    int v = parse_and(p);
+    while (!p->failed) {
+        skip_ws(p);
+        if (p->s[p->pos] != '^') break;
+        p->pos++;
+        v = emit(p, TT_XOR, v, parse_and(p));
+    }
+    return v;
+}
+
+static int parse_or(parser_t *p) {
+    int v = parse_xor(p);
+    while (!p->failed) {
+        skip_ws(p);
+        char c = p->s[p->pos];
+        if (c != '|' && c != '+') break;
+        p->pos++;
+        v = emit(p, TT_OR, v, parse_xor(p));
+    }
+    return v;
+}
+
+bool_expr_t *bool_parse(const char *text) {
+    bool_expr_t *e = calloc(1, sizeof(*e));
+    if (!e) return NULL;
+    if (!collect_names(e, text)) { free(e); return NULL; }
+
+    /* A constant expression still gets one (unused) input */
+    e->prog = tt_program_new(e->n_vars ? e->n_vars : 1);
+    if (!e->prog) { free(e); return NULL; }
+
+    parser_t p = { text, 0, e, 0 };
+    int out = parse_or(&p);
+    skip_ws(&p);
+    if (!p.failed && text[p.pos] != '\0') fail(&p, "unexpected character");
+    if (p.failed || tt_add_output(e->prog, out)) { bool_free(e); return NULL; }
+    return e;
+}
+
+void bool_free(bool_expr_t *e) {
+    if (!e) return;
+    tt_program_free(e->prog);
+    free(e);
+}
+
+uint64_t *bool_on_set(const bool_expr_t *e) {
+    const tt_program_t *prog = e->prog;
+    uint64_t blocks = prog->n_inputs >= 8 ? 1ull << (prog->n_inputs - 8) : 1;
+    uint64_t *bits = malloc(blocks * 4 * sizeof(uint64_t));
+    if (bits) tt_eval_blocks(prog, 0, blocks, bits);
+    return bits;
+}
+
+/* ────────────────────────────────────────────────
+   BITSET HELPERS
+   Functions are bit vectors over 2^n rows; a cube
+   is enumerated by walking the subsets of its
+   free (dashed) bits.
+   ──────────────────────────────────────────────── */
+
+static const uint64_t bit_pattern[6] = {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+};
+
+static size_t n_words(int n) { return n >= 6 ? (size_t)1 << (n - 6) : 1; }
+
+static int test_bit(const uint64_t *s, uint32_t r) { return (s[r >> 6] >> (r & 63)) & 1; }
+
+/* Every row of the cube (value, free bits 'dash') is in s */
+static int cube_inside(const uint64_t *s, uint32_t value, uint32_t dash) {
+    uint32_t sub = 0;
+    do {
+        if (!test_bit(s, value | sub)) return 0;
+        sub = (sub - dash) & dash;
+    } while (sub);
+    return 1;
+}
+
+static int literal_count(const bool_cube_t *c) { return __builtin_popcount(c->mask); }
+
+/* ────────────────────────────────────────────────
+   EXACT: QUINE-McCLUSKEY ON BITSETS
+   S_D holds every implicant whose free bits are D
+   (row numbers with the D bits clear). Merging along
+   variable b is one word-wide AND of S_D with itself
+   shifted by b, so a level is a handful of bitset
+   passes per D. Deeper levels get sparse quickly, so
+   each S_D keeps only its non-zero words. D sets of a
+   level are processed in parallel; each next-level set
+   E is produced only by its canonical parent, E minus
+   its highest bit.
+   ──────────────────────────────────────────────── */
+
+#define EXACT_BUDGET ((size_t)512 << 20)    /* bytes of live bitsets */
+
+typedef struct {
+    size_t n;                   /* non-zero words */
+    uint64_t *bits;
+    uint32_t *idx;              /* their word numbers, ascending */
+} qm_set_t;
+
+static qm_set_t *set_new(size_t n) {
+    qm_set_t *s = malloc(sizeof(*s) + n * (sizeof(uint64_t) + sizeof(uint32_t)));
+    if (!s) return NULL;
+    s->n = n;
+    s->bits = (uint64_t *)(s + 1);
+    s->idx = (uint32_t *)(s->bits + n);
+    return s;
+}
+
+typedef struct {
+    int n;
+    qm_set_t **sets;            /* indexed by D; NULL when empty */
+    const uint32_t *level;      /* D values of this level */
+    uint32_t **children;        /* per task: next-level D values */
+    int *n_children;
+    bool_cube_t **primes;       /* per task */
+    size_t *n_primes;
+    atomic_int failed;          /* set by any worker, read by all */
+} qm_job_t;
+
+static void qm_task(void *ctx, int task) {
+    qm_job_t *job = ctx;
+    int n = job->n;
+    uint32_t D = job->level[task];
+    const qm_set_t *S = job->sets[D];
+    size_t len = S->n;
+    uint64_t *covered = calloc(len, 2 * sizeof(uint64_t) + sizeof(uint32_t));
+    uint64_t *m_bits = covered + len;           /* scratch for one child */
+    uint32_t *m_idx = (uint32_t *)(m_bits + len);
+    uint32_t full = n == 32 ? ~0u : (1u << n) - 1;
+    int top = D ? 31 - __builtin_clz(D) : -1;
+
+    job->children[task] = malloc(n * sizeof(uint32_t));
+    job->n_children[task] = 0;
+    job->primes[task] = NULL;
+    job->n_primes[task] = 0;
+    if (!covered || !job->children[task]) atomic_store_explicit(&job->failed, 1, memory_order_relaxed);
+
+    for (int b = 0; b < n && !atomic_load_explicit(&job->failed, memory_order_relaxed); b++) {
+        if (D >> b & 1) continue;
+        int keep = b > top;
+        size_t k = 0;
+        if (b < 6) {
+            int sh = 1 << b;
+            for (size_t j = 0; j < len; j++) {
+                uint64_t m = S->bits[j] & (S->bits[j] >> sh) & ~bit_pattern[b];
+                if (!m) continue;
+                covered[j] |= m | (m << sh);
+                if (keep) { m_idx[k] = S->idx[j]; m_bits[k++] = m; }
+            }
+        } else {
+            /* partner word idx | s; both walk the sorted list upwards */
+            uint32_t s = 1u << (b - 6);
+            size_t hi = 0;
+            for (size_t j = 0; j < len; j++) {
+                if (S->idx[j] & s) continue;
+                uint32_t want = S->idx[j] | s;
+                while (hi < len && S->idx[hi] < want) hi++;
+                if (hi == len) break;
+                if (S->idx[hi] != want) continue;
+                uint64_t m = S->bits[j] & S->bits[hi];
+                if (!m) continue;
+                covered[j] |= m;
+                covered[hi] |= m;
+                if (keep) { m_idx[k] = S->idx[j]; m_bits[k++] = m; }
+            }
+        }
+        if (!k) continue;
+        qm_set_t *M = set_new(k);
+        if (!M) { atomic_store_explicit(&job->failed, 1, memory_order_relaxed); break; }
+        memcpy(M->bits, m_bits, k * sizeof(uint64_t));
+        memcpy(M->idx, m_idx, k * sizeof(uint32_t));
+        job->sets[D | 1u << b] = M;
+        job->children[task][job->n_children[task]++] = D | 1u << b;
+    }
+
+    /* Implicants that merged nowhere are prime */
+    size_t count = 0, cap = 0;
+    bool_cube_t *primes = NULL;
+    for (size_t j = 0; j < len && !atomic_load_explicit(&job->failed, memory_order_relaxed); j++) {
+        uint64_t bits = S->bits[j] & ~covered[j];
+        while (bits) {
+            if (count == cap) {
+                cap = cap ? cap * 2 : 64;
+                bool_cube_t *bigger = realloc(primes, cap * sizeof(bool_cube_t));
+                if (!bigger) { atomic_store_explicit(&job->failed, 1, memory_order_relaxed); break; }
+                primes = bigger;
+            }
+            primes[count].value = S->idx[j] * 64 + __builtin_ctzll(bits);
+            primes[count].mask = full & ~D;
+            count++;
+            bits &= bits - 1;
+        }
+    }
+    job->primes[task] = primes;
+    job->n_primes[task] = count;
+    free(covered);
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* All prime implicants of on|dc, or -1 if over budget */
+static long qm_primes(int n, const uint64_t *care, bool_cube_t **out) {
+    size_t W = n_words(n);
+    size_t n_sets = (size_t)1 << n;
+    qm_job_t job = { n, calloc(n_sets, sizeof(qm_set_t *)), NULL, NULL, NULL, NULL, NULL, 0 };
+    uint32_t *level = malloc(sizeof(uint32_t)), *next = NULL;
+    int n_level = 0;
+    bool_cube_t *primes = NULL;
+    size_t n_primes = 0, nz = 0;
+    long rc = -1;
+
+    if (!job.sets || !level) goto done;
+    for (size_t w = 0; w < W; w++) nz += care[w] != 0;
+    if (nz) {
+        qm_set_t *S0 = set_new(nz);
+        if (!S0) goto done;
+        for (size_t w = 0, j = 0; w < W; w++)
+            if (care[w]) { S0->idx[j] = (uint32_t)w; S0->bits[j++] = care[w]; }
+        job.sets[0] = S0;
+        level[0] = 0;
+        n_level = 1;
+    }
+
+    for (int k = 0; n_level > 0; k++) {
+        /* A child is never larger than its parent */
+        size_t live = 0;
+        for (int t = 0; t < n_level; t++) live += job.sets[level[t]]->n;
+        if ((double)live * (n - k + 1) * (sizeof(uint64_t) + sizeof(uint32_t)) > EXACT_BUDGET) goto done;
+
+        job.level = level;
+        job.children = calloc(n_level, sizeof(uint32_t *));
+        job.n_children = calloc(n_level, sizeof(int));
+        job.primes = calloc(n_level, sizeof(bool_cube_t *));
+        job.n_primes = calloc(n_level, sizeof(size_t));
+        if (!job.children || !job.n_children || !job.primes || !job.n_primes) job.failed = 1;
+        else par_for(n_level, qm_task, &job);
+
+        int n_next = 0;
+        size_t add = 0;
+        for (int t = 0; !job.failed && t < n_level; t++) {
+            n_next += job.n_children[t];
+            add += job.n_primes[t];
+        }
+        next = job.failed ? NULL : malloc((n_next + 1) * sizeof(uint32_t));
+        bool_cube_t *grown = job.failed ? NULL : realloc(primes, (n_primes + add + 1) * sizeof(bool_cube_t));
+        if (grown) primes = grown;
+        if (!next || !grown) job.failed = 1;
+
+        n_next = 0;
+        for (int t = 0; t < n_level; t++) {
+            if (!job.failed) {
+                memcpy(next + n_next, job.children[t], job.n_children[t] * sizeof(uint32_t));
+                n_next += job.n_children[t];
+                memcpy(primes + n_primes, job.primes[t], job.n_primes[t] * sizeof(bool_cube_t));
+                n_primes += job.n_primes[t];
+            }
+            free(job.sets[level[t]]);
+            job.sets[level[t]] = NULL;
+            if (job.children) free(job.children[t]);
+            if (job.primes) free(job.primes[t]);
+        }
+        free(job.children); free(job.n_children); free(job.primes); free(job.n_primes);
+        free(level);
+        level = next;
+        next = NULL;
+        n_level = n_next;
+        if (job.failed) goto done;
+        qsort(level, n_level, sizeof(uint32_t), cmp_u32);
+    }
+    rc = (long)n_primes;
+    *out = primes;
+    primes = NULL;
+
+done:
+    if (job.sets && rc < 0)
+        for (size_t d = 0; d < n_sets; d++) free(job.sets[d]);
+    free(job.sets);
+    free(level);
+    free(primes);
+    return rc;
+}
+
+/* ────────────────────────────────────────────────
+   COVER
+   Essential primes first, then greedy choice of the
+   prime covering most uncovered on-set rows (ties:
+   fewer literals, then lower index) through a lazy
+   max-heap.
+   ──────────────────────────────────────────────── */
+
+static long cube_gain(const bool_cube_t *c, const uint64_t *need, uint32_t full) {
+    uint32_t dash = full & ~c->mask, sub = 0;
+    long g = 0;
+    do {
+        g += test_bit(need, c->value | sub);
+        sub = (sub - dash) & dash;
+    } while (sub);
+    return g;
+}
+
+static void cube_clear(const bool_cube_t *c, uint64_t *need, uint32_t full) {
+    uint32_t dash = full & ~c->mask, sub = 0;
+    do {
+        uint32_t r = c->value | sub;
+        need[r >> 6] &= ~(1ull << (r & 63));
+        sub = (sub - dash) & dash;
+    } while (sub);
+}
+
+typedef struct {
+    long gain;
+    int idx;
+} heap_item_t;
+
+static int heap_less(const heap_item_t *x, const heap_item_t *y, const bool_cube_t *cubes) {
+    if (x->gain != y->gain) return x->gain < y->gain;
+    int lx = literal_count(&cubes[x->idx]), ly = literal_count(&cubes[y->idx]);
+    if (lx != ly) return lx > ly;
+    return x->idx > y->idx;
+}
+
+static void heap_push(heap_item_t *h, int *n, heap_item_t it, const bool_cube_t *cubes) {
+    int i = (*n)++;
+    while (i > 0 && heap_less(&h[(i - 1) / 2], &it, cubes)) { h[i] = h[(i - 1) / 2]; i = (i - 1) / 2; }
+    h[i] = it;
+}
+
+static heap_item_t heap_pop(heap_item_t *h, int *n, const bool_cube_t *cubes) {
+    heap_item_t top = h[0], last = h[--(*n)];
+    int i = 0;
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= *n) break;
+        if (c + 1 < *n && heap_less(&h[c], &h[c + 1], cubes)) c++;
+        if (!heap_less(&last, &h[c], cubes)) break;
+        h[i] = h[c];
+        i = c;
+    }
+    if (*n > 0) h[i] = last;
+    return top;
+}
+
+static int select_cover(int n, const uint64_t *on, bool_cube_t *primes, int n_primes, bool_cube_t **out) {
+    uint32_t full = n == 32 ? ~0u : (1u << n) - 1;
+    size_t rows = (size_t)1 << n, W = n_words(n);
+    unsigned char *count = calloc(rows, 1);
+    int *owner = malloc(rows * sizeof(int));
+    uint64_t *need = malloc(W * sizeof(uint64_t));
+    char *chosen = calloc(n_primes + 1, 1);
+    heap_item_t *heap = malloc((n_primes + 1) * sizeof(heap_item_t));
+    int n_heap = 0, n_out = 0, rc = -1;
+    bool_cube_t *cover = malloc((n_primes + 1) * sizeof(bool_cube_t));
+
+    if (!count || !owner || !need || !chosen || !heap || !cover) goto done;
+    memcpy(need, on, W * sizeof(uint64_t));
+
+    /* Rows covered by exactly one prime make that prime essential */
+    for (int i = 0; i < n_primes; i++) {
+        uint32_t dash = full & ~primes[i].mask, sub = 0;
+        do {
+            uint32_t r = primes[i].value | sub;
+            if (test_bit(on, r) && count[r] < 2) { count[r]++; owner[r] = i; }
+            sub = (sub - dash) & dash;
+        } while (sub);
+    }
+    for (size_t w = 0; w < W; w++) {
+        uint64_t bits = on[w];
+        while (bits) {
+            size_t r = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (count[r] == 1 && !chosen[owner[r]]) {
+                chosen[owner[r]] = 1;
+                cover[n_out++] = primes[owner[r]];
+                cube_clear(&primes[owner[r]], need, full);
+            }
+        }
+    }
+
+    for (int i = 0; i < n_primes; i++) {
+        if (chosen[i]) continue;
+        heap_item_t it = { cube_gain(&primes[i], need, full), i };
+        if (it.gain > 0) heap_push(heap, &n_heap, it, primes);
+    }
+    while (n_heap > 0) {
+        heap_item_t top = heap_pop(heap, &n_heap, primes);
+        top.gain = cube_gain(&primes[top.idx], need, full);
+        if (top.gain == 0) continue;
+        if (n_heap > 0 && heap_less(&top, &heap[0], primes)) {   /* stale: re-queue */
+            heap_push(heap, &n_heap, top, primes);
+            continue;
+        }
+        cover[n_out++] = primes[top.idx];
+        cube_clear(&primes[top.idx], need, full);
+    }
+    rc = n_out;
+    *out = cover;
+    cover = NULL;
+
+done:
+    free(count); free(owner); free(need); free(chosen); free(heap); free(cover);
+    return rc;
+}
+
+/* ────────────────────────────────────────────────
+   HEURISTIC: ESPRESSO-STYLE EXPAND / IRREDUNDANT
+   The rows are cut into a fixed number of chunks
+   (so the result never depends on the thread count);
+   each chunk grows every on-set row it has not yet
+   covered into a prime by dropping literals while the
+   cube stays inside on|dc. The union is deduplicated
+   and redundant cubes are dropped, most literals first.
+   ──────────────────────────────────────────────── */
+
+#define EXPAND_CHUNKS 64
+
+typedef struct {
+    int n;
+    const uint64_t *on, *care;
+    bool_cube_t **cubes;
+    int *n_cubes;
+    atomic_int failed;
+} expand_job_t;
+
+static void expand_task(void *ctx, int task) {
+    expand_job_t *job = ctx;
+    int n = job->n;
+    uint32_t full = n == 32 ? ~0u : (1u << n) - 1;
+    size_t rows = (size_t)1 << n;
+    size_t begin = rows * task / EXPAND_CHUNKS, end = rows * (task + 1) / EXPAND_CHUNKS;
+    size_t span = end - begin;
+    uint64_t *done = calloc(span / 64 + 1, sizeof(uint64_t));
+    int count = 0, cap = 0;
+    bool_cube_t *cubes = NULL;
+
+    job->n_cubes[task] = 0;
+    job->cubes[task] = NULL;
+    if (!done) { atomic_store_explicit(&job->failed, 1, memory_order_relaxed); return; }
+
+    for (size_t r = begin; r < end; r++) {
+        if (!test_bit(job->on, (uint32_t)r) || test_bit(done, (uint32_t)(r - begin))) continue;
+
+        bool_cube_t c = { (uint32_t)r, full };
+        for (int b = n - 1; b >= 0; b--) {
+            uint32_t bit = 1u << b;
+            /* the other half: same cube with variable b flipped */
+            if (cube_inside(job->care, c.value ^ bit, full & ~c.mask)) {
+                c.mask &= ~bit;
+                c.value &= ~bit;
+            }
+        }
+
+        if (count == cap) {
+            cap = cap ? cap * 2 : 64;
+            bool_cube_t *bigger = realloc(cubes, cap * sizeof(bool_cube_t));
+            if (!bigger) { atomic_store_explicit(&job->failed, 1, memory_order_relaxed); break; }
+            cubes = bigger;
+        }
+        cubes[count++] = c;
+
+        /* mark this chunk's rows the new cube covers */
+        uint32_t dash = full & ~c.mask, sub = 0;
+        do {
+            uint32_t row = c.value | sub;
+            if (row >= begin && row < end) done[(row - begin) >> 6] |= 1ull << ((row - begin) & 63);
+            sub = (sub - dash) & dash;
+        } while (sub);
+    }
+    free(done);
+    job->cubes[task] = cubes;
+    job->n_cubes[task] = count;
+}
+
+static int cmp_cube(const void *a, const void *b) {
+    const bool_cube_t *x = a, *y = b;
+    int lx = literal_count(x), ly = literal_count(y);
+    if (lx != ly) return ly - lx;                       /* most literals first */
+    if (x->mask != y->mask) return x->mask < y->mask ? -1 : 1;
+    return (x->value > y->value) - (x->value < y->value);
+}
+
+static int heuristic_cover(int n, const uint64_t *on, const uint64_t *care, bool_cube_t **out) {
+    uint32_t full = n == 32 ? ~0u : (1u << n) - 1;
+    bool_cube_t *lists[EXPAND_CHUNKS];
+    int counts[EXPAND_CHUNKS];
+    expand_job_t job = { n, on, care, lists, counts, 0 };
+    par_for(EXPAND_CHUNKS, expand_task, &job);
+
+    int total = 0;
+    for (int t = 0; t < EXPAND_CHUNKS; t++) total += counts[t];
+    bool_cube_t *cubes = malloc((total + 1) * sizeof(bool_cube_t));
+    uint32_t *cover_count = calloc((size_t)1 << n, sizeof(uint32_t));
+    int n_cubes = 0, rc = -1;
+
+    for (int t = 0; t < EXPAND_CHUNKS; t++) {
+        if (cubes && lists[t]) memcpy(cubes + n_cubes, lists[t], counts[t] * sizeof(bool_cube_t));
+        n_cubes += counts[t];
+        free(lists[t]);
+    }
+    if (job.failed || !cubes || !cover_count) goto done;
+
+    /* Deduplicate, then drop cubes whose on-set rows are all covered twice */
+    qsort(cubes, n_cubes, sizeof(bool_cube_t), cmp_cube);
+    int u = 0;
+    for (int i = 0; i < n_cubes; i++)
+        if (u == 0 || cubes[i].mask != cubes[u - 1].mask || cubes[i].value != cubes[u - 1].value)
+            cubes[u++] = cubes[i];
+    n_cubes = u;
+
+    for (int i = 0; i < n_cubes; i++) {
+        uint32_t dash = full & ~cubes[i].mask, sub = 0;
+        do {
+            uint32_t r = cubes[i].value | sub;
+            if (test_bit(on, r)) cover_count[r]++;
+            sub = (sub - dash) & dash;
+        } while (sub);
+    }
+    u = 0;
+    for (int i = 0; i < n_cubes; i++) {
+        uint32_t dash = full & ~cubes[i].mask, sub = 0;
+        int redundant = 1;
+        do {
+            uint32_t r = cubes[i].value | sub;
+            if (test_bit(on, r) && cover_count[r] < 2) { redundant = 0; break; }
+            sub = (sub - dash) & dash;
+        } while (sub);
+        if (!redundant) { cubes[u++] = cubes[i]; continue; }
+        sub = 0;
+        do {
+            uint32_t r = cubes[i].value | sub;
+            if (test_bit(on, r)) cover_count[r]--;
+            sub = (sub - dash) & dash;
+        } while (sub);
+    }
+    rc = u;
+    *out = cubes;
+    cubes = NULL;
+
+done:
+    free(cubes);
+    free(cover_count);
+    return rc;
+}
+
+int bool_minimize(int n_vars, const uint64_t *on, const uint64_t *dc, int method, bool_cube_t **cubes) {
+    if (n_vars < 1 || n_vars > BOOL_MAX_VARS) return -1;
+    size_t W = n_words(n_vars);
+    uint64_t *care = malloc(W * sizeof(uint64_t));
+    uint64_t *on_only = malloc(W * sizeof(uint64_t));
+    int rc = -1;
+    if (!care || !on_only) goto done;
+
+    uint64_t valid = n_vars >= 6 ? ~0ull : (1ull << (1 << n_vars)) - 1;
+    for (size_t w = 0; w < W; w++) {
+        uint64_t d = dc ? dc[w] : 0;
+        care[w] = (on[w] | d) & valid;
+        on_only[w] = on[w] & ~d & valid;
+    }
+
+    if (method == BOOL_AUTO) method = n_vars <= 16 ? BOOL_EXACT : BOOL_HEURISTIC;
+    if (method == BOOL_EXACT) {
+        bool_cube_t *primes = NULL;
+        long n_primes = qm_primes(n_vars, care, &primes);
+        if (n_primes >= 0 && n_primes < (1L << 30))
+            rc = select_cover(n_vars, on_only, primes, (int)n_primes, cubes);
+        free(primes);
+    } else if (method == BOOL_HEURISTIC) {
+        rc = heuristic_cover(n_vars, on_only, care, cubes);
+    }
+
+done:
+    free(care);
+    free(on_only);
+    return rc;
+}
+
+/* Append str at buf+len, copying only what fits below cap-1 */
+static size_t put(char *buf, size_t cap, size_t len, const char *str) {
+    size_t l = strlen(str);
+    if (len + 1 < cap) memcpy(buf + len, str, len + l < cap - 1 ? l : cap - 1 - len);
+    return len + l;
+}
+
+size_t bool_format_sop(const bool_expr_t *e, const bool_cube_t *cubes, int n, char *buf, size_t cap) {
+    size_t len = 0;
+    int nv = e->n_vars;
+
+    if (n == 0) len = put(buf, cap, len, "0");
+    for (int i = 0; i < n; i++) {
+        if (i) len = put(buf, cap, len, " | ");
+        int lits = 0;
+        for (int v = 0; v < nv; v++) {
+            uint32_t bit = 1u << (nv - 1 - v);
+            if (!(cubes[i].mask & bit)) continue;
+            if (lits++) len = put(buf, cap, len, " & ");
+            if (!(cubes[i].value & bit)) len = put(buf, cap, len, "!");
+            len = put(buf, cap, len, e->names[v]);
+        }
+        if (!lits) len = put(buf, cap, len, "1");
+    }
+    if (cap) buf[len < cap ? len : cap - 1] = '\0';
+    return len;
+}
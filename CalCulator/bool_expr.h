@@ -0,0 +1,52 @@
+#ifndef BOOL_EXPR_H
+#define BOOL_EXPR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "truth_table.h"
+
+/* Boolean expressions over named variables, e.g.
+       !A & B | C ^ (D + E)'      A(B + C)      NAND(A, B, C) | XOR(C, D)
+   NOT: ! ~ or a trailing '     AND: & * . or juxtaposition (A B, A(B+C))
+   XOR: ^                       OR:  | +
+   Gate calls AND/OR/NAND/NOR/XOR/XNOR/NOT(...) follow gate_eval(): XOR is
+   odd parity over all arguments. Precedence NOT > AND > XOR > OR.
+   Variables (letters, digits, '_') are numbered in alphabetical order. */
+
+#define BOOL_NAME_LEN 16
+
+typedef struct {
+    int n_vars;
+    char names[TT_MAX_INPUTS][BOOL_NAME_LEN];
+    tt_program_t *prog;             /* one output, inputs = variables */
+} bool_expr_t;
+
+bool_expr_t *bool_parse(const char *text);      /* NULL (after printing why) on error */
+void bool_free(bool_expr_t *e);
+
+/* A product term over row-number bits (variable i = bit n_vars-1-i):
+   mask has a 1 for every variable present, value its polarity */
+typedef struct {
+    uint32_t value, mask;
+} bool_cube_t;
+
+#define BOOL_MAX_VARS   24          /* largest function the minimizer accepts */
+#define BOOL_AUTO       0           /* exact up to 16 variables, else heuristic */
+#define BOOL_EXACT      1           /* Quine-McCluskey primes + cover */
+#define BOOL_HEURISTIC  2           /* Espresso-style expand / irredundant */
+
+/* Two-level minimization of the function whose on-set (and optional
+   don't-care set, may be NULL) are bit vectors of 2^n_vars rows, row r at
+   bit r % 64 of word r / 64. On success *cubes is a malloc'd cover and
+   its length is returned; -1 on bad input or if the exact method would
+   need too much memory. */
+int bool_minimize(int n_vars, const uint64_t *on, const uint64_t *dc, int method, bool_cube_t **cubes);
+
+/* On-set bit vector of an expression (malloc'd, 2^n_vars bits) */
+uint64_t *bool_on_set(const bool_expr_t *e);
+
+/* "A & !B | C" using the expression's variable names; "0" / "1" for
+   constant covers. Returns the full length (output cut to cap). */
+size_t bool_format_sop(const bool_expr_t *e, const bool_cube_t *cubes, int n, char *buf, size_t cap);
+
+#endif
@@ -1,6 +1,12 @@
-#ifndef CAPACITOR_CALC_H
-#define CAPACITOR_CALC_H
-
-void capacitor_menu(void);
-
-#endif
+#ifndef CAPACITOR_CALC_H
+#define CAPACITOR_CALC_H
+
+#include <stddef.h>
+
+void capacitor_menu(void);
+
+/* Decode a 3-digit (104) or R-notation (1R5 = 1.5 pF) capacitor code to
+   farads; 0 if invalid */
+int smd_capacitor_value(const char *code, size_t len, double *farads);
+
+#endif
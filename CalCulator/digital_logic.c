@@ -1,227 +1,475 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <stdint.h>
-#include <ctype.h>
-#include "digital_logic.h"
-#include "math_ops.h"   // optional: for parse_with_prefix if you want numeric parsing with prefixes
-
-/* --------------------
-   Helper utilities
-   -------------------- */
-
-static void print_bin_uint32(uint32_t v, int bits) {
-    if (bits <= 0) bits = 32;
-    for (int i = bits - 1; i >= 0; --i) {
-        putchar((v & (1u << i)) ? '1' : '0');
-        if (i % 4 == 0 && i != 0) putchar(' '); // nibble spacing
-    }
-}
-
-/* Parse integer from a string supporting prefixes like 0b/0x, or decimal */
-static uint32_t parse_int(const char *s) {
-    if (s == NULL) return 0;
-    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
-        return (uint32_t)strtoul(s + 2, NULL, 16);
-    } else if (s[0] == '0' && (s[1] == 'b' || s[1] == 'B')) {
-        return (uint32_t)strtoul(s + 2, NULL, 2);
-    } else if (s[0] == '0' && isdigit((unsigned char)s[1])) {
-        return (uint32_t)strtoul(s, NULL, 8); // octal literal like 0755
-    } else {
-        return (uint32_t)strtoul(s, NULL, 10);
-    }
-}
-
-/* --------------------
-   Number system conversions
-   -------------------- */
-
-static void convert_number_systems(void) {
-    char buf[64];
-    printf("Enter number (prefix 0b for binary, 0x for hex, leading 0 for octal, otherwise decimal): ");
-    scanf("%63s", buf);
-    uint32_t val = parse_int(buf);
-
-    printf("DEC: %u\n", val);
-    printf("HEX: 0x%X\n", val);
-    printf("OCT: 0%o\n", val);
-    printf("BIN: ");
-    print_bin_uint32(val, 32);
-    putchar('\n');
-}
-
-/* --------------------
-   Bitwise operations
-   -------------------- */
-
-static void bitwise_ops(void) {
-    char a_str[64], b_str[64];
-    printf("Enter first operand: ");
-    scanf("%63s", a_str);
-    printf("Enter second operand: ");
-    scanf("%63s", b_str);
-
-    uint32_t a = parse_int(a_str);
-    uint32_t b = parse_int(b_str);
-
-    printf("A = %u (0x%X) BIN: ", a, a); print_bin_uint32(a, 32); putchar('\n');
-    printf("B = %u (0x%X) BIN: ", b, b); print_bin_uint32(b, 32); putchar('\n');
-
-    printf("A & B = %u (0x%X) BIN: ", a & b, a & b); print_bin_uint32(a & b, 32); putchar('\n');
-    printf("A | B = %u (0x%X) BIN: ", a | b, a | b); print_bin_uint32(a | b, 32); putchar('\n');
-    printf("A ^ B = %u (0x%X) BIN: ", a ^ b, a ^ b); print_bin_uint32(a ^ b, 32); putchar('\n');
-    printf("~A    = %u (0x%X) BIN: ", ~a, ~a); print_bin_uint32(~a, 32); putchar('\n');
-    printf("A << 1 = %u (0x%X) BIN: ", a << 1, a << 1); print_bin_uint32(a << 1, 32); putchar('\n');
-    printf("A >> 1 = %u (0x%X) BIN: ", a >> 1, a >> 1); print_bin_uint32(a >> 1, 32); putchar('\n');
-}
-
-/* --------------------
-   Shift and rotate (32-bit)
-   -------------------- */
-
-static void shift_rotate(void) {
-    char buf[64];
-    printf("Enter value: ");
-    scanf("%63s", buf);
-    uint32_t v = parse_int(buf);
-
-    int n; printf("Enter shift/rotate amount (0-31): "); scanf("%d", &n);
-    n &= 31;
-
-    uint32_t lshift = v << n;
-    uint32_t rshift = v >> n;
-    uint32_t rrotate = (v >> n) | (v << (32 - n));
-    uint32_t lrotate = (v << n) | (v >> (32 - n));
-
-    printf("Value: "); print_bin_uint32(v, 32); putchar('\n');
-    printf("Left shift  << %d : ", n); print_bin_uint32(lshift, 32); putchar('\n');
-    printf("Right shift >> %d : ", n); print_bin_uint32(rshift, 32); putchar('\n');
-    printf("Rotate L   rol %d : ", n); print_bin_uint32(lrotate, 32); putchar('\n');
-    printf("Rotate R   ror %d : ", n); print_bin_uint32(rrotate, 32); putchar('\n');
-}
-
-/* --------------------
-   Truth table generator for 1..3 inputs
-   -------------------- */
-
-static int gate_eval(int gate_type, int *inputs, int n_inputs) {
-    /* gate_type:
-       0 = AND
-       1 = OR
-       2 = NAND
-       3 = NOR
-       4 = XOR
-       5 = XNOR
-       6 = NOT (only inputs[0] used)
-    */
-    if (gate_type == 6) return !inputs[0];
-
-    int res;
-    if (gate_type == 0) { res = 1; for (int i=0;i<n_inputs;i++) res &= inputs[i]; }
-    else if (gate_type == 1) { res = 0; for (int i=0;i<n_inputs;i++) res |= inputs[i]; }
-    else if (gate_type == 2) { res = 1; for (int i=0;i<n_inputs;i++) res &= inputs[i]; res = !res; }
-    else if (gate_type == 3) { res = 0; for (int i=0;i<n_inputs;i++) res |= inputs[i]; res = !res; }
-    else if (gate_type == 4) { res = 0; for (int i=0;i<n_inputs;i++) res ^= inputs[i]; }
-    else if (gate_type == 5) { res = 0; for (int i=0;i<n_inputs;i++) res ^= inputs[i]; res = !res; }
-    else res = 0;
-
-    return res;
-}
-
-static void truth_table(void) {
-    int gate;
-    printf("Select gate: 0=AND 1=OR 2=NAND 3=NOR 4=XOR 5=XNOR 6=NOT\n");
-    scanf("%d", &gate);
-    int n;
-    if (gate == 6) n = 1; else {
-        printf("Number of inputs (1..3): "); scanf("%d", &n);
-        if (n < 1) n = 1;
-        if (n > 3) n = 3;
-    }
-
-    int rows = 1 << n;
-    printf("\nTruth table for %s with %d input(s):\n", (gate==0?"AND":gate==1?"OR":gate==2?"NAND":gate==3?"NOR":gate==4?"XOR":gate==5?"XNOR":"NOT"), n);
-    for (int r = 0; r < rows; ++r) {
-        int inputs[3] = {0,0,0};
-        for (int b = 0; b < n; ++b) inputs[b] = (r >> (n - 1 - b)) & 1;
-        for (int b = 0; b < n; ++b) printf("%d ", inputs[b]);
-        int out = gate_eval(gate, inputs, n);
-        printf("| %d\n", out);
-    }
-}
-
-/* --------------------
-   Flip-flop single-step simulator (SR, D, JK)
-   -------------------- */
-
-static void flop_simulator(void) {
-    int type;
-    printf("Select flip-flop: 1=SR 2=D 3=JK: ");
-    scanf("%d", &type);
-
-    int Qprev;
-    printf("Enter previous Q (0 or 1): ");
-    scanf("%d", &Qprev);
-
-    if (type == 1) {
-        int S, R;
-        printf("Enter S (0/1) and R (0/1): ");
-        scanf("%d %d", &S, &R);
-        if (S == 0 && R == 0) {
-            printf("No change: Qnext = %d\n", Qprev);
-        } else if (S == 0 && R == 1) {
-            printf("Reset: Qnext = 0\n");
-        } else if (S == 1 && R == 0) {
-            printf("Set: Qnext = 1\n");
-        } else {
-            printf("Invalid/Forbidden (S=1,R=1) — undefined in basic SR flop\n");
-        }
-    } else if (type == 2) {
-        int D;
-        printf("Enter D (0/1): ");
-        scanf("%d", &D);
-        printf("D latch: Qnext = %d\n", D);
-    } else if (type == 3) {
-        int J, K;
-        printf("Enter J (0/1) and K (0/1): ");
-        scanf("%d %d", &J, &K);
-        int Qnext;
-        if (J == 0 && K == 0) Qnext = Qprev;
-        else if (J == 0 && K == 1) Qnext = 0;
-        else if (J == 1 && K == 0) Qnext = 1;
-        else { /* J==1 && K==1 */ Qnext = !Qprev; }
-        printf("JK flop: Qnext = %d\n", Qnext);
-    } else {
-        printf("Invalid flop type.\n");
-    }
-}
-
-/* --------------------
-   Module menu
-   -------------------- */
-
-void digital_menu(void) {
-    int choice;
-    do {
-        printf("\n==== DIGITAL LOGIC MODULE ====\n");
-        printf("1. Number System Conversions (bin/dec/oct/hex)\n");
-        printf("2. Bitwise Operations (AND/OR/XOR/NOT/SHIFT)\n");
-        printf("3. Shift & Rotate\n");
-        printf("4. Truth Table Generator (1-3 inputs)\n");
-        printf("5. Flip-flop Step (SR/D/JK)\n");
-        printf("0. Return to Main Menu\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        getchar();
-
-        switch (choice) {
-            case 1: convert_number_systems(); break;
-            case 2: bitwise_ops(); break;
-            case 3: shift_rotate(); break;
-            case 4: truth_table(); break;
-            case 5: flop_simulator(); break;
-            case 0: break;
-            default: printf("Invalid option.\n");
-        }
-    } while (choice != 0);
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <time.h>
+#include "digital_logic.h"
+#include "truth_table.h"
+#include "bool_expr.h"
+#include "logic_sim.h"
+#include "num_convert.h"
+#include "bit_buffer.h"
+#include "math_ops.h"   // optional: for parse_with_prefix if you want numeric parsing with prefixes
+
+/* --------------------
+   Helper utilities
+   -------------------- */
+
+/* Binary with nibble spacing, at least 'bits' digits */
+static void print_bin(uint64_t v, int bits) {
+    char buf[NUM_MAX_CHARS];
+    num_format(v, 2, bits, NUM_GROUP, buf);
+    fputs(buf, stdout);
+}
+
+/* 0x / 0b / 0o prefix or leading 0 for octal, otherwise decimal; 64-bit */
+static int parse_int(const char *s, uint64_t *v) {
+    int rc = num_parse(s, strlen(s), NUM_AUTO, v);
+    if (rc == NUM_OVERFLOW) printf("%s does not fit in 64 bits.\n", s);
+    else if (rc != NUM_OK) printf("%s is not a valid number.\n", s);
+    return rc == NUM_OK;
+}
+
+/* Narrowest of 32 / 64 bits that holds v */
+static int word_bits(uint64_t v) { return v >> 32 ? 64 : 32; }
+
+static void print_value(const char *label, uint64_t v, int bits) {
+    char hex[NUM_MAX_CHARS];
+    num_format(v, 16, 0, NUM_PREFIX, hex);
+    printf("%s = %llu (%s) BIN: ", label, (unsigned long long)v, hex);
+    print_bin(v, bits);
+    putchar('\n');
+}
+
+/* --------------------
+   Number system conversions
+   -------------------- */
+
+static void convert_number_systems(void) {
+    char buf[128], out[NUM_MAX_CHARS];
+    uint64_t val;
+    printf("Enter number (prefix 0b for binary, 0x for hex, leading 0 for octal, otherwise decimal): ");
+    scanf("%127s", buf);
+    if (!parse_int(buf, &val)) return;
+
+    num_format(val, 10, 0, 0, out);           printf("DEC: %s\n", out);
+    num_format(val, 16, 0, NUM_PREFIX, out);  printf("HEX: %s\n", out);
+    num_format(val, 8, 0, NUM_PREFIX, out);   printf("OCT: %s\n", out);
+    printf("BIN: ");
+    print_bin(val, word_bits(val));
+    putchar('\n');
+}
+
+static int read_base(const char *prompt, int allow_auto) {
+    int base;
+    printf("%s", prompt);
+    if (scanf("%d", &base) != 1) return -1;
+    if ((base == 0 && allow_auto) || base == 2 || base == 8 || base == 10 || base == 16) return base;
+    printf("Base must be 2, 8, 10 or 16%s.\n", allow_auto ? " (or 0 for auto)" : "");
+    return -1;
+}
+
+static void convert_file(void) {
+    char in[256], out[256];
+    printf("Input file: ");
+    scanf("%255s", in);
+    printf("Output file: ");
+    scanf("%255s", out);
+    int from = read_base("Input base (0 = auto from prefix, 2, 8, 10, 16): ", 1);
+    if (from < 0) return;
+    int to = read_base("Output base (2, 8, 10, 16): ", 0);
+    if (to < 0) return;
+    int prefix;
+    printf("Write 0x/0b/0 prefixes? (1 = yes, 0 = no): ");
+    scanf("%d", &prefix);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int rc = num_convert_file(in, out, from, to, prefix ? NUM_PREFIX : 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc == 0)
+        printf("Done in %.3f s\n", (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+}
+
+/* --------------------
+   Bitwise operations (64-bit)
+   -------------------- */
+
+static void bitwise_ops(void) {
+    char a_str[128], b_str[128];
+    uint64_t a, b;
+    printf("Enter first operand: ");
+    scanf("%127s", a_str);
+    printf("Enter second operand: ");
+    scanf("%127s", b_str);
+    if (!parse_int(a_str, &a) || !parse_int(b_str, &b)) return;
+
+    /* Show 32-bit results unless an operand needs 64 */
+    int bits = word_bits(a | b);
+    uint64_t mask = bits == 64 ? ~0ull : 0xFFFFFFFFull;
+
+    print_value("A", a, bits);
+    print_value("B", b, bits);
+    print_value("A & B", a & b, bits);
+    print_value("A | B", a | b, bits);
+    print_value("A ^ B", a ^ b, bits);
+    print_value("~A   ", ~a & mask, bits);
+    print_value("A << 1", (a << 1) & mask, bits);
+    print_value("A >> 1", a >> 1, bits);
+}
+
+/* --------------------
+   Shift and rotate (8 to 64-bit registers)
+   -------------------- */
+
+static void shift_rotate(void) {
+    char buf[128];
+    uint64_t v;
+    printf("Enter value: ");
+    scanf("%127s", buf);
+    if (!parse_int(buf, &v)) return;
+
+    int width = 32, n;
+    printf("Register width (8, 16, 32 or 64 bits): "); scanf("%d", &width);
+    if (width != 8 && width != 16 && width != 64) width = 32;
+    uint64_t mask = width == 64 ? ~0ull : (1ull << width) - 1;
+    if (v & ~mask) printf("Value truncated to %d bits.\n", width);
+    v &= mask;
+
+    printf("Enter shift/rotate amount (0-%d): ", width - 1); scanf("%d", &n);
+    n = ((n % width) + width) % width;
+
+    uint64_t lshift = (v << n) & mask;
+    uint64_t rshift = v >> n;
+    uint64_t lrotate = n ? ((v << n) | (v >> (width - n))) & mask : v;
+    uint64_t rrotate = n ? ((v >> n) | (v << (width - n))) & mask : v;
+
+    printf("Value: "); print_bin(v, width); putchar('\n');
+    printf("Left shift  << %d : ", n); print_bin(lshift, width); putchar('\n');
+    printf("Right shift >> %d : ", n); print_bin(rshift, width); putchar('\n');
+    printf("Rotate L   rol %d : ", n); print_bin(lrotate, width); putchar('\n');
+    printf("Rotate R   ror %d : ", n); print_bin(rrotate, width); putchar('\n');
+}
+
+/* --------------------
+   Bitwise operations over whole files
+   -------------------- */
+
+static void bitwise_files(void) {
+    static const char *const names[] = { "AND", "OR", "XOR", "NOT", "shift left", "shift right",
+                                         "rotate left", "rotate right", "popcount", "Hamming distance" };
+    char a[256], b[256], out[256];
+    int choice;
+    unsigned long long k = 0;
+    printf("Operation:\n");
+    for (int i = 0; i < 10; i++) printf("  %d. %s\n", i + 1, names[i]);
+    printf("Choice: ");
+    if (scanf("%d", &choice) != 1 || choice < 1 || choice > 10) { printf("Invalid option.\n"); return; }
+    int op = choice - 1, two = op <= BITBUF_XOR || choice == 10;
+
+    printf(two ? "First file: " : "File: ");
+    scanf("%255s", a);
+    if (two) { printf("Second file: "); scanf("%255s", b); }
+    if (op >= BITBUF_SHL && op <= BITBUF_ROR) {
+        printf("Bits to shift/rotate (the file is one big-endian bit string): ");
+        scanf("%llu", &k);
+    }
+    if (choice <= 8) { printf("Output file: "); scanf("%255s", out); }
+
+    struct timespec t0, t1;
+    uint64_t bits = 0, bytes = 0;
+    int rc;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (choice <= 8) rc = bitbuf_file(op, a, two ? b : NULL, out, k, &bytes);
+    else rc = bitbuf_count_file(a, two ? b : NULL, &bits, &bytes);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc) return;
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    if (choice == 9) {
+        printf("%llu of %llu bits set (%.4f%%)\n", (unsigned long long)bits, (unsigned long long)bytes * 8,
+               bytes ? 100.0 * bits / (bytes * 8.0) : 0.0);
+    } else if (choice == 10) {
+        printf("Hamming distance: %llu of %llu bits differ (%.4f%%)\n", (unsigned long long)bits,
+               (unsigned long long)bytes * 8, bytes ? 100.0 * bits / (bytes * 8.0) : 0.0);
+    }
+    printf("%llu bytes in %.3f s: %.2f GB/s of input\n", (unsigned long long)bytes, secs,
+           secs > 0 ? bytes * (two ? 2 : 1) / secs / 1e9 : 0.0);
+}
+
+/* --------------------
+   Truth table generator (1..32 inputs, bit-sliced)
+   -------------------- */
+
+int gate_eval(int gate_type, const int *inputs, int n_inputs) {
+    /* gate_type:
+       0 = AND
+       1 = OR
+       2 = NAND
+       3 = NOR
+       4 = XOR
+       5 = XNOR
+       6 = NOT (only inputs[0] used)
+    */
+    if (gate_type == 6) return !inputs[0];
+
+    int res;
+    if (gate_type == 0) { res = 1; for (int i=0;i<n_inputs;i++) res &= inputs[i]; }
+    else if (gate_type == 1) { res = 0; for (int i=0;i<n_inputs;i++) res |= inputs[i]; }
+    else if (gate_type == 2) { res = 1; for (int i=0;i<n_inputs;i++) res &= inputs[i]; res = !res; }
+    else if (gate_type == 3) { res = 0; for (int i=0;i<n_inputs;i++) res |= inputs[i]; res = !res; }
+    else if (gate_type == 4) { res = 0; for (int i=0;i<n_inputs;i++) res ^= inputs[i]; }
+    else if (gate_type == 5) { res = 0; for (int i=0;i<n_inputs;i++) res ^= inputs[i]; res = !res; }
+    else res = 0;
+
+    return res;
+}
+
+static void truth_table(void) {
+    static const char *const gate_names[] = { "AND", "OR", "NAND", "NOR", "XOR", "XNOR", "NOT" };
+    int gate;
+    printf("Select gate: 0=AND 1=OR 2=NAND 3=NOR 4=XOR 5=XNOR 6=NOT\n");
+    scanf("%d", &gate);
+    if (gate < 0 || gate > 6) { printf("Invalid gate.\n"); return; }
+    int n;
+    if (gate == 6) n = 1; else {
+        printf("Number of inputs (1..%d): ", TT_MAX_INPUTS); scanf("%d", &n);
+        if (n < 1) n = 1;
+        if (n > TT_MAX_INPUTS) n = TT_MAX_INPUTS;
+    }
+
+    tt_program_t *p = tt_gate_program(gate, n);
+    if (!p) { printf("Out of memory.\n"); return; }
+    uint64_t rows = 1ull << n;
+
+    if (n <= 6) {
+        printf("\nTruth table for %s with %d input(s):\n", gate_names[gate], n);
+        tt_write(p, stdout, TT_TEXT);
+    } else {
+        char path[256];
+        int format;
+        printf("%llu rows - output file: ", (unsigned long long)rows);
+        scanf("%255s", path);
+        printf("Format (0 = text rows, 1 = packed output bits): ");
+        scanf("%d", &format);
+        FILE *f = fopen(path, "wb");
+        if (!f) { printf("Cannot create %s\n", path); tt_program_free(p); return; }
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        int rc = tt_write(p, f, format ? TT_PACKED : TT_TEXT);
+        if (fclose(f) != 0) rc = 1;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+        if (rc) printf("Writing %s failed.\n", path);
+        else printf("Wrote %s table to %s in %.2f s (%.1f M rows/s)\n",
+                    gate_names[gate], path, secs, rows / secs / 1e6);
+    }
+    printf("Output is 1 in %llu of %llu rows\n",
+           (unsigned long long)tt_count_ones(p, 0), (unsigned long long)rows);
+    tt_program_free(p);
+}
+
+/* --------------------
+   Flip-flop single-step simulator (SR, D, JK)
+   -------------------- */
+
+static void flop_simulator(void) {
+    int type;
+    printf("Select flip-flop: 1=SR 2=D 3=JK: ");
+    scanf("%d", &type);
+
+    int Qprev;
+    printf("Enter previous Q (0 or 1): ");
+    scanf("%d", &Qprev);
+
+    if (type == 1) {
+        int S, R;
+        printf("Enter S (0/1) and R (0/1): ");
+        scanf("%d %d", &S, &R);
+        if (S == 0 && R == 0) {
+            printf("No change: Qnext = %d\n", Qprev);
+        } else if (S == 0 && R == 1) {
+            printf("Reset: Qnext = 0\n");
+        } else if (S == 1 && R == 0) {
+            printf("Set: Qnext = 1\n");
+        } else {
+            printf("Invalid/Forbidden (S=1,R=1) — undefined in basic SR flop\n");
+        }
+    } else if (type == 2) {
+        int D;
+        printf("Enter D (0/1): ");
+        scanf("%d", &D);
+        printf("D latch: Qnext = %d\n", D);
+    } else if (type == 3) {
+        int J, K;
+        printf("Enter J (0/1) and K (0/1): ");
+        scanf("%d %d", &J, &K);
+        int Qnext;
+        if (J == 0 && K == 0) Qnext = Qprev;
+        else if (J == 0 && K == 1) Qnext = 0;
+        else if (J == 1 && K == 0) Qnext = 1;
+        else { /* J==1 && K==1 */ Qnext = !Qprev; }
+        printf("JK flop: Qnext = %d\n", Qnext);
+    } else {
+        printf("Invalid flop type.\n");
+    }
+}
+
+/* --------------------
+   Boolean expression -> truth table and minimized sum of products
+   -------------------- */
+
+static void boolean_minimize(void) {
+    char line[1024];
+    printf("Expression (e.g. !A & B | A C' ^ D): ");
+    if (!fgets(line, sizeof(line), stdin)) return;
+    line[strcspn(line, "\r\n")] = '\0';
+
+    bool_expr_t *e = bool_parse(line);
+    if (!e) return;
+    if (e->n_vars == 0) {
+        printf("Constant expression: %d\n", tt_count_ones(e->prog, 0) != 0);
+        bool_free(e);
+        return;
+    }
+    if (e->n_vars > BOOL_MAX_VARS) {
+        printf("Too many variables to minimize (max %d).\n", BOOL_MAX_VARS);
+        bool_free(e);
+        return;
+    }
+
+    printf("Variables:");
+    for (int i = 0; i < e->n_vars; i++) printf(" %s", e->names[i]);
+    printf("\n");
+    if (e->n_vars <= 6) tt_write(e->prog, stdout, TT_TEXT);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64_t *on = bool_on_set(e);
+    bool_cube_t *cubes = NULL;
+    int n = on ? bool_minimize(e->n_vars, on, NULL, BOOL_AUTO, &cubes) : -1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    free(on);
+    if (n < 0) { printf("Minimization failed (out of memory).\n"); bool_free(e); return; }
+
+    int literals = 0;
+    for (int i = 0; i < n; i++) literals += __builtin_popcount(cubes[i].mask);
+    size_t len = bool_format_sop(e, cubes, n, NULL, 0);
+    char *sop = malloc(len + 1);
+    if (sop) {
+        bool_format_sop(e, cubes, n, sop, len + 1);
+        printf("Minimized SOP: %s\n", sop);
+    }
+    printf("%d term(s), %d literal(s), %s method, %.3f s\n", n, literals,
+           e->n_vars <= 16 ? "exact" : "heuristic",
+           (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    free(sop);
+    free(cubes);
+    bool_free(e);
+}
+
+/* --------------------
+   Clocked circuit simulation from a netlist file
+   -------------------- */
+
+static void circuit_simulator(void) {
+    char path[256];
+    printf("Netlist file: ");
+    if (scanf("%255s", path) != 1) return;
+    logic_sim_t *s = lsim_load(path);
+    if (!s) return;
+    printf("%d input(s), %d output(s), %d flip-flop(s), %d instructions per cycle\n",
+           lsim_inputs(s), lsim_outputs(s), lsim_flops(s), lsim_instructions(s));
+
+    int stimulus = LSIM_HOLD;
+    if (lsim_inputs(s) > 0) {
+        printf("Stimulus (0 = fixed input values, 1 = random every cycle): ");
+        scanf("%d", &stimulus);
+        stimulus = stimulus ? LSIM_RANDOM : LSIM_HOLD;
+        for (int i = 0; stimulus == LSIM_HOLD && i < lsim_inputs(s); i++) {
+            int v = 0;
+            printf("Value of %s (0/1): ", lsim_input_name(s, i));
+            scanf("%d", &v);
+            lsim_set_input(s, i, v);
+        }
+    }
+
+    long long trace = 0, cycles = 0;
+    int vectors = 1;
+    printf("Cycles to show (0 = none, max 1000): ");
+    scanf("%lld", &trace);
+    if (trace > 1000) trace = 1000;
+    if (trace > 0) lsim_trace(s, stdout, (uint64_t)trace, stimulus, 1);
+
+    printf("Cycles to simulate: ");
+    scanf("%lld", &cycles);
+    printf("Parallel stimulus vectors (runs in groups of 256): ");
+    scanf("%d", &vectors);
+    if (cycles <= 0) { lsim_free(s); return; }
+    if (vectors < 1) vectors = 1;
+    if (vectors > LSIM_MAX_VECTORS) {
+        printf("Too many vectors (max %d).\n", LSIM_MAX_VECTORS);
+        lsim_free(s);
+        return;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int rc = lsim_run(s, vectors, (uint64_t)cycles, stimulus, 1);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc) { printf("Simulation failed (out of memory).\n"); lsim_free(s); return; }
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    long long run_vectors = ((long long)vectors + 255) / 256 * 256;
+
+    printf("Outputs after %lld cycles (vector 0):", cycles);
+    for (int i = 0; i < lsim_outputs(s); i++) printf(" %s=%d", lsim_output_name(s, i), lsim_output(s, i, 0));
+    printf("\n");
+    if (stimulus == LSIM_RANDOM)
+        for (int i = 0; i < lsim_outputs(s); i++)
+            printf("  %s is 1 in %llu of %lld vectors\n", lsim_output_name(s, i),
+                   (unsigned long long)lsim_output_count(s, i), run_vectors);
+    printf("%lld vectors x %lld cycles in %.3f s: %.1f M cycles/s, %.2f G vector-cycles/s\n",
+           run_vectors, cycles, secs, cycles / secs / 1e6, (double)cycles * run_vectors / secs / 1e9);
+    lsim_free(s);
+}
+
+/* --------------------
+   Module menu
+   -------------------- */
+
+void digital_menu(void) {
+    int choice;
+    do {
+        printf("\n==== DIGITAL LOGIC MODULE ====\n");
+        printf("1. Number System Conversions (bin/dec/oct/hex, 64-bit)\n");
+        printf("2. Bitwise Operations (AND/OR/XOR/NOT/SHIFT)\n");
+        printf("3. Shift & Rotate\n");
+        printf("4. Truth Table Generator (1-32 inputs)\n");
+        printf("5. Flip-flop Step (SR/D/JK)\n");
+        printf("6. Boolean Expression -> Table & Minimized SOP\n");
+        printf("7. Clocked Circuit Simulator (netlist file)\n");
+        printf("8. Convert a File of Numbers (bin/oct/dec/hex)\n");
+        printf("9. Bitwise Operations / Popcount on Files\n");
+        printf("0. Return to Main Menu\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        getchar();
+
+        switch (choice) {
+            case 1: convert_number_systems(); break;
+            case 2: bitwise_ops(); break;
+            case 3: shift_rotate(); break;
+            case 4: truth_table(); break;
+            case 5: flop_simulator(); break;
+            case 6: boolean_minimize(); break;
+            case 7: circuit_simulator(); break;
+            case 8: convert_file(); break;
+            case 9: bitwise_files(); break;
+            case 0: break;
+            default: printf("Invalid option.\n");
+        }
+    } while (choice != 0);
+}
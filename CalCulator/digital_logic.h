@@ -1,6 +1,9 @@
-#ifndef DIGITAL_LOGIC_H
-#define DIGITAL_LOGIC_H
-
-void digital_menu(void);
-
-#endif
+#ifndef DIGITAL_LOGIC_H
+#define DIGITAL_LOGIC_H
+
+void digital_menu(void);
+
+/* gate_type: 0=AND 1=OR 2=NAND 3=NOR 4=XOR 5=XNOR 6=NOT (inputs[0] only) */
+int gate_eval(int gate_type, const int *inputs, int n_inputs);
+
+#endif
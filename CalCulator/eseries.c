@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "math_ops.h"
+#include "parallel.h"
+#include "eseries.h"
+
+/* ────────────────────────────────────────────────
+   PREFERRED-VALUE TABLES
+   E96 is every other E192 value.
+   ──────────────────────────────────────────────── */
+
+static const short e12[12] = { 100,120,150,180,220,270,330,390,470,560,680,820 };
+
+static const short e24[24] = {
+    100,110,120,130,150,160,180,200,220,240,270,300,
+    330,360,390,430,470,510,560,620,680,750,820,910
+};
+
+static const short e192[192] = {
+    100,101,102,104,105,106,107,109,110,111,113,114,115,117,118,120,
+    121,123,124,126,127,129,130,132,133,135,137,138,140,142,143,145,
+    147,149,150,152,154,156,158,160,162,164,165,167,169,172,174,176,
+    178,180,182,184,187,189,191,193,196,198,200,203,205,208,210,213,
+    215,218,221,223,226,229,232,234,237,240,243,246,249,252,255,258,
+    261,264,267,271,274,277,280,284,287,291,294,298,301,305,309,312,
+    316,320,324,328,332,336,340,344,348,352,357,361,365,370,374,379,
+    383,388,392,397,402,407,412,417,422,427,432,437,442,448,453,459,
+    464,470,475,481,487,493,499,505,511,517,523,530,536,542,549,556,
+    562,569,576,583,590,597,604,612,619,626,634,642,649,657,665,673,
+    681,690,698,706,715,723,732,741,750,759,768,777,787,796,806,816,
+    825,835,845,856,866,876,887,898,909,920,931,942,953,965,976,988
+};
+
+int eseries_count(int series) {
+    switch (series) {
+        case 12: case 24: case 96: case 192: return series;
+        default: return 0;
+    }
+}
+
+int eseries_mantissa(int series, int index) {
+    switch (series) {
+        case 12:  return e12[index];
+        case 24:  return e24[index];
+        case 96:  return e192[2 * index];
+        default:  return e192[index];
+    }
+}
+
+/* ────────────────────────────────────────────────
+   PAIR TABLES
+   Every part from 1 Ω to 10 MΩ, and every unordered
+   pair of parts combined in series and in parallel,
+   sorted by value. Built once per series.
+   ──────────────────────────────────────────────── */
+
+#define DECADES   7             /* 1 Ω .. 9.x MΩ, plus 10 MΩ */
+#define MAX_K     1000
+
+typedef struct {
+    double v;
+    unsigned short a, b;        /* part indices, a <= b */
+} pair_t;
+
+typedef struct {
+    int ready;
+    int n_parts;
+    double *part;               /* ascending */
+    size_t n_pairs;
+    pair_t *sum, *par;
+} table_t;
+
+static table_t tables[4];
+static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static double par2(double a, double b) { return a * b / (a + b); }
+
+static int cmp_pair(const void *x, const void *y) {
+    const pair_t *p = x, *q = y;
+    if (p->v != q->v) return p->v < q->v ? -1 : 1;
+    if (p->a != q->a) return p->a - q->a;
+    return p->b - q->b;
+}
+
+static const table_t *get_table(int series) {
+    int slot = series == 12 ? 0 : series == 24 ? 1 : series == 96 ? 2 : 3;
+    table_t *t = &tables[slot];
+
+    pthread_mutex_lock(&table_lock);
+    if (!t->ready) {
+        int n = series * DECADES + 1;
+        size_t n_pairs = (size_t)n * (n + 1) / 2;
+        t->part = malloc(n * sizeof(double));
+        t->sum = malloc(n_pairs * sizeof(pair_t));
+        t->par = malloc(n_pairs * sizeof(pair_t));
+        if (t->part && t->sum && t->par) {
+            double p10 = 1.0;
+            for (int d = 0, i = 0; d <= DECADES; d++, p10 *= 10)
+                for (int m = 0; m < series && i < n; m++, i++)
+                    t->part[i] = eseries_mantissa(series, m) * p10 / 100.0;
+
+            size_t k = 0;
+            for (int a = 0; a < n; a++)
+                for (int b = a; b < n; b++, k++) {
+                    t->sum[k] = (pair_t){ t->part[a] + t->part[b], a, b };
+                    t->par[k] = (pair_t){ par2(t->part[a], t->part[b]), a, b };
+                }
+            qsort(t->sum, n_pairs, sizeof(pair_t), cmp_pair);
+            qsort(t->par, n_pairs, sizeof(pair_t), cmp_pair);
+            t->n_parts = n;
+            t->n_pairs = n_pairs;
+            t->ready = 1;
+        } else {
+            free(t->part); free(t->sum); free(t->par);
+            t->part = NULL; t->sum = t->par = NULL;
+        }
+    }
+    pthread_mutex_unlock(&table_lock);
+    return t->ready ? t : NULL;
+}
+
+static size_t lower_bound(const pair_t *p, size_t n, double v) {
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (p[mid].v < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* ────────────────────────────────────────────────
+   TOP-K CANDIDATE LISTS
+   Ordered by |error|, then fewer parts, then shape
+   and part indices, so results never depend on the
+   thread count.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    double abs_err;
+    int topology, n_parts;
+    int idx[3];                 /* canonical: interchangeable parts sorted */
+    double value;
+} cand_t;
+
+static int cmp_cand(const cand_t *x, const cand_t *y) {
+    if (x->abs_err != y->abs_err) return x->abs_err < y->abs_err ? -1 : 1;
+    if (x->n_parts != y->n_parts) return x->n_parts - y->n_parts;
+    if (x->topology != y->topology) return x->topology - y->topology;
+    for (int i = 0; i < 3; i++)
+        if (x->idx[i] != y->idx[i]) return x->idx[i] - y->idx[i];
+    return 0;
+}
+
+static void keep(cand_t *list, int *len, int k, const cand_t *c) {
+    if (*len == k && cmp_cand(c, &list[k - 1]) >= 0) return;
+    int pos = *len;
+    for (int i = 0; i < *len; i++) {
+        int r = cmp_cand(c, &list[i]);
+        if (r == 0) return;                             /* same combination */
+        if (r < 0 && pos == *len) pos = i;
+    }
+    int n = *len < k ? *len : k - 1;
+    memmove(&list[pos + 1], &list[pos], (n - pos) * sizeof(cand_t));
+    list[pos] = *c;
+    if (*len < k) (*len)++;
+}
+
+static void offer(cand_t *list, int *len, int k, double target, double value,
+                  int topology, int n_parts, int i0, int i1, int i2) {
+    cand_t c = { fabs(value - target) / target, topology, n_parts, { i0, i1, i2 }, value };
+    if (*len == k && c.abs_err > list[k - 1].abs_err) return;
+    if (topology == COMBO_SERIES3 || topology == COMBO_PARALLEL3) {
+        /* i0 <= i1 already; insert i2 */
+        if (c.idx[2] < c.idx[1]) { c.idx[2] = c.idx[1]; c.idx[1] = i2; }
+        if (c.idx[1] < c.idx[0]) { c.idx[1] = c.idx[0]; c.idx[0] = i2; }
+    }
+    keep(list, len, k, &c);
+}
+
+/* Offer the pairs nearest to 'want' (k each side), each combined with
+   part c (or used alone when c < 0) */
+static void scan_pairs(const table_t *t, const pair_t *pairs, double want, int c,
+                       int topology, int n_parts, double target,
+                       cand_t *list, int *len, int k) {
+    size_t pos = lower_bound(pairs, t->n_pairs, want);
+    size_t lo = pos > (size_t)k ? pos - k : 0;
+    size_t hi = pos + k < t->n_pairs ? pos + k : t->n_pairs;
+    for (size_t j = lo; j < hi; j++) {
+        double v = pairs[j].v;
+        switch (topology) {
+            case COMBO_SERIES3:   v += t->part[c]; break;
+            case COMBO_PS:        v += t->part[c]; break;
+            case COMBO_PARALLEL3:
+            case COMBO_SP:        v = par2(v, t->part[c]); break;
+            default: break;
+        }
+        offer(list, len, k, target, v, topology, n_parts, pairs[j].a, pairs[j].b, c < 0 ? -1 : c);
+    }
+}
+
+/* ────────────────────────────────────────────────
+   SEARCH
+   Meet in the middle: every 3-part shape is a pair
+   plus one part, so for each third part the best
+   pair is a binary search away.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    const table_t *t;
+    double target;
+    int k, n_tasks;
+    cand_t *lists;              /* n_tasks * k */
+    int *lens;
+} search_job_t;
+
+static void search_task(void *ctx, int task) {
+    search_job_t *job = ctx;
+    const table_t *t = job->t;
+    double T = job->target;
+    int k = job->k;
+    cand_t *list = job->lists + (size_t)task * k;
+    int *len = &job->lens[task];
+    int c0 = (int)((long)t->n_parts * task / job->n_tasks);
+    int c1 = (int)((long)t->n_parts * (task + 1) / job->n_tasks);
+
+    for (int c = c0; c < c1; c++) {
+        double r = t->part[c];
+        if (r < T) {
+            scan_pairs(t, t->sum, T - r, c, COMBO_SERIES3, 3, T, list, len, k);
+            scan_pairs(t, t->par, T - r, c, COMBO_PS, 3, T, list, len, k);
+        } else if (r > T) {
+            double want = 1.0 / (1.0 / T - 1.0 / r);
+            scan_pairs(t, t->par, want, c, COMBO_PARALLEL3, 3, T, list, len, k);
+            scan_pairs(t, t->sum, want, c, COMBO_SP, 3, T, list, len, k);
+        }
+    }
+}
+
+int eseries_best(int series, double target, int max_parts, int k, eseries_combo_t *out) {
+    if (!eseries_count(series) || !(target > 0.0) || isinf(target) ||
+        max_parts < 1 || max_parts > 3 || k < 1 || k > MAX_K)
+        return -1;
+
+    const table_t *t = get_table(series);
+    if (!t) return -1;
+
+    int n_tasks = max_parts == 3 ? par_threads() * 4 : 0;
+    if (n_tasks > t->n_parts) n_tasks = t->n_parts;
+
+    cand_t *lists = malloc((size_t)(n_tasks + 1) * k * sizeof(cand_t));
+    int *lens = calloc(n_tasks + 1, sizeof(int));
+    if (!lists || !lens) { free(lists); free(lens); return -1; }
+
+    /* Singles and pairs */
+    cand_t *best = lists + (size_t)n_tasks * k;
+    int n_best = 0;
+    int lo = 0, hi = t->n_parts;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (t->part[mid] < target) lo = mid + 1;
+        else hi = mid;
+    }
+    for (int i = lo > k ? lo - k : 0; i < lo + k && i < t->n_parts; i++)
+        offer(best, &n_best, k, target, t->part[i], COMBO_SINGLE, 1, i, -1, -1);
+    if (max_parts >= 2) {
+        scan_pairs(t, t->sum, target, -1, COMBO_SERIES2, 2, target, best, &n_best, k);
+        scan_pairs(t, t->par, target, -1, COMBO_PARALLEL2, 2, target, best, &n_best, k);
+    }
+
+    if (n_tasks > 0) {
+        search_job_t job = { t, target, k, n_tasks, lists, lens };
+        par_for(n_tasks, search_task, &job);
+        for (int task = 0; task < n_tasks; task++)
+            for (int i = 0; i < lens[task]; i++)
+                keep(best, &n_best, k, &lists[(size_t)task * k + i]);
+    }
+
+    for (int i = 0; i < n_best; i++) {
+        const cand_t *c = &best[i];
+        out[i].topology = c->topology;
+        out[i].n_parts = c->n_parts;
+        for (int p = 0; p < 3; p++)
+            out[i].parts[p] = p < c->n_parts ? t->part[c->idx[p]] : 0.0;
+        out[i].value = c->value;
+        out[i].error = (c->value - target) / target;
+    }
+    free(lists);
+    free(lens);
+    return n_best;
+}
+
+size_t eseries_format(const eseries_combo_t *c, char *buf, size_t cap) {
+    static const char *const shapes[] = {
+        "%s", "%s + %s", "%s || %s", "%s + %s + %s",
+        "%s || %s || %s", "(%s + %s) || %s", "(%s || %s) + %s"
+    };
+    char v[3][PREFIX_FMT_MAX + 8];
+    for (int i = 0; i < 3; i++) {
+        v[i][0] = '\0';
+        if (i < c->n_parts) format_with_prefix(v[i], sizeof(v[i]), c->parts[i], "Ω");
+    }
+    int n = snprintf(buf, cap, shapes[c->topology], v[0], v[1], v[2]);
+    return n < 0 ? 0 : (size_t)n < cap ? (size_t)n : cap ? cap - 1 : 0;
+}
@@ -0,0 +1,36 @@
+#ifndef ESERIES_H
+#define ESERIES_H
+
+#include <stddef.h>
+
+/* IEC 60063 preferred-value series: 12, 24, 96 or 192 values per decade */
+
+int eseries_count(int series);                  /* 0 for an unsupported series */
+int eseries_mantissa(int series, int index);    /* 3 digits, e.g. 470 for 4.7 */
+
+/* Combination shapes, R1..R3 = parts[0..2] */
+#define COMBO_SINGLE      0     /* R1                */
+#define COMBO_SERIES2     1     /* R1 + R2           */
+#define COMBO_PARALLEL2   2     /* R1 || R2          */
+#define COMBO_SERIES3     3     /* R1 + R2 + R3      */
+#define COMBO_PARALLEL3   4     /* R1 || R2 || R3    */
+#define COMBO_SP          5     /* (R1 + R2) || R3   */
+#define COMBO_PS          6     /* (R1 || R2) + R3   */
+
+typedef struct {
+    int topology;               /* COMBO_* */
+    int n_parts;
+    double parts[3];
+    double value;
+    double error;               /* (value - target) / target */
+} eseries_combo_t;
+
+/* The k combinations of up to max_parts (1-3) standard resistors from
+   1 Ω to 10 MΩ that come closest to target, best first. Returns the
+   number written to out, or -1 for bad arguments. */
+int eseries_best(int series, double target, int max_parts, int k, eseries_combo_t *out);
+
+/* "(4.7 kΩ + 1 kΩ) || 10 kΩ" */
+size_t eseries_format(const eseries_combo_t *c, char *buf, size_t cap);
+
+#endif
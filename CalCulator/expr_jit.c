@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "expr_jit.h"
+
+/* System V calling convention and mmap: not Windows */
+#if defined(__x86_64__) && !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#define JIT_X86_64 1
+#endif
+
+#define JIT_MAX_DEPTH 16        /* xmm0 .. xmm15 */
+#define JIT_MAX_TEMPS 64
+#define JIT_MAX_WIDTH 4
+#define JIT_MAX_VARS  256
+
+typedef double (*jit_scalar_fn)(const double *vars, double *temps);
+typedef void (*jit_packed_fn)(const double *const *columns, double *out, size_t n_bytes, double *temps);
+
+struct expr_jit {
+    const expr_program_t *prog;
+    unsigned char *mem;         /* NULL: interpreter */
+    size_t mem_size;
+    jit_scalar_fn scalar;
+    jit_packed_fn packed;
+    int width;
+};
+
+static int jit_enabled = 1;
+
+void expr_jit_set_enabled(int on) { jit_enabled = on; }
+
+#ifdef JIT_X86_64
+
+/* ────────────────────────────────────────────────
+   X86-64 ENCODER
+   Just the instructions the code generator needs.
+   Memory operands are [base + index + disp32] or
+   RIP-relative; the buffer counts bytes past its
+   end so overflow is caught once at the end.
+   ──────────────────────────────────────────────── */
+
+enum { RAX = 0, RCX = 1, RDX = 2, RSI = 6, RDI = 7, R8 = 8 };
+#define RIP      (-1)
+#define NO_INDEX (-1)
+
+typedef struct {
+    unsigned char *p;
+    size_t n, cap;
+} jit_buf_t;
+
+static void put(jit_buf_t *b, unsigned x) {
+    if (b->n < b->cap) b->p[b->n] = (unsigned char)x;
+    b->n++;
+}
+
+static void put32(jit_buf_t *b, int32_t x) {
+    for (int i = 0; i < 4; i++) put(b, (uint32_t)x >> (8 * i) & 0xFF);
+}
+
+/* fill: 0xCC (int3) between functions, 0x90 (nop) where execution runs through */
+static void align16(jit_buf_t *b, unsigned fill) {
+    while (b->n & 15) put(b, fill);
+}
+
+/* REX.R / REX.X / REX.B for a register and a memory operand */
+static int rex_bits(int reg, int base, int index) {
+    return (reg >> 3) << 2 | (index >= 0 ? index >> 3 : 0) << 1 | (base >= 0 ? base >> 3 : 0);
+}
+
+/* ModRM [SIB] disp32; for RIP, disp is the buffer offset of the target */
+static void modrm_mem(jit_buf_t *b, int reg, int base, int index, int32_t disp) {
+    if (base == RIP) {
+        put(b, (reg & 7) << 3 | 5);
+        put32(b, disp - (int32_t)(b->n + 4));
+    } else if (index == NO_INDEX) {
+        put(b, 0x80 | (reg & 7) << 3 | (base & 7));
+        put32(b, disp);
+    } else {
+        put(b, 0x80 | (reg & 7) << 3 | 4);
+        put(b, (index & 7) << 3 | (base & 7));
+        put32(b, disp);
+    }
+}
+
+/* Legacy SSE: prefix (F2 scalar, 66 packed) 0F op */
+static void sse_mem(jit_buf_t *b, int prefix, int op, int reg, int base, int index, int32_t disp) {
+    int rex = rex_bits(reg, base, index);
+    put(b, prefix);
+    if (rex) put(b, 0x40 | rex);
+    put(b, 0x0F);
+    put(b, op);
+    modrm_mem(b, reg, base, index, disp);
+}
+
+static void sse_rr(jit_buf_t *b, int prefix, int op, int reg, int rm) {
+    int rex = (reg >> 3) << 2 | rm >> 3;
+    put(b, prefix);
+    if (rex) put(b, 0x40 | rex);
+    put(b, 0x0F);
+    put(b, op);
+    put(b, 0xC0 | (reg & 7) << 3 | (rm & 7));
+}
+
+/* Three-byte VEX, 256-bit, 66 prefix; map 1 = 0F, 2 = 0F38 */
+static void vex256(jit_buf_t *b, int map, int reg, int vvvv, int x, int bb) {
+    put(b, 0xC4);
+    put(b, !(reg >> 3) << 7 | !x << 6 | !bb << 5 | map);
+    put(b, (~vvvv & 15) << 3 | 1 << 2 | 1);
+}
+
+static void avx_mem(jit_buf_t *b, int map, int op, int reg, int base, int index, int32_t disp) {
+    vex256(b, map, reg, 0, index >= 0 ? index >> 3 : 0, base >= 0 ? base >> 3 : 0);
+    put(b, op);
+    modrm_mem(b, reg, base, index, disp);
+}
+
+static void avx_rrr(jit_buf_t *b, int op, int reg, int src1, int src2) {
+    vex256(b, 1, reg, src1, 0, src2 >> 3);
+    put(b, op);
+    put(b, 0xC0 | (reg & 7) << 3 | (src2 & 7));
+}
+
+/* mov r64, [base + disp32] */
+static void mov_load64(jit_buf_t *b, int reg, int base, int32_t disp) {
+    put(b, 0x48 | rex_bits(reg, base, NO_INDEX));
+    put(b, 0x8B);
+    modrm_mem(b, reg, base, NO_INDEX, disp);
+}
+
+#define SSE_SD     0xF2
+#define SSE_PD     0x66
+#define OP_LOAD    0x10         /* movsd / movupd xmm, m */
+#define OP_STORE   0x11         /* movsd / movupd m, xmm */
+#define OP_BCAST   0x19         /* vbroadcastsd (0F38) */
+
+static int arith_opcode(int op) {
+    switch (op) {
+        case EXPR_OP_ADD: return 0x58;
+        case EXPR_OP_SUB: return 0x5C;
+        case EXPR_OP_MUL: return 0x59;
+        default:          return 0x5E;
+    }
+}
+
+/* ────────────────────────────────────────────────
+   CODE GENERATION
+   Stack depth d lives in xmm d (ymm d for AVX).
+   Buffer layout: constant pool (each constant
+   twice, 16 bytes, so SSE2 can load it packed),
+   the scalar function, the packed loop.
+   ──────────────────────────────────────────────── */
+
+/* double f(const double *vars, double *temps) */
+static void gen_scalar(jit_buf_t *b, const expr_program_t *prog) {
+    int top = -1;
+    for (int i = 0; i < prog->n_code; i++) {
+        const expr_insn_t *in = &prog->code[i];
+        switch (in->op) {
+            case EXPR_OP_CONST: sse_mem(b, SSE_SD, OP_LOAD, ++top, RIP, NO_INDEX, 16 * in->arg); break;
+            case EXPR_OP_VAR:   sse_mem(b, SSE_SD, OP_LOAD, ++top, RDI, NO_INDEX, 8 * in->arg); break;
+            case EXPR_OP_LOAD:  sse_mem(b, SSE_SD, OP_LOAD, ++top, RSI, NO_INDEX, 8 * in->arg); break;
+            case EXPR_OP_STORE: sse_mem(b, SSE_SD, OP_STORE, top, RSI, NO_INDEX, 8 * in->arg); break;
+            default:
+                top--;
+                sse_rr(b, SSE_SD, arith_opcode(in->op), top, top + 1);
+        }
+    }
+    put(b, 0xC3);                       /* ret */
+}
+
+/* void f(const double *const *columns, double *out, size_t n_bytes, double *temps)
+   n_bytes is rows * 8, a non-zero multiple of the width */
+static void gen_packed(jit_buf_t *b, const expr_program_t *prog, int avx) {
+    int step = avx ? 32 : 16;
+
+    put(b, 0x45); put(b, 0x31); put(b, 0xC0);          /* xor r8d, r8d */
+    align16(b, 0x90);
+    size_t loop = b->n;
+    int top = -1;
+    for (int i = 0; i < prog->n_code; i++) {
+        const expr_insn_t *in = &prog->code[i];
+        switch (in->op) {
+            case EXPR_OP_CONST:
+                ++top;
+                if (avx) avx_mem(b, 2, OP_BCAST, top, RIP, NO_INDEX, 16 * in->arg);
+                else     sse_mem(b, SSE_PD, OP_LOAD, top, RIP, NO_INDEX, 16 * in->arg);
+                break;
+            case EXPR_OP_VAR:
+                ++top;
+                mov_load64(b, RAX, RDI, 8 * in->arg);
+                if (avx) avx_mem(b, 1, OP_LOAD, top, RAX, R8, 0);
+                else     sse_mem(b, SSE_PD, OP_LOAD, top, RAX, R8, 0);
+                break;
+            case EXPR_OP_LOAD:
+                ++top;
+                if (avx) avx_mem(b, 1, OP_LOAD, top, RCX, NO_INDEX, step * in->arg);
+                else     sse_mem(b, SSE_PD, OP_LOAD, top, RCX, NO_INDEX, step * in->arg);
+                break;
+            case EXPR_OP_STORE:
+                if (avx) avx_mem(b, 1, OP_STORE, top, RCX, NO_INDEX, step * in->arg);
+                else     sse_mem(b, SSE_PD, OP_STORE, top, RCX, NO_INDEX, step * in->arg);
+                break;
+            default:
+                top--;
+                if (avx) avx_rrr(b, arith_opcode(in->op), top, top, top + 1);
+                else     sse_rr(b, SSE_PD, arith_opcode(in->op), top, top + 1);
+        }
+    }
+    if (avx) avx_mem(b, 1, OP_STORE, 0, RSI, R8, 0);   /* out[row..] = slot 0 */
+    else     sse_mem(b, SSE_PD, OP_STORE, 0, RSI, R8, 0);
+
+    put(b, 0x49); put(b, 0x83); put(b, 0xC0); put(b, step);    /* add r8, step */
+    put(b, 0x49); put(b, 0x39); put(b, 0xD0);                  /* cmp r8, rdx */
+    put(b, 0x0F); put(b, 0x82);                                /* jb loop */
+    put32(b, (int32_t)(loop - (b->n + 4)));
+    if (avx) { put(b, 0xC5); put(b, 0xF8); put(b, 0x77); }    /* vzeroupper */
+    put(b, 0xC3);
+}
+
+static int jit_generate(expr_jit_t *j) {
+    const expr_program_t *prog = j->prog;
+    if (prog->max_depth > JIT_MAX_DEPTH || prog->n_temps > JIT_MAX_TEMPS || prog->n_vars > JIT_MAX_VARS)
+        return 1;
+
+    int avx = __builtin_cpu_supports("avx");
+    long page = sysconf(_SC_PAGESIZE);
+    size_t need = 16 * (size_t)prog->n_consts + 2 * 24 * (size_t)prog->n_code + 128;
+    size_t size = (need + page - 1) / page * page;
+    unsigned char *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return 1;
+
+    jit_buf_t b = { mem, 0, size };
+    for (int k = 0; k < prog->n_consts; k++) {
+        memcpy(mem + 16 * k, &prog->consts[k], 8);
+        memcpy(mem + 16 * k + 8, &prog->consts[k], 8);
+    }
+    b.n = 16 * (size_t)prog->n_consts;
+    size_t scalar_at = b.n;
+    gen_scalar(&b, prog);
+    align16(&b, 0xCC);
+    size_t packed_at = b.n;
+    gen_packed(&b, prog, avx);
+
+    /* Write, then execute: the buffer is never writable and executable */
+    if (b.n > size || mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(mem, size);
+        return 1;
+    }
+    j->mem = mem;
+    j->mem_size = size;
+    j->scalar = (jit_scalar_fn)(void *)(mem + scalar_at);
+    j->packed = (jit_packed_fn)(void *)(mem + packed_at);
+    j->width = avx ? 4 : 2;
+    return 0;
+}
+
+#endif
+
+/* ────────────────────────────────────────────────
+   PUBLIC API
+   ──────────────────────────────────────────────── */
+
+expr_jit_t *expr_jit_compile(const expr_program_t *prog) {
+    expr_jit_t *j = calloc(1, sizeof *j);
+    if (!j) return NULL;
+    j->prog = prog;
+#ifdef JIT_X86_64
+    if (jit_enabled) jit_generate(j);
+#endif
+    return j;
+}
+
+double expr_jit_eval(const expr_jit_t *j, const double *vars) {
+    if (!j->mem) return expr_eval(j->prog, vars);
+    double temps[JIT_MAX_TEMPS];
+    return j->scalar(vars, temps);
+}
+
+void expr_jit_eval_batch(const expr_jit_t *j, const double *const *columns, size_t n_rows, double *out) {
+    if (!j->mem) {
+        expr_eval_batch(j->prog, columns, n_rows, out);
+        return;
+    }
+    double temps[JIT_MAX_TEMPS * JIT_MAX_WIDTH];
+    size_t full = n_rows - n_rows % j->width;
+    if (full) j->packed(columns, out, full * sizeof(double), temps);
+
+    /* Leftover rows, one at a time */
+    const int nv = j->prog->n_vars;
+    double vars[JIT_MAX_VARS];
+    for (size_t r = full; r < n_rows; r++) {
+        for (int v = 0; v < nv; v++) vars[v] = columns[v][r];
+        out[r] = j->scalar(vars, temps);
+    }
+}
+
+int expr_jit_width(const expr_jit_t *j) {
+    return j->mem ? j->width : 0;
+}
+
+void expr_jit_free(expr_jit_t *j) {
+    if (!j) return;
+#ifdef JIT_X86_64
+    if (j->mem) munmap(j->mem, j->mem_size);
+#endif
+    free(j);
+}
@@ -0,0 +1,33 @@
+#ifndef EXPR_JIT_H
+#define EXPR_JIT_H
+
+#include <stddef.h>
+#include "expression_eval.h"
+
+/* Native code for compiled expressions on x86-64: each program becomes a
+   scalar SSE2 function and a packed loop (4 rows per step with AVX, 2
+   with SSE2), written into an mmap'd buffer that is then made executable.
+   The stack slots of the bytecode map onto the 16 vector registers and
+   every operator is the same IEEE add / sub / mul / div the interpreter
+   does, in the same order, so the results are bit-identical. */
+
+typedef struct expr_jit expr_jit_t;
+
+/* Never NULL unless out of memory. When native code cannot be made
+   (another CPU, no executable memory, a program deeper than 16 slots,
+   or JIT switched off) the handle evaluates with the interpreter.
+   prog must outlive the handle. */
+expr_jit_t *expr_jit_compile(const expr_program_t *prog);
+
+/* Same contracts as expr_eval() and expr_eval_batch() */
+double expr_jit_eval(const expr_jit_t *j, const double *vars);
+void expr_jit_eval_batch(const expr_jit_t *j, const double *const *columns, size_t n_rows, double *out);
+void expr_jit_free(expr_jit_t *j);
+
+/* Rows per packed step: 4 (AVX), 2 (SSE2), or 0 when interpreting */
+int expr_jit_width(const expr_jit_t *j);
+
+/* Process-wide switch (--no-jit); affects later expr_jit_compile() calls */
+void expr_jit_set_enabled(int on);
+
+#endif
@@ -1,163 +1,957 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include <math.h>
-
-#include "math_ops.h"          // for parse_with_prefix()
-#include "expression_eval.h"
-
-/* -----------------------------------------------
-   TOKENIZER
-   ----------------------------------------------- */
-
-#define MAX_TOKENS 256
-#define MAX_LEN    32
-
-int is_operator(char c) {
-    return (c == '+' || c == '-' || c == '*' || c == '/');
-}
-
-int precedence(char op) {
-    if (op == '+' || op == '-') return 1;
-    if (op == '*' || op == '/') return 2;
-    return 0;
-}
-
-/* -----------------------------------------------
-   Convert infix → postfix (Shunting Yard Algorithm)
-   ----------------------------------------------- */
-
-int infix_to_postfix(const char *expr, char postfix[][MAX_LEN]) {
-    char opstack[128];
-    int top = -1;
-    int p = 0;
-
-    for (int i = 0; expr[i]; ) {
-
-        if (isspace(expr[i])) { i++; continue; }
-
-        /* NUMBER / PREFIX TOKEN */
-        if (isdigit(expr[i]) || expr[i] == '.') {
-            int j = 0;
-            while (isdigit(expr[i]) || expr[i]=='.' || isalpha(expr[i])) {
-                postfix[p][j++] = expr[i++];
-            }
-            postfix[p][j] = '\0';
-            p++;
-        }
-
-        /* LEFT PAREN */
-        else if (expr[i] == '(') {
-            opstack[++top] = expr[i];
-            i++;
-        }
-
-        /* RIGHT PAREN */
-        else if (expr[i] == ')') {
-            while (top >= 0 && opstack[top] != '(') {
-                postfix[p][0] = opstack[top--];
-                postfix[p][1] = '\0';
-                p++;
-            }
-            if (top >= 0 && opstack[top] == '(') top--;
-            i++;
-        }
-
-        /* OPERATOR */
-        else if (is_operator(expr[i])) {
-            char op = expr[i];
-            while (top >= 0 && is_operator(opstack[top]) &&
-                   precedence(opstack[top]) >= precedence(op)) {
-                postfix[p][0] = opstack[top--];
-                postfix[p][1] = '\0';
-                p++;
-            }
-            opstack[++top] = op;
-            i++;
-        }
-
-        else {
-            printf("Invalid character in expression.\n");
-            return 0;
-        }
-    }
-
-    /* POP REMAINING OPERATORS */
-    while (top >= 0) {
-        postfix[p][0] = opstack[top--];
-        postfix[p][1] = '\0';
-        p++;
-    }
-
-    return p;
-}
-
-/* -----------------------------------------------
-   Evaluate postfix expression
-   ----------------------------------------------- */
-
-double eval_postfix(char postfix[][MAX_LEN], int count) {
-    double stack[256];
-    int top = -1;
-
-    for (int i = 0; i < count; i++) {
-        char *t = postfix[i];
-
-        if (is_operator(t[0]) && strlen(t) == 1) {
-            // operator
-            double b = stack[top--];
-            double a = stack[top--];
-
-            switch (t[0]) {
-                case '+': stack[++top] = a + b; break;
-                case '-': stack[++top] = a - b; break;
-                case '*': stack[++top] = a * b; break;
-                case '/': stack[++top] = a / b; break;
-            }
-        } 
-        else {
-            // number with prefix
-            double val = parse_with_prefix(t);
-            stack[++top] = val;
-        }
-    }
-
-    return stack[top];
-}
-
-/* -----------------------------------------------
-   Main API
-   ----------------------------------------------- */
-
-double evaluate_expression(const char *expr) {
-    char postfix[MAX_TOKENS][MAX_LEN];
-    int count = infix_to_postfix(expr, postfix);
-    return eval_postfix(postfix, count);
-}
-
-/* -----------------------------------------------
-   USER MENU
-   ----------------------------------------------- */
-
-void expression_menu(void) {
-    char expr[256];
-
-    printf("\n==== EXPRESSION EVALUATOR ====\n");
-    printf("Supports: +  -  *  /  ( )  and prefixes like k,m,u,n,p\n");
-    printf("Example: ((45k*33)+(22-21)/((45k-44k)*(23m+44k)))\n\n");
-
-    printf("Enter expression: ");
-    getchar();  // clear leftover newline
-    fgets(expr, sizeof(expr), stdin);
-
-    // Remove trailing newline
-    expr[strcspn(expr, "\n")] = 0;
-
-    double result = evaluate_expression(expr);
-
-    printf("\nResult = %.10g\n", result);
-
-    printf("Engineering Notation: ");
-    print_with_prefix(result, "");
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "math_ops.h"          // for parse_prefix_n()
+#include "expression_eval.h"
+
+/* -----------------------------------------------
+   TOKENIZER
+   ----------------------------------------------- */
+
+#define MAX_TOKENS 256
+#define MAX_LEN    32
+
+/* Errors are printed for the interactive menus; batch callers switch
+   that off per thread and read expr_last_error() instead. */
+static _Thread_local char expr_errbuf[96];
+static _Thread_local int expr_quiet;
+
+static void expr_fail(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(expr_errbuf, sizeof(expr_errbuf), fmt, ap);
+    va_end(ap);
+    if (!expr_quiet) printf("%s\n", expr_errbuf);
+}
+
+void expr_set_quiet(int quiet) { expr_quiet = quiet; }
+const char *expr_last_error(void) { return expr_errbuf; }
+
+int is_operator(char c) {
+    return (c == '+' || c == '-' || c == '*' || c == '/');
+}
+
+int precedence(char op) {
+    if (op == '+' || op == '-') return 1;
+    if (op == '*' || op == '/') return 2;
+    return 0;
+}
+
+/* -----------------------------------------------
+   Convert infix → postfix (Shunting Yard Algorithm)
+   ----------------------------------------------- */
+
+int infix_to_postfix(const char *expr, char postfix[][MAX_LEN]) {
+    char opstack[128];
+    int top = -1;
+    int p = 0;
+
+    for (int i = 0; expr[i]; ) {
+
+        if (isspace(expr[i])) { i++; continue; }
+
+        /* NUMBER / PREFIX TOKEN */
+        if (isdigit(expr[i]) || expr[i] == '.') {
+            int j = 0;
+            if (p >= MAX_TOKENS) { expr_fail("Expression too long."); return 0; }
+            while (isdigit(expr[i]) || expr[i]=='.' || isalpha(expr[i])) {
+                if (j >= MAX_LEN - 1) { expr_fail("Number too long."); return 0; }
+                postfix[p][j++] = expr[i++];
+            }
+            postfix[p][j] = '\0';
+            p++;
+        }
+
+        /* VARIABLE NAME (only meaningful to expr_compile_vars) */
+        else if (isalpha(expr[i]) || expr[i] == '_') {
+            int j = 0;
+            if (p >= MAX_TOKENS) { expr_fail("Expression too long."); return 0; }
+            while (isalnum(expr[i]) || expr[i] == '_') {
+                if (j >= MAX_LEN - 1) { expr_fail("Name too long."); return 0; }
+                postfix[p][j++] = expr[i++];
+            }
+            postfix[p][j] = '\0';
+            p++;
+        }
+
+        /* LEFT PAREN */
+        else if (expr[i] == '(') {
+            if (top >= (int)sizeof(opstack) - 1) { expr_fail("Expression too long."); return 0; }
+            opstack[++top] = expr[i];
+            i++;
+        }
+
+        /* RIGHT PAREN */
+        else if (expr[i] == ')') {
+            while (top >= 0 && opstack[top] != '(') {
+                if (p >= MAX_TOKENS) { expr_fail("Expression too long."); return 0; }
+                postfix[p][0] = opstack[top--];
+                postfix[p][1] = '\0';
+                p++;
+            }
+            if (top < 0) { expr_fail("Malformed expression: unbalanced parentheses."); return 0; }
+            top--;
+            i++;
+        }
+
+        /* OPERATOR */
+        else if (is_operator(expr[i])) {
+            char op = expr[i];
+            while (top >= 0 && is_operator(opstack[top]) &&
+                   precedence(opstack[top]) >= precedence(op)) {
+                if (p >= MAX_TOKENS) { expr_fail("Expression too long."); return 0; }
+                postfix[p][0] = opstack[top--];
+                postfix[p][1] = '\0';
+                p++;
+            }
+            if (top >= (int)sizeof(opstack) - 1) { expr_fail("Expression too long."); return 0; }
+            opstack[++top] = op;
+            i++;
+        }
+
+        else {
+            expr_fail("Invalid character in expression.");
+            return 0;
+        }
+    }
+
+    /* POP REMAINING OPERATORS */
+    while (top >= 0) {
+        if (p >= MAX_TOKENS) { expr_fail("Expression too long."); return 0; }
+        postfix[p][0] = opstack[top--];
+        postfix[p][1] = '\0';
+        p++;
+    }
+
+    return p;
+}
+
+/* -----------------------------------------------
+   Evaluate postfix expression
+   Every stack entry is a dual number: the value
+   and its partial derivatives with respect to the
+   named inputs, carried through each operator by
+   the sum, product and quotient rules. With no
+   names this is plain evaluation.
+   ----------------------------------------------- */
+
+#define GRAD_LOCAL 2048     /* gradient slots kept on the C stack */
+
+static int find_var(const char *name, const char *const *vars, int n_vars) {
+    for (int v = 0; v < n_vars; v++)
+        if (strcmp(name, vars[v]) == 0) return v;
+    return -1;
+}
+
+static double eval_postfix_dual(char postfix[][MAX_LEN], int count, const char *const *vars,
+                                const double *values, int n_vars, double *grad) {
+    double stack[MAX_TOKENS];
+    double local[GRAD_LOCAL];
+    double *g = local;          /* g + k * n_vars: gradient of stack[k] */
+    int top = -1;
+
+    if ((size_t)count * n_vars > GRAD_LOCAL) {
+        g = malloc((size_t)count * n_vars * sizeof(double));
+        if (!g) { expr_fail("Error: out of memory"); return NAN; }
+    }
+
+    for (int i = 0; i < count; i++) {
+        char *t = postfix[i];
+
+        if (is_operator(t[0]) && strlen(t) == 1) {
+            // operator
+            if (top < 1) {
+                expr_fail("Malformed expression: operator '%c' is missing an operand.", t[0]);
+                top = -1;
+                break;
+            }
+            double b = stack[top--];
+            double a = stack[top--];
+            double *ga = g + (size_t)(top + 1) * n_vars;
+            const double *gb = ga + n_vars;
+
+            switch (t[0]) {
+                case '+':
+                    for (int v = 0; v < n_vars; v++) ga[v] += gb[v];
+                    stack[++top] = a + b;
+                    break;
+                case '-':
+                    for (int v = 0; v < n_vars; v++) ga[v] -= gb[v];
+                    stack[++top] = a - b;
+                    break;
+                case '*':
+                    for (int v = 0; v < n_vars; v++) ga[v] = a * gb[v] + b * ga[v];
+                    stack[++top] = a * b;
+                    break;
+                case '/': {
+                    double q = a / b;       /* d(a/b) = (da - q*db) / b */
+                    for (int v = 0; v < n_vars; v++) ga[v] = (ga[v] - q * gb[v]) / b;
+                    stack[++top] = q;
+                    break;
+                }
+            }
+        } 
+        else if (t[0] == '(') {
+            expr_fail("Malformed expression: unbalanced parentheses.");
+            top = -1;
+            break;
+        }
+        else {
+            // input name, or number with prefix
+            int v = (isalpha(t[0]) || t[0] == '_') ? find_var(t, vars, n_vars) : -1;
+            if (v < 0 && (isalpha(t[0]) || t[0] == '_')) {
+                expr_fail("Unknown variable '%s'.", t);
+                top = -1;
+                break;
+            }
+            double *gv = g + (size_t)(top + 1) * n_vars;
+            for (int w = 0; w < n_vars; w++) gv[w] = 0;
+            if (v >= 0) gv[v] = 1;
+            stack[++top] = v >= 0 ? values[v] : parse_prefix_n(t, strlen(t), NULL);
+        }
+    }
+
+    if (top > 0) {
+        expr_fail("Malformed expression: missing operator.");
+        top = -1;
+    }
+    double result = top >= 0 ? stack[top] : NAN;
+    if (grad)
+        for (int v = 0; v < n_vars; v++) grad[v] = top >= 0 ? g[(size_t)top * n_vars + v] : NAN;
+    if (g != local) free(g);
+    return result;
+}
+
+double eval_postfix(char postfix[][MAX_LEN], int count) {
+    return eval_postfix_dual(postfix, count, NULL, NULL, 0, NULL);
+}
+
+/* -----------------------------------------------
+   Main API
+   ----------------------------------------------- */
+
+double evaluate_expression(const char *expr) {
+    double result;
+    int quiet = expr_quiet;
+    expr_quiet = 1;
+    int rc = expr_cache_eval(expr, &result);
+    expr_quiet = quiet;
+    if (rc == 0) return result;
+
+    /* Malformed (or no memory to compile it): say why, never guess a value */
+    if (!quiet) printf("%s\n", expr_errbuf[0] ? expr_errbuf : "Error: out of memory");
+    return NAN;
+}
+
+double evaluate_expression_grad(const char *expr, const char *const *vars, const double *values,
+                                int n_vars, double *grad) {
+    char postfix[MAX_TOKENS][MAX_LEN];
+    int count = infix_to_postfix(expr, postfix);
+    return eval_postfix_dual(postfix, count, vars, values, n_vars, grad);
+}
+
+static double scalar_op(int op, double a, double b) {
+    switch (op) {
+        case EXPR_OP_ADD: return a + b;
+        case EXPR_OP_SUB: return a - b;
+        case EXPR_OP_MUL: return a * b;
+        default:          return a / b;
+    }
+}
+
+/* -----------------------------------------------
+   OPTIMIZER
+   The postfix tokens are first built into a DAG:
+     - identical subexpressions are hash-consed to
+       one node, computed once and kept in a temp
+     - operators on constants are folded
+     - x / c becomes x * (1/c) when c is a power of
+       two, where 1/c is exact
+   Every rewrite gives bit-identical results: no
+   reassociation, and folding does the same IEEE
+   operations the evaluator would have done.
+   ----------------------------------------------- */
+
+typedef struct {
+    unsigned char op;       /* expr_opcode_t: CONST, VAR or an operator */
+    int a, b;               /* operand nodes */
+    double value;           /* EXPR_OP_CONST */
+    int var;                /* EXPR_OP_VAR */
+    int uses;               /* parent edges, counted from the root */
+    int slot;               /* constant pool index or temp, -1 until emitted */
+} expr_node_t;
+
+/* Each token adds at most one node, and a folded or strength-reduced
+   operator at most two */
+#define MAX_NODES (2 * MAX_TOKENS)
+#define NODE_HASH 1024      /* power of two, above MAX_NODES */
+
+typedef struct {
+    expr_node_t node[MAX_NODES];
+    int n;
+    short hash[NODE_HASH];  /* node index + 1, 0 = empty */
+} expr_dag_t;
+
+static uint64_t node_hash(const expr_node_t *x) {
+    uint64_t bits;
+    memcpy(&bits, &x->value, sizeof bits);
+    uint64_t h = x->op * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (uint64_t)(unsigned)x->a) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (uint64_t)(unsigned)x->b) * 0x94D049BB133111EBull;
+    h = (h ^ bits ^ (uint64_t)(unsigned)x->var) * 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 31);
+}
+
+static int node_same(const expr_node_t *x, const expr_node_t *y) {
+    return x->op == y->op && x->a == y->a && x->b == y->b && x->var == y->var &&
+           memcmp(&x->value, &y->value, sizeof x->value) == 0;
+}
+
+/* Index of the node equal to *x, added if new */
+static int dag_intern(expr_dag_t *d, expr_node_t x) {
+    x.uses = 0;
+    x.slot = -1;
+    for (uint64_t h = node_hash(&x);; h++) {
+        short *e = &d->hash[h & (NODE_HASH - 1)];
+        if (*e == 0) {
+            d->node[d->n] = x;
+            *e = (short)(++d->n);
+            return d->n - 1;
+        }
+        if (node_same(&d->node[*e - 1], &x)) return *e - 1;
+    }
+}
+
+static int dag_const(expr_dag_t *d, double v) {
+    return dag_intern(d, (expr_node_t){ .op = EXPR_OP_CONST, .a = -1, .b = -1, .value = v, .var = -1 });
+}
+
+static int dag_binary(expr_dag_t *d, int op, int a, int b) {
+    const expr_node_t *na = &d->node[a], *nb = &d->node[b];
+    if (na->op == EXPR_OP_CONST && nb->op == EXPR_OP_CONST)
+        return dag_const(d, scalar_op(op, na->value, nb->value));
+    if (op == EXPR_OP_DIV && nb->op == EXPR_OP_CONST) {
+        int e;
+        double m = frexp(nb->value, &e), r = 1 / nb->value;
+        if (fabs(m) == 0.5 && isfinite(r) && r != 0) {
+            op = EXPR_OP_MUL;
+            b = dag_const(d, r);
+        }
+    }
+    return dag_intern(d, (expr_node_t){ .op = (unsigned char)op, .a = a, .b = b, .var = -1 });
+}
+
+static void dag_count_uses(expr_dag_t *d, int n, unsigned char *seen) {
+    if (seen[n]) return;
+    seen[n] = 1;
+    const expr_node_t *x = &d->node[n];
+    if (x->a < 0) return;
+    d->node[x->a].uses++;
+    d->node[x->b].uses++;
+    dag_count_uses(d, x->a, seen);
+    dag_count_uses(d, x->b, seen);
+}
+
+static void emit(expr_program_t *prog, expr_dag_t *d, int n, int *depth) {
+    expr_node_t *x = &d->node[n];
+    expr_insn_t *in;
+
+    if (x->op == EXPR_OP_CONST || x->op == EXPR_OP_VAR || x->slot >= 0) {
+        in = &prog->code[prog->n_code++];
+        if (x->op == EXPR_OP_VAR) {
+            in->op = EXPR_OP_VAR;
+            in->arg = (unsigned short)x->var;
+        } else if (x->op == EXPR_OP_CONST) {
+            if (x->slot < 0) {
+                x->slot = prog->n_consts;
+                prog->consts[prog->n_consts++] = x->value;
+            }
+            in->op = EXPR_OP_CONST;
+            in->arg = (unsigned short)x->slot;
+        } else {
+            in->op = EXPR_OP_LOAD;
+            in->arg = (unsigned short)x->slot;
+        }
+        if (++*depth > prog->max_depth) prog->max_depth = *depth;
+        return;
+    }
+
+    emit(prog, d, x->a, depth);
+    emit(prog, d, x->b, depth);
+    in = &prog->code[prog->n_code++];
+    in->op = x->op;
+    in->arg = 0;
+    --*depth;
+    if (x->uses > 1) {
+        x->slot = prog->n_temps;
+        in = &prog->code[prog->n_code++];
+        in->op = EXPR_OP_STORE;
+        in->arg = (unsigned short)prog->n_temps++;
+    }
+}
+
+/* -----------------------------------------------
+   COMPILED PROGRAMS
+   The Shunting-Yard output is lowered once into a
+   flat bytecode with the numbers already parsed, so
+   expr_run() does no string handling at all.
+   ----------------------------------------------- */
+
+expr_program_t *expr_compile(const char *expr) {
+    return expr_compile_vars(expr, NULL, 0);
+}
+
+expr_program_t *expr_compile_vars(const char *expr, const char *const *vars, int n_vars) {
+    char postfix[MAX_TOKENS][MAX_LEN];
+    expr_errbuf[0] = '\0';
+    int count = infix_to_postfix(expr, postfix);
+    if (count == 0) {
+        if (!expr_errbuf[0]) expr_fail("Empty expression.");
+        return NULL;
+    }
+
+    expr_dag_t *d = malloc(sizeof *d);
+    if (!d) return NULL;
+    memset(d->hash, 0, sizeof d->hash);
+    d->n = 0;
+    int stack[MAX_TOKENS], depth = 0;
+
+    for (int i = 0; i < count; i++) {
+        char *t = postfix[i];
+
+        if (is_operator(t[0]) && t[1] == '\0') {
+            if (depth < 2) {
+                expr_fail("Malformed expression: operator '%c' is missing an operand.", t[0]);
+                free(d);
+                return NULL;
+            }
+            int op = t[0] == '+' ? EXPR_OP_ADD : t[0] == '-' ? EXPR_OP_SUB : t[0] == '*' ? EXPR_OP_MUL : EXPR_OP_DIV;
+            depth--;
+            stack[depth - 1] = dag_binary(d, op, stack[depth - 1], stack[depth]);
+        }
+        else if (t[0] == '(') {
+            expr_fail("Malformed expression: unbalanced parentheses.");
+            free(d);
+            return NULL;
+        }
+        else if (isalpha(t[0]) || t[0] == '_') {
+            int v = find_var(t, vars, n_vars);
+            if (v < 0) {
+                expr_fail("Unknown variable '%s'.", t);
+                free(d);
+                return NULL;
+            }
+            stack[depth++] = dag_intern(d, (expr_node_t){ .op = EXPR_OP_VAR, .a = -1, .b = -1, .var = v });
+        }
+        else {
+            stack[depth++] = dag_const(d, parse_prefix_n(t, strlen(t), NULL));
+        }
+    }
+
+    if (depth != 1) {
+        expr_fail("Malformed expression: missing operator.");
+        free(d);
+        return NULL;
+    }
+
+    /* Every instruction comes from one postfix token, or is the STORE
+       of a shared node, so 2 * count bounds the code */
+    size_t size = sizeof(expr_program_t) + count * sizeof(double) + 2 * count * sizeof(expr_insn_t);
+    expr_program_t *prog = malloc(size);
+    if (!prog) { free(d); return NULL; }
+    prog->consts = (double *)(prog + 1);
+    prog->code = (expr_insn_t *)(prog->consts + count);
+    prog->n_code = 0;
+    prog->n_consts = 0;
+    prog->n_temps = 0;
+    prog->max_depth = 0;
+    prog->n_vars = n_vars;
+
+    unsigned char seen[MAX_NODES] = { 0 };
+    dag_count_uses(d, stack[0], seen);
+    depth = 0;
+    emit(prog, d, stack[0], &depth);
+    free(d);
+    return prog;
+}
+
+double expr_run(const expr_program_t *prog) {
+    return expr_eval(prog, NULL);
+}
+
+double expr_eval(const expr_program_t *prog, const double *vars) {
+    double stack[MAX_TOKENS], temp[MAX_TOKENS];
+    const expr_insn_t *pc = prog->code;
+    const expr_insn_t *end = pc + prog->n_code;
+    const double *k = prog->consts;
+    int top = -1;
+
+    for (; pc < end; pc++) {
+        switch (pc->op) {
+            case EXPR_OP_CONST: stack[++top] = k[pc->arg]; break;
+            case EXPR_OP_VAR:   stack[++top] = vars[pc->arg]; break;
+            case EXPR_OP_LOAD:  stack[++top] = temp[pc->arg]; break;
+            case EXPR_OP_STORE: temp[pc->arg] = stack[top]; break;
+            case EXPR_OP_ADD: top--; stack[top] = stack[top] + stack[top + 1]; break;
+            case EXPR_OP_SUB: top--; stack[top] = stack[top] - stack[top + 1]; break;
+            case EXPR_OP_MUL: top--; stack[top] = stack[top] * stack[top + 1]; break;
+            case EXPR_OP_DIV: top--; stack[top] = stack[top] / stack[top + 1]; break;
+        }
+    }
+    return stack[0];
+}
+
+/* Forward-mode derivatives: the same program with a gradient row per
+   stack entry, grad[v] = d result / d vars[v] */
+double expr_eval_grad(const expr_program_t *prog, const double *vars, double *grad) {
+    double stack[MAX_TOKENS], temp[MAX_TOKENS];
+    double local[GRAD_LOCAL];
+    const int nv = prog->n_vars;
+    const size_t rows = (size_t)prog->max_depth + prog->n_temps;
+    double *g = local;          /* stack gradients, then one row per temp */
+    const expr_insn_t *pc = prog->code;
+    const expr_insn_t *end = pc + prog->n_code;
+    const double *k = prog->consts;
+    int top = -1;
+
+    if (rows * nv > GRAD_LOCAL) {
+        g = malloc(rows * nv * sizeof(double));
+        if (!g) {
+            for (int v = 0; v < nv; v++) grad[v] = NAN;
+            return NAN;
+        }
+    }
+
+    for (; pc < end; pc++) {
+        double *ga, *gb, a, b, q;
+        switch (pc->op) {
+            case EXPR_OP_CONST:
+            case EXPR_OP_VAR:
+                top++;
+                ga = g + (size_t)top * nv;
+                for (int v = 0; v < nv; v++) ga[v] = 0;
+                if (pc->op == EXPR_OP_VAR) {
+                    ga[pc->arg] = 1;
+                    stack[top] = vars[pc->arg];
+                } else {
+                    stack[top] = k[pc->arg];
+                }
+                break;
+            case EXPR_OP_LOAD:
+                top++;
+                memcpy(g + (size_t)top * nv, g + (prog->max_depth + pc->arg) * (size_t)nv, nv * sizeof(double));
+                stack[top] = temp[pc->arg];
+                break;
+            case EXPR_OP_STORE:
+                memcpy(g + (prog->max_depth + pc->arg) * (size_t)nv, g + (size_t)top * nv, nv * sizeof(double));
+                temp[pc->arg] = stack[top];
+                break;
+            default:
+                top--;
+                a = stack[top];
+                b = stack[top + 1];
+                ga = g + (size_t)top * nv;
+                gb = ga + nv;
+                switch (pc->op) {
+                    case EXPR_OP_ADD:
+                        for (int v = 0; v < nv; v++) ga[v] += gb[v];
+                        stack[top] = a + b;
+                        break;
+                    case EXPR_OP_SUB:
+                        for (int v = 0; v < nv; v++) ga[v] -= gb[v];
+                        stack[top] = a - b;
+                        break;
+                    case EXPR_OP_MUL:
+                        for (int v = 0; v < nv; v++) ga[v] = a * gb[v] + b * ga[v];
+                        stack[top] = a * b;
+                        break;
+                    case EXPR_OP_DIV:
+                        q = a / b;
+                        for (int v = 0; v < nv; v++) ga[v] = (ga[v] - q * gb[v]) / b;
+                        stack[top] = q;
+                        break;
+                }
+                break;
+        }
+    }
+    for (int v = 0; v < nv; v++) grad[v] = g[v];
+    if (g != local) free(g);
+    return stack[0];
+}
+
+/* -----------------------------------------------
+   COLUMNAR BATCH EVALUATION
+   Rows are processed EXPR_BLOCK at a time. Each
+   stack entry is either a broadcast constant or a
+   pointer to a block of values (an input column or
+   the scratch row owned by that stack depth), and
+   each operator runs one of the plain loops below,
+   which the compiler turns into SIMD code.
+   ----------------------------------------------- */
+
+#define EXPR_BLOCK 256
+
+typedef struct {
+    const double *vec;  /* NULL for a broadcast constant */
+    double c;
+} batch_slot_t;
+
+#define EXPR_KERNELS(name, OP)                                                     \
+static void name##_vv(double *restrict o, const double *restrict a,                \
+                      const double *restrict b, size_t m)                          \
+{ for (size_t k = 0; k < m; k++) o[k] = a[k] OP b[k]; }                            \
+static void name##_ov(double *restrict o, const double *restrict b, size_t m)      \
+{ for (size_t k = 0; k < m; k++) o[k] = o[k] OP b[k]; }                            \
+static void name##_vc(double *restrict o, const double *restrict a, double c, size_t m) \
+{ for (size_t k = 0; k < m; k++) o[k] = a[k] OP c; }                               \
+static void name##_oc(double *restrict o, double c, size_t m)                      \
+{ for (size_t k = 0; k < m; k++) o[k] = o[k] OP c; }                               \
+static void name##_cv(double *restrict o, double c, const double *restrict b, size_t m) \
+{ for (size_t k = 0; k < m; k++) o[k] = c OP b[k]; }
+
+EXPR_KERNELS(vadd, +)
+EXPR_KERNELS(vsub, -)
+EXPR_KERNELS(vmul, *)
+EXPR_KERNELS(vdiv, /)
+
+/* a OP b for one block; the result is left in scratch row 'o' */
+static void batch_binary(int op, double *o, const batch_slot_t *a, const batch_slot_t *b, size_t m) {
+    static void (*const vv[])(double *restrict, const double *restrict, const double *restrict, size_t) =
+        { vadd_vv, vsub_vv, vmul_vv, vdiv_vv };
+    static void (*const ov[])(double *restrict, const double *restrict, size_t) =
+        { vadd_ov, vsub_ov, vmul_ov, vdiv_ov };
+    static void (*const vc[])(double *restrict, const double *restrict, double, size_t) =
+        { vadd_vc, vsub_vc, vmul_vc, vdiv_vc };
+    static void (*const oc[])(double *restrict, double, size_t) =
+        { vadd_oc, vsub_oc, vmul_oc, vdiv_oc };
+    static void (*const cv[])(double *restrict, double, const double *restrict, size_t) =
+        { vadd_cv, vsub_cv, vmul_cv, vdiv_cv };
+    int k = op - EXPR_OP_ADD;
+
+    if (!a->vec)             cv[k](o, a->c, b->vec, m);
+    else if (a->vec == o)  { if (b->vec) ov[k](o, b->vec, m); else oc[k](o, b->c, m); }
+    else                   { if (b->vec) vv[k](o, a->vec, b->vec, m); else vc[k](o, a->vec, b->c, m); }
+}
+
+void expr_eval_batch(const expr_program_t *prog, const double *const *columns,
+                     size_t n_rows, double *out) {
+    batch_slot_t stack[MAX_TOKENS], temp[MAX_TOKENS];
+    /* One row per stack depth, then one per temp */
+    double *scratch = malloc(((size_t)prog->max_depth + prog->n_temps) * EXPR_BLOCK * sizeof(double));
+    double *temp_rows = scratch + (size_t)prog->max_depth * EXPR_BLOCK;
+    if (!scratch) {
+        for (size_t r = 0; r < n_rows; r++) out[r] = NAN;
+        return;
+    }
+
+    for (size_t row = 0; row < n_rows; row += EXPR_BLOCK) {
+        size_t m = n_rows - row < EXPR_BLOCK ? n_rows - row : EXPR_BLOCK;
+        int top = -1;
+
+        for (int i = 0; i < prog->n_code; i++) {
+            const expr_insn_t *in = &prog->code[i];
+            switch (in->op) {
+                case EXPR_OP_CONST:
+                    top++;
+                    stack[top].vec = NULL;
+                    stack[top].c = prog->consts[in->arg];
+                    break;
+                case EXPR_OP_VAR:
+                    top++;
+                    stack[top].vec = columns[in->arg] + row;
+                    break;
+                case EXPR_OP_LOAD:
+                    stack[++top] = temp[in->arg];
+                    break;
+                case EXPR_OP_STORE: {
+                    /* The operator before a STORE already wrote into the temp row */
+                    double *t = temp_rows + (size_t)in->arg * EXPR_BLOCK;
+                    if (stack[top].vec && stack[top].vec != t) {
+                        memcpy(t, stack[top].vec, m * sizeof(double));
+                        stack[top].vec = t;
+                    }
+                    temp[in->arg] = stack[top];
+                    break;
+                }
+                default: {
+                    batch_slot_t *a = &stack[top - 1], *b = &stack[top];
+                    top--;
+                    if (!a->vec && !b->vec) {
+                        a->c = scalar_op(in->op, a->c, b->c);
+                    } else {
+                        double *o = scratch + (size_t)top * EXPR_BLOCK;
+                        if (i + 1 < prog->n_code && prog->code[i + 1].op == EXPR_OP_STORE)
+                            o = temp_rows + (size_t)prog->code[i + 1].arg * EXPR_BLOCK;
+                        batch_binary(in->op, o, a, b, m);
+                        a->vec = o;
+                    }
+                }
+            }
+        }
+
+        if (stack[0].vec)
+            memcpy(out + row, stack[0].vec, m * sizeof(double));
+        else
+            for (size_t k = 0; k < m; k++) out[row + k] = stack[0].c;
+    }
+
+    free(scratch);
+}
+
+void expr_free(expr_program_t *prog) {
+    free(prog);
+}
+
+/* -----------------------------------------------
+   EXPRESSION CACHE
+   Expressions that differ only in their numbers
+   share one compiled program: "4.7k*2+1" and
+   "10*3m+2" both normalize to "#*#+#", and the
+   program reads literal k as variable k. Entries
+   sit in a hash table and an LRU list under one
+   mutex; a reference count keeps an evicted
+   program alive until its last evaluation ends.
+   ----------------------------------------------- */
+
+#define CACHE_ENTRIES 256
+#define CACHE_BUCKETS 512       /* power of two */
+
+typedef struct cache_entry {
+    struct cache_entry *chain;              /* next in the same bucket */
+    struct cache_entry *newer, *older;      /* LRU list */
+    uint64_t hash;
+    expr_program_t *prog;
+    int refs;                               /* 1 while cached + evaluations in flight */
+    char key[];
+} cache_entry_t;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static cache_entry_t *cache_bucket[CACHE_BUCKETS];
+static cache_entry_t *cache_newest, *cache_oldest;
+static size_t cache_count;
+static unsigned long long cache_hits, cache_misses, cache_evictions;
+
+/* Literals become '#' in the key, with their values in lits[]. Returns
+   the key length, or 0 when the expression should not be cached (names,
+   stray characters, overlong numbers): compiling it directly then gives
+   the proper error. */
+static size_t cache_normalize(const char *expr, char *key, size_t key_size, double *lits, int *n_lits) {
+    size_t k = 0;
+    int n = 0;
+    for (const char *c = expr; *c; ) {
+        if (k + 1 >= key_size) return 0;
+        if (isspace((unsigned char)*c)) { c++; continue; }
+        if (isdigit((unsigned char)*c) || *c == '.') {
+            const char *start = c;
+            while (isdigit((unsigned char)*c) || *c == '.' || isalpha((unsigned char)*c)) c++;
+            if (c - start >= MAX_LEN - 1 || n >= MAX_TOKENS) return 0;
+            lits[n++] = parse_prefix_n(start, c - start, NULL);
+            key[k++] = '#';
+        } else if (is_operator(*c) || *c == '(' || *c == ')') {
+            key[k++] = *c++;
+        } else {
+            return 0;
+        }
+    }
+    key[k] = '\0';
+    *n_lits = n;
+    return k;
+}
+
+/* The text a key is compiled from: literal k becomes variable " _k", the
+   space keeping adjacent literals ("2 3") apart as they were written */
+static void cache_key_text(const char *key, char *text, size_t text_size) {
+    size_t t = 0;
+    int n = 0;
+    for (; *key && t + 7 < text_size; key++) {
+        if (*key == '#') t += snprintf(text + t, text_size - t, " _%d", n++);
+        else text[t++] = *key;
+    }
+    text[t] = '\0';
+}
+
+static uint64_t fnv1a(const char *s, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; i++) h = (h ^ (unsigned char)s[i]) * 0x100000001b3ull;
+    return h;
+}
+
+/* The caller holds cache_lock */
+static void cache_unlink_lru(cache_entry_t *e) {
+    if (e->newer) e->newer->older = e->older; else cache_newest = e->older;
+    if (e->older) e->older->newer = e->newer; else cache_oldest = e->newer;
+}
+
+static void cache_push_newest(cache_entry_t *e) {
+    e->newer = NULL;
+    e->older = cache_newest;
+    if (cache_newest) cache_newest->newer = e; else cache_oldest = e;
+    cache_newest = e;
+}
+
+static void cache_release(cache_entry_t *e) {
+    if (--e->refs == 0) {
+        expr_free(e->prog);
+        free(e);
+    }
+}
+
+static void cache_evict(cache_entry_t *e) {
+    cache_entry_t **pp = &cache_bucket[e->hash & (CACHE_BUCKETS - 1)];
+    while (*pp != e) pp = &(*pp)->chain;
+    *pp = e->chain;
+    cache_unlink_lru(e);
+    cache_count--;
+    cache_release(e);
+}
+
+static cache_entry_t *cache_find(uint64_t hash, const char *key) {
+    for (cache_entry_t *e = cache_bucket[hash & (CACHE_BUCKETS - 1)]; e; e = e->chain)
+        if (e->hash == hash && strcmp(e->key, key) == 0) return e;
+    return NULL;
+}
+
+/* "_0" .. "_255": the variable names literals are compiled as */
+static char lit_name_buf[MAX_TOKENS][16];
+static const char *lit_names[MAX_TOKENS];
+static pthread_once_t lit_names_once = PTHREAD_ONCE_INIT;
+
+static void init_lit_names(void) {
+    for (int i = 0; i < MAX_TOKENS; i++) {
+        snprintf(lit_name_buf[i], sizeof lit_name_buf[i], "_%d", i);
+        lit_names[i] = lit_name_buf[i];
+    }
+}
+
+int expr_cache_eval(const char *expr, double *result) {
+    char key[MAX_TOKENS * 2];
+    double lits[MAX_TOKENS];
+    int n_lits;
+
+    expr_errbuf[0] = '\0';
+    size_t len = cache_normalize(expr, key, sizeof key, lits, &n_lits);
+    if (len == 0) {
+        pthread_mutex_lock(&cache_lock);
+        cache_misses++;
+        pthread_mutex_unlock(&cache_lock);
+        expr_program_t *prog = expr_compile(expr);
+        if (!prog) return 1;
+        *result = expr_run(prog);
+        expr_free(prog);
+        return 0;
+    }
+    uint64_t hash = fnv1a(key, len);
+
+    pthread_mutex_lock(&cache_lock);
+    cache_entry_t *e = cache_find(hash, key);
+    if (e) {
+        cache_hits++;
+        e->refs++;
+        cache_unlink_lru(e);
+        cache_push_newest(e);
+    } else {
+        cache_misses++;
+    }
+    pthread_mutex_unlock(&cache_lock);
+
+    if (!e) {
+        /* Compile outside the lock; if another thread got there first
+           its entry is used and this one dropped */
+        char text[MAX_TOKENS * 8];
+        cache_key_text(key, text, sizeof text);
+        pthread_once(&lit_names_once, init_lit_names);
+        expr_program_t *prog = expr_compile_vars(text, lit_names, n_lits);
+        if (!prog) return 1;
+        cache_entry_t *fresh = malloc(sizeof *fresh + len + 1);
+        if (!fresh) {
+            *result = expr_eval(prog, lits);
+            expr_free(prog);
+            return 0;
+        }
+        memcpy(fresh->key, key, len + 1);
+        fresh->hash = hash;
+        fresh->prog = prog;
+        fresh->refs = 2;
+
+        pthread_mutex_lock(&cache_lock);
+        e = cache_find(hash, key);
+        if (e) {
+            e->refs++;
+            expr_free(prog);
+            free(fresh);
+        } else {
+            e = fresh;
+            cache_entry_t **head = &cache_bucket[hash & (CACHE_BUCKETS - 1)];
+            e->chain = *head;
+            *head = e;
+            cache_push_newest(e);
+            if (++cache_count > CACHE_ENTRIES) {
+                cache_evictions++;
+                cache_evict(cache_oldest);
+            }
+        }
+        pthread_mutex_unlock(&cache_lock);
+    }
+
+    *result = expr_eval(e->prog, lits);
+
+    pthread_mutex_lock(&cache_lock);
+    cache_release(e);
+    pthread_mutex_unlock(&cache_lock);
+    return 0;
+}
+
+void expr_cache_stats(expr_cache_stats_t *st) {
+    pthread_mutex_lock(&cache_lock);
+    st->hits = cache_hits;
+    st->misses = cache_misses;
+    st->evictions = cache_evictions;
+    st->entries = cache_count;
+    st->capacity = CACHE_ENTRIES;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+void expr_cache_clear(void) {
+    pthread_mutex_lock(&cache_lock);
+    while (cache_oldest) cache_evict(cache_oldest);
+    cache_hits = cache_misses = cache_evictions = 0;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+/* -----------------------------------------------
+   USER MENU
+   ----------------------------------------------- */
+
+void expression_menu(void) {
+    char expr[256];
+
+    printf("\n==== EXPRESSION EVALUATOR ====\n");
+    printf("Supports: +  -  *  /  ( )  and prefixes like k,m,u,n,p\n");
+    printf("Example: ((45k*33)+(22-21)/((45k-44k)*(23m+44k)))\n\n");
+
+    printf("Enter expression: ");
+    getchar();  // clear leftover newline
+    fgets(expr, sizeof(expr), stdin);
+
+    // Remove trailing newline
+    expr[strcspn(expr, "\n")] = 0;
+
+    double result = evaluate_expression(expr);
+
+    printf("\nResult = %.10g\n", result);
+
+    char eng[64];
+    format_with_prefix(eng, sizeof(eng), result, "");
+    printf("Engineering Notation: %s\n", eng);
+
+    expr_cache_stats_t st;
+    expr_cache_stats(&st);
+    printf("Compiled-expression cache: %llu hits, %llu misses, %zu/%zu entries\n",
+           st.hits, st.misses, st.entries, st.capacity);
+}
@@ -1,7 +1,93 @@
-#ifndef EXPRESSION_EVAL_H
-#define EXPRESSION_EVAL_H
-
-double evaluate_expression(const char *expr);
-void expression_menu(void);
-
-#endif
+#ifndef EXPRESSION_EVAL_H
+#define EXPRESSION_EVAL_H
+
+#include <stddef.h>
+
+double evaluate_expression(const char *expr);
+
+/* Value plus its partial derivatives: grad[v] receives the derivative
+   with respect to the input named vars[v], whose value is values[v].
+   A name not in vars is an error: it is reported and NaN is returned.
+   One pass, exact to rounding (dual numbers, not finite differences). */
+double evaluate_expression_grad(const char *expr, const char *const *vars, const double *values,
+                                int n_vars, double *grad);
+void expression_menu(void);
+
+/* -----------------------------------------------
+   Compiled expressions: parse once, evaluate many
+   ----------------------------------------------- */
+
+typedef enum {
+    EXPR_OP_CONST,      /* push consts[arg] */
+    EXPR_OP_VAR,        /* push vars[arg] */
+    EXPR_OP_ADD,
+    EXPR_OP_SUB,
+    EXPR_OP_MUL,
+    EXPR_OP_DIV,
+    EXPR_OP_STORE,      /* temps[arg] = top of stack, left in place */
+    EXPR_OP_LOAD        /* push temps[arg] */
+} expr_opcode_t;
+
+typedef struct {
+    unsigned char op;   /* expr_opcode_t */
+    unsigned short arg; /* operand index for CONST / VAR / STORE / LOAD */
+} expr_insn_t;
+
+typedef struct {
+    expr_insn_t *code;
+    int n_code;
+    double *consts;     /* SI prefixes already applied */
+    int n_consts;
+    int n_vars;         /* number of names the program was compiled against */
+    int n_temps;        /* shared subexpressions kept by STORE / LOAD */
+    int max_depth;      /* deepest evaluation stack the program needs */
+} expr_program_t;
+
+/* Returns NULL (after printing why) if the expression is malformed.
+   Constant subtrees are folded, repeated subexpressions are computed
+   once (STORE / LOAD) and division by a power of two becomes a multiply;
+   results are bit-identical to evaluating the expression as written. */
+expr_program_t *expr_compile(const char *expr);
+double expr_run(const expr_program_t *prog);
+
+/* Variables: names such as "V", "R1" or "R_load" are bound to the
+   position they have in 'vars', e.g. "V/(R1+R2)*R2" with
+   {"V", "R1", "R2"} reads vars[0], vars[1] and vars[2]. */
+expr_program_t *expr_compile_vars(const char *expr, const char *const *vars, int n_vars);
+double expr_eval(const expr_program_t *prog, const double *vars);
+
+/* expr_eval() that also fills grad[0 .. n_vars-1] with d result / d vars[v] */
+double expr_eval_grad(const expr_program_t *prog, const double *vars, double *grad);
+
+/* Structure-of-arrays evaluation: columns[v][r] is variable v on row r,
+   out[r] receives the result for row r. */
+void expr_eval_batch(const expr_program_t *prog, const double *const *columns,
+                     size_t n_rows, double *out);
+void expr_free(expr_program_t *prog);
+
+/* -----------------------------------------------
+   Compiled-expression cache
+   ----------------------------------------------- */
+
+/* Evaluates a numeric expression through a bounded, thread-safe LRU
+   cache of compiled programs. The key is the expression with spaces
+   dropped and every number replaced by a placeholder, so "4.7k*2+1"
+   and "10*3m+2" share one program and only the numbers are parsed on a
+   hit. evaluate_expression() goes through here. Returns 0, or 1 if the
+   expression is malformed (reported as for expr_compile()). */
+int expr_cache_eval(const char *expr, double *result);
+
+typedef struct {
+    unsigned long long hits, misses, evictions;
+    size_t entries, capacity;
+} expr_cache_stats_t;
+
+void expr_cache_stats(expr_cache_stats_t *st);
+void expr_cache_clear(void);        /* drops every entry and zeroes the counters */
+
+/* By default compile errors are printed; with quiet set (per thread) they
+   are only recorded and can be fetched with expr_last_error(). */
+void expr_set_quiet(int quiet);
+const char *expr_last_error(void);
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "file_map.h"
+
+int file_map(const char *path, file_map_t *m) {
+    int fd = strcmp(path, "-") == 0 ? 0 : open(path, O_RDONLY);
+    struct stat st;
+    char *data = NULL;
+    int rc = 0;
+    m->data = NULL;
+    m->size = 0;
+    m->mapped = 0;
+    if (fd < 0 || fstat(fd, &st) != 0) { if (fd > 0) close(fd); return FILE_MAP_OPEN; }
+
+    if (S_ISREG(st.st_mode)) {
+        m->size = (size_t)st.st_size;
+        if (m->size == 0) { if (fd > 0) close(fd); m->data = ""; m->mapped = 1; return 0; }
+        data = mmap(NULL, m->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+        else { madvise(data, m->size, MADV_SEQUENTIAL); m->mapped = 1; }
+    }
+    if (!data) {                                /* pipe, or mmap refused */
+        size_t cap = 1 << 20, size = 0;
+        data = malloc(cap);
+        while (data) {
+            ssize_t got = read(fd, data + size, cap - size);
+            if (got < 0 && errno == EINTR) continue;
+            if (got < 0) { free(data); data = NULL; rc = FILE_MAP_READ; break; }
+            if (got == 0) break;
+            size += (size_t)got;
+            if (size < cap) continue;
+            char *b = realloc(data, cap *= 2);
+            if (!b) free(data);
+            data = b;
+        }
+        if (!data && !rc) rc = FILE_MAP_NOMEM;
+        m->size = data ? size : 0;
+    }
+    if (fd > 0) close(fd);
+    m->data = data;
+    return rc;
+}
+
+void file_unmap(file_map_t *m) {
+    if (m->mapped && m->size) munmap((void *)m->data, m->size);
+    else if (!m->mapped) free((void *)m->data);
+    m->data = NULL;
+    m->size = 0;
+}
+
+const char *file_map_error(int rc) {
+    return rc == FILE_MAP_READ ? "read error" : rc == FILE_MAP_NOMEM ? "out of memory" : "cannot open";
+}
+
+size_t file_line_start(const char *data, size_t size, size_t pos) {
+    if (pos == 0) return 0;
+    const char *nl = memchr(data + pos - 1, '\n', size - (pos - 1));
+    return nl ? (size_t)(nl - data) + 1 : size;
+}
+
+int file_out_reserve(file_out_t *o, size_t extra) {
+    if (o->len + extra <= o->cap) return 1;
+    size_t cap = o->cap ? o->cap : 1 << 16;
+    while (cap < o->len + extra) cap *= 2;
+    char *b = realloc(o->buf, cap);
+    if (!b) { o->failed = 1; return 0; }
+    o->buf = b;
+    o->cap = cap;
+    return 1;
+}
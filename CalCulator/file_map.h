@@ -0,0 +1,37 @@
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+#include <stddef.h>
+
+/* Whole input file in memory for the bulk engines: memory-mapped for
+   regular files, read into a buffer for pipes and for "-" (stdin). */
+typedef struct {
+    const char *data;
+    size_t size;
+    int mapped;
+} file_map_t;
+
+/* file_map() returns 0 on success or one of these, with m left empty */
+#define FILE_MAP_OPEN   1       /* cannot open or stat the file */
+#define FILE_MAP_READ   2       /* read() failed part way through */
+#define FILE_MAP_NOMEM  3       /* no memory to hold a piped input */
+
+int file_map(const char *path, file_map_t *m);
+void file_unmap(file_map_t *m);
+const char *file_map_error(int rc);                /* "read error", ... */
+
+/* Byte offset of the first line starting at or after pos */
+size_t file_line_start(const char *data, size_t size, size_t pos);
+
+/* Growable output buffer, one per worker task in the bulk engines */
+typedef struct {
+    char *buf;
+    size_t len, cap;
+    int failed;                 /* a reserve ran out of memory */
+} file_out_t;
+
+/* Room for at least extra more bytes after len; 0 (and failed set) if
+   the buffer could not grow */
+int file_out_reserve(file_out_t *o, size_t extra);
+
+#endif
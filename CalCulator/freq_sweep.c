@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "freq_sweep.h"
+#include "math_ops.h"
+#include "parallel.h"
+#include "simd_dispatch.h"
+
+#define LANES   4
+#define ANCHOR  1024                /* log grid: points between exact exp() */
+#define BLOCK   16384               /* points per task, multiple of ANCHOR */
+#define PAR_MIN 65536               /* below this one thread is faster */
+
+typedef double fs_vec_t __attribute__((vector_size(LANES * sizeof(double))));
+
+/* ────────────────────────────────────────────────
+   KERNEL
+   Series:   Z = R + j(wL - 1/(wC))
+   Parallel: Y = 1/R + j(wC - 1/(wL)),  Z = 1/Y
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    int parallel;
+    double R, L, C;
+    double inv_R, inv_L, inv_C;     /* 0 when the part is absent */
+    int log_grid;
+    double f_start, step;           /* linear: Hz per point; log: ln ratio per point */
+} sweep_t;
+
+/* Points skip .. skip+n-1 after the anchor k0, written from out[at].
+   The log-grid recurrence always starts at the anchor and steps over the
+   skipped vectors, so a point's value does not depend on where the
+   caller's range began. */
+static inline __attribute__((always_inline))
+void sweep_segment(const sweep_t *s, uint64_t k0, size_t skip, size_t n, const fs_result_t *out, size_t at) {
+    fs_vec_t k, f, f_step = { 0 };
+    for (int l = 0; l < LANES; l++) k[l] = (double)(k0 + l);
+    if (s->log_grid) {
+        for (int l = 0; l < LANES; l++) f[l] = s->f_start * exp(k[l] * s->step);
+        f_step += exp(LANES * s->step);
+    }
+
+    size_t end = skip + n;
+    for (size_t j = 0; j < end; j += LANES) {
+        if (j + LANES > skip) {
+            if (!s->log_grid) f = s->f_start + k * s->step;
+            fs_vec_t w = 2.0 * M_PI * f, re, im;
+
+            if (!s->parallel) {
+                re = (fs_vec_t){ 0 } + s->R;
+                im = w * s->L;
+                if (s->inv_C != 0) im -= s->inv_C / w;
+            } else {
+                fs_vec_t g = (fs_vec_t){ 0 } + s->inv_R, b = w * s->C;
+                if (s->inv_L != 0) b -= s->inv_L / w;
+                if (s->inv_R != 0) {
+                    fs_vec_t d = g * g + b * b;
+                    re = g / d;
+                    im = -b / d;
+                } else {
+                    /* No R is an infinite one: Z = -j/b, and at resonance
+                       (b = 0) the limit R -> inf leaves Z = R, real and infinite */
+                    re = (fs_vec_t){ 0 };
+                    im = -1.0 / b;
+                    for (int l = 0; l < LANES; l++)
+                        if (b[l] == 0) re[l] = INFINITY, im[l] = 0;
+                }
+            }
+
+            size_t from = j < skip ? skip - j : 0, cnt = end - j < LANES ? end - j : LANES;
+            for (size_t l = from; l < cnt; l++) {
+                size_t p = at + j + l - skip;
+                if (out->freq) out->freq[p] = f[l];
+                if (out->re) out->re[p] = re[l];
+                if (out->im) out->im[p] = im[l];
+                if (out->mag) out->mag[p] = sqrt(re[l] * re[l] + im[l] * im[l]);
+                if (out->phase) out->phase[p] = atan2(im[l], re[l]) * (180.0 / M_PI);
+            }
+        }
+        if (s->log_grid) f *= f_step;
+        k += LANES;
+    }
+}
+
+/* Every segment starts from the multiple of ANCHOR at or below it */
+static inline __attribute__((always_inline))
+void sweep_range_body(const sweep_t *s, uint64_t first, size_t n, const fs_result_t *out, size_t at) {
+    size_t done = 0;
+    while (done < n) {
+        uint64_t k = first + done;
+        size_t skip = (size_t)(k % ANCHOR), len = ANCHOR - skip;
+        if (len > n - done) len = n - done;
+        sweep_segment(s, k - skip, skip, len, out, at + done);
+        done += len;
+    }
+}
+
+SIMD_KERNEL(sweep_range, (const sweep_t *s, uint64_t first, size_t n, const fs_result_t *out, size_t at),
+            (s, first, n, out, at))
+
+typedef void (*range_fn)(const sweep_t *s, uint64_t first, size_t n, const fs_result_t *out, size_t at);
+
+static int build_sweep(const fs_circuit_t *c, const fs_grid_t *g, sweep_t *s) {
+    memset(s, 0, sizeof *s);
+    if (c->topology != FS_SERIES && c->topology != FS_PARALLEL) { printf("Error: unknown topology.\n"); return 1; }
+    if (!(c->R >= 0) || !(c->L >= 0) || !(c->C >= 0) || c->R + c->L + c->C == 0) {
+        printf("Error: component values must be positive (0 = absent), at least one present.\n");
+        return 1;
+    }
+    if (g->n == 0 || !(g->f_start > 0) || !(g->f_stop > 0) || !isfinite(g->f_start) || !isfinite(g->f_stop)) {
+        printf("Error: frequencies must be positive and the grid needs at least one point.\n");
+        return 1;
+    }
+    if (g->grid != FS_LINEAR && g->grid != FS_LOG) { printf("Error: unknown grid.\n"); return 1; }
+
+    s->parallel = c->topology == FS_PARALLEL;
+    s->R = c->R, s->L = c->L, s->C = c->C;
+    s->inv_R = c->R > 0 ? 1.0 / c->R : 0;
+    s->inv_L = c->L > 0 ? 1.0 / c->L : 0;
+    s->inv_C = c->C > 0 ? 1.0 / c->C : 0;
+    s->log_grid = g->grid == FS_LOG;
+    s->f_start = g->f_start;
+    double span = g->n > 1 ? (double)(g->n - 1) : 1.0;
+    s->step = s->log_grid ? log(g->f_stop / g->f_start) / span : (g->f_stop - g->f_start) / span;
+    return 0;
+}
+
+/* ────────────────────────────────────────────────
+   DRIVERS
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    const sweep_t *s;
+    range_fn range;
+    uint64_t first;
+    size_t count;
+    const fs_result_t *out;
+} sweep_job_t;
+
+static void sweep_task(void *ctx, int task) {
+    sweep_job_t *j = ctx;
+    size_t at = (size_t)task * BLOCK;
+    size_t n = j->count - at < BLOCK ? j->count - at : BLOCK;
+    j->range(j->s, j->first + at, n, j->out, at);
+}
+
+int fs_sweep(const fs_circuit_t *c, const fs_grid_t *g, uint64_t first, size_t count, const fs_result_t *out) {
+    sweep_t s;
+    if (build_sweep(c, g, &s)) return 1;
+    if (first > g->n || count > g->n - first) {
+        printf("Error: points %llu .. %llu are outside the %llu-point grid.\n", (unsigned long long)first,
+               (unsigned long long)first + count - 1, (unsigned long long)g->n);
+        return 1;
+    }
+    sweep_job_t job = { &s, sweep_range_pick(), first, count, out };
+    int n_tasks = (int)((count + BLOCK - 1) / BLOCK);
+    if (count >= PAR_MIN)
+        par_for(n_tasks, sweep_task, &job);
+    else
+        for (int t = 0; t < n_tasks; t++) sweep_task(&job, t);
+    return 0;
+}
+
+typedef struct {
+    const sweep_t *s;
+    range_fn range;
+    uint64_t pos, n;                /* window start, total points */
+    double *mag, *phase;            /* BLOCK per task */
+    float *rec;                     /* 2 * BLOCK per task */
+    size_t *len;
+} write_chunk_t;
+
+static void write_task(void *ctx, int task) {
+    write_chunk_t *ch = ctx;
+    uint64_t first = ch->pos + (uint64_t)task * BLOCK;
+    ch->len[task] = 0;
+    if (first >= ch->n) return;
+    size_t n = ch->n - first < BLOCK ? (size_t)(ch->n - first) : BLOCK;
+    double *mag = ch->mag + (size_t)task * BLOCK, *phase = ch->phase + (size_t)task * BLOCK;
+    float *rec = ch->rec + (size_t)task * 2 * BLOCK;
+    fs_result_t out = { NULL, NULL, NULL, mag, phase };
+    ch->range(ch->s, first, n, &out, 0);
+    for (size_t i = 0; i < n; i++) {
+        rec[2 * i] = (float)mag[i];
+        rec[2 * i + 1] = (float)phase[i];
+    }
+    ch->len[task] = n * 2 * sizeof(float);
+}
+
+static void put_header(unsigned char *h, const fs_circuit_t *c, const fs_grid_t *g) {
+    uint32_t u[3] = { 1, (uint32_t)c->topology, (uint32_t)g->grid };
+    double d[5] = { g->f_start, g->f_stop, c->R, c->L, c->C };
+    memcpy(h, "BODE", 4);
+    memcpy(h + 4, u, sizeof u);
+    memcpy(h + 16, &g->n, 8);
+    memcpy(h + 24, d, sizeof d);
+}
+
+int fs_write(const fs_circuit_t *c, const fs_grid_t *g, const char *path) {
+    sweep_t s;
+    if (build_sweep(c, g, &s)) return 1;
+    FILE *out = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+    if (!out) { printf("Error: cannot create %s\n", path); return 1; }
+
+    int n_tasks = par_threads() * 2;
+    write_chunk_t ch = { &s, sweep_range_pick(), 0, g->n,
+                         malloc((size_t)n_tasks * BLOCK * sizeof(double)),
+                         malloc((size_t)n_tasks * BLOCK * sizeof(double)),
+                         malloc((size_t)n_tasks * 2 * BLOCK * sizeof(float)),
+                         malloc((size_t)n_tasks * sizeof(size_t)) };
+    int rc = 0;
+    if (!ch.mag || !ch.phase || !ch.rec || !ch.len) { printf("Error: out of memory\n"); rc = 1; }
+
+    unsigned char header[FS_HEADER_BYTES] = { 0 };
+    put_header(header, c, g);
+    if (!rc && fwrite(header, 1, sizeof header, out) != sizeof header) rc = 2;
+    for (uint64_t pos = 0; !rc && pos < g->n; pos += (uint64_t)n_tasks * BLOCK) {
+        ch.pos = pos;
+        uint64_t left = (g->n - pos + BLOCK - 1) / BLOCK;
+        int tasks = left < (uint64_t)n_tasks ? (int)left : n_tasks;
+        par_for(tasks, write_task, &ch);
+        for (int t = 0; t < tasks; t++)
+            if (fwrite(ch.rec + (size_t)t * 2 * BLOCK, 1, ch.len[t], out) != ch.len[t]) rc = 2;
+    }
+
+    free(ch.mag);
+    free(ch.phase);
+    free(ch.rec);
+    free(ch.len);
+    if (out != stdout) { if (fclose(out) != 0 && !rc) rc = 2; }
+    else fflush(out);
+    if (rc == 2) printf("Error: writing %s failed\n", path);
+    return rc != 0;
+}
+
+/* ────────────────────────────────────────────────
+   PROMPTS
+   ──────────────────────────────────────────────── */
+
+static void print_point(double f, double mag, double phase) {
+    char fb[PREFIX_FMT_MAX + 8], zb[PREFIX_FMT_MAX + 8];
+    format_with_prefix(fb, sizeof fb, f, "Hz");
+    format_with_prefix(zb, sizeof zb, mag, "Ω");
+    printf("  %-24s |Z| = %-24s phase = %8.3f°\n", fb, zb, phase);
+}
+
+void sweep_dialog(void) {
+    fs_circuit_t c = { 0 };
+    fs_grid_t g = { 0 };
+    printf("Topology (1 = series R-L-C, 2 = parallel R||L||C): ");
+    if (scanf("%d", &c.topology) != 1 || (c.topology != 1 && c.topology != 2)) { printf("Invalid option.\n"); return; }
+    c.topology = c.topology == 2 ? FS_PARALLEL : FS_SERIES;
+    c.R = read_number("Resistance (Ω, 0 = none): ");
+    c.L = read_number("Inductance (H, 0 = none): ");
+    c.C = read_number("Capacitance (F, 0 = none): ");
+    g.f_start = read_number("Start frequency (Hz): ");
+    g.f_stop = read_number("Stop frequency (Hz): ");
+    printf("Grid (1 = linear, 2 = logarithmic): ");
+    if (scanf("%d", &g.grid) != 1) return;
+    g.grid = g.grid == 2 ? FS_LOG : FS_LINEAR;
+    double points = read_number("Number of points (e.g. 10M): ");
+    if (!(points >= 1)) { printf("Invalid input.\n"); return; }
+    g.n = (uint64_t)points;
+
+    if (c.L > 0 && c.C > 0) {
+        double f0 = 1.0 / (2 * M_PI * sqrt(c.L * c.C));
+        char buf[PREFIX_FMT_MAX + 8];
+        format_with_prefix(buf, sizeof buf, f0, "Hz");
+        printf("Resonant frequency f0 = %s", buf);
+        if (c.R > 0) printf(", Q = %.4g", c.topology == FS_SERIES ? sqrt(c.L / c.C) / c.R : c.R / sqrt(c.L / c.C));
+        printf("\n");
+    }
+
+    /* Eleven points spread over the grid */
+    double f[11], mag[11], phase[11];
+    for (int p = 0; p <= 10; p++) {
+        fs_result_t one = { f + p, NULL, NULL, mag + p, phase + p };
+        if (fs_sweep(&c, &g, (g.n - 1) * (uint64_t)p / 10, 1, &one)) return;
+    }
+    for (int p = 0; p <= 10; p++) print_point(f[p], mag[p], phase[p]);
+
+    char path[256];
+    printf("Binary output file (- = skip): ");
+    if (scanf("%255s", path) != 1 || strcmp(path, "-") == 0) return;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int rc = fs_write(&c, &g, path);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc) return;
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    printf("%llu points in %.3f s: %.1f M points/s\n", (unsigned long long)g.n, secs,
+           secs > 0 ? g.n / secs / 1e6 : 0.0);
+}
@@ -0,0 +1,59 @@
+#ifndef FREQ_SWEEP_H
+#define FREQ_SWEEP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Impedance of series or parallel R, L, C combinations over a frequency
+   grid, for Bode plots (|Z| and phase against frequency). A component
+   set to 0 is left out, so R+L, L||C etc. are the same circuit kinds.
+   A parallel circuit without R is open at resonance: |Z| is infinite
+   there and the phase 0, the limit as R grows without bound.
+
+   Points are computed in structure-of-arrays blocks (one array per
+   quantity, four points per vector step) and split across the worker
+   pool; every point depends only on its index. */
+
+#define FS_SERIES   0
+#define FS_PARALLEL 1
+
+#define FS_LINEAR   0           /* equal steps from f_start to f_stop */
+#define FS_LOG      1           /* equal ratios (f_start, f_stop > 0) */
+
+typedef struct {
+    int topology;               /* FS_SERIES or FS_PARALLEL */
+    double R, L, C;             /* ohms, henries, farads; 0 = absent */
+} fs_circuit_t;
+
+typedef struct {
+    int grid;                   /* FS_LINEAR or FS_LOG */
+    double f_start, f_stop;     /* hertz, both included */
+    uint64_t n;                 /* points, at least 2 (1 = f_start only) */
+} fs_grid_t;
+
+/* One array per quantity; any may be NULL */
+typedef struct {
+    double *freq;               /* Hz */
+    double *re, *im;            /* Z in ohms */
+    double *mag;                /* |Z| in ohms */
+    double *phase;              /* degrees, -180 .. 180 */
+} fs_result_t;
+
+/* Points first .. first+count-1 of the grid. Returns 0, or 1 (after
+   printing why) for an invalid circuit or grid, or a window that runs
+   past the last point. */
+int fs_sweep(const fs_circuit_t *c, const fs_grid_t *g, uint64_t first, size_t count, const fs_result_t *out);
+
+/* Binary sweep file ("-" = stdout), native byte order:
+       64-byte header: "BODE", u32 version (1), u32 topology, u32 grid,
+                       u64 points, f64 f_start, f_stop, R, L, C
+       then per point: f32 |Z| (ohms), f32 phase (degrees)
+   The frequency of point k follows from the grid. Streamed in blocks,
+   so the sweep never has to fit in memory. Returns 0 on success. */
+#define FS_HEADER_BYTES 64
+int fs_write(const fs_circuit_t *c, const fs_grid_t *g, const char *path);
+
+/* Interactive prompts behind the capacitor / inductor menus */
+void sweep_dialog(void);
+
+#endif
@@ -1,6 +1,11 @@
-#ifndef INDUCTOR_CALC_H
-#define INDUCTOR_CALC_H
-
-void inductor_menu(void);
-
-#endif
+#ifndef INDUCTOR_CALC_H
+#define INDUCTOR_CALC_H
+
+#include <stddef.h>
+
+void inductor_menu(void);
+
+/* Decode an inductor marking (4R7, 101, ...) to henries; 0 if invalid */
+int smd_inductor_value(const char *code, size_t len, double *henries);
+
+#endif
@@ -0,0 +1,511 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "parallel.h"
+#include "logic_sim.h"
+
+/* 256 vectors per group: the interpreter runs every instruction on four
+   64-bit words at once so that dispatch is paid once per 256 vectors */
+typedef uint64_t ls_word_t __attribute__((vector_size(32)));
+
+#define GROUP_VECTORS 256
+#define NAME_LEN      32
+#define MAX_FANIN     64
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LS_X86 1
+#endif
+
+enum { OP_AND, OP_OR, OP_XOR, OP_NOT, OP_ANDN, OP_COPY };
+
+typedef struct {
+    unsigned char op;
+    int dst, a, b;
+} ls_insn_t;
+
+struct logic_sim {
+    int n_nets, n_slots;
+    char (*names)[NAME_LEN];
+    int n_inputs, *inputs;
+    unsigned char *held;            /* LSIM_HOLD values per input */
+    int n_outputs, *outputs;
+    int n_flops, *flop_q, *flop_next;
+    int n_code;
+    ls_insn_t *code;                /* gates in level order, then next states */
+    int const0, const1;             /* slots of nets "0" / "1", or -1 */
+
+    int n_groups;                   /* of the last lsim_run */
+    ls_word_t *final;               /* n_groups x n_outputs */
+};
+
+/* ────────────────────────────────────────────────
+   NETLIST PARSING
+   ──────────────────────────────────────────────── */
+
+/* Element kinds: gates, then flops */
+enum { EL_AND, EL_OR, EL_NAND, EL_NOR, EL_XOR, EL_XNOR, EL_NOT, EL_BUF,
+       EL_DFF, EL_TFF, EL_JKFF, EL_SRFF, EL_COUNT };
+
+static const char *const el_names[EL_COUNT] = {
+    "AND", "OR", "NAND", "NOR", "XOR", "XNOR", "NOT", "BUF", "DFF", "TFF", "JKFF", "SRFF"
+};
+
+static int el_arity(int kind) {        /* -1 = one or more */
+    if (kind <= EL_XNOR) return -1;
+    if (kind <= EL_TFF) return 1;
+    return 2;
+}
+
+typedef struct {
+    int kind, out, first, n_in;        /* inputs at pins[first..first+n_in) */
+} element_t;
+
+typedef struct {
+    logic_sim_t *s;
+    int cap_nets, cap_inputs, cap_outputs;
+    int *slot;                          /* open-addressing name table */
+    int cap_slot;
+    element_t *el;
+    int n_el, cap_el;
+    int *pins;
+    int n_pins, cap_pins;
+    int line_no;
+} builder_t;
+
+static unsigned hash_name(const char *s) {
+    unsigned h = 2166136261u;
+    while (*s) h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+static int grow(void **p, int *cap, int need, size_t size) {
+    if (need <= *cap) return 1;
+    int c = *cap ? *cap : 64;
+    while (c < need) c *= 2;
+    void *b = realloc(*p, (size_t)c * size);
+    if (!b) return 0;
+    *p = b;
+    *cap = c;
+    return 1;
+}
+
+/* Net number for a name, created on first use; -1 when out of memory */
+static int net_id(builder_t *b, const char *name) {
+    logic_sim_t *s = b->s;
+    unsigned i = hash_name(name) & (b->cap_slot - 1);
+    while (b->slot[i] >= 0) {
+        if (strcmp(s->names[b->slot[i]], name) == 0) return b->slot[i];
+        i = (i + 1) & (b->cap_slot - 1);
+    }
+    if (!grow((void **)&s->names, &b->cap_nets, s->n_nets + 1, NAME_LEN)) return -1;
+    int id = s->n_nets++;
+    strcpy(s->names[id], name);
+    b->slot[i] = id;
+
+    if (s->n_nets * 2 > b->cap_slot) {      /* grow and rehash */
+        int *bigger = malloc(2 * b->cap_slot * sizeof(int));
+        if (!bigger) return -1;
+        free(b->slot);
+        b->slot = bigger;
+        b->cap_slot *= 2;
+        memset(b->slot, -1, b->cap_slot * sizeof(int));
+        for (int n = 0; n < s->n_nets; n++) {
+            unsigned j = hash_name(s->names[n]) & (b->cap_slot - 1);
+            while (b->slot[j] >= 0) j = (j + 1) & (b->cap_slot - 1);
+            b->slot[j] = n;
+        }
+    }
+    return id;
+}
+
+static int parse_line(builder_t *b, char *line) {
+    logic_sim_t *s = b->s;
+    char *tok[MAX_FANIN + 2];
+    int n_tok = 0;
+    for (char *t = strtok(line, " \t\r\n,"); t; t = strtok(NULL, " \t\r\n,")) {
+        if (t[0] == '#') break;
+        if (n_tok == MAX_FANIN + 2) { printf("Line %d: more than %d inputs.\n", b->line_no, MAX_FANIN); return 0; }
+        if (strlen(t) >= NAME_LEN) { printf("Line %d: name \"%s\" too long.\n", b->line_no, t); return 0; }
+        tok[n_tok++] = t;
+    }
+    if (n_tok == 0) return 1;
+
+    int is_in = strcasecmp(tok[0], "INPUT") == 0, is_out = strcasecmp(tok[0], "OUTPUT") == 0;
+    if (is_in || is_out) {
+        int **list = is_in ? &s->inputs : &s->outputs, *count = is_in ? &s->n_inputs : &s->n_outputs;
+        int *cap = is_in ? &b->cap_inputs : &b->cap_outputs;
+        for (int k = 1; k < n_tok; k++) {
+            int id = net_id(b, tok[k]);
+            if (id < 0 || !grow((void **)list, cap, *count + 1, sizeof(int))) return 0;
+            (*list)[(*count)++] = id;
+        }
+        return 1;
+    }
+
+    int kind = 0;
+    while (kind < EL_COUNT && strcasecmp(tok[0], el_names[kind]) != 0) kind++;
+    if (kind == EL_COUNT) { printf("Line %d: unknown element \"%s\".\n", b->line_no, tok[0]); return 0; }
+    int n_in = n_tok - 2, arity = el_arity(kind);
+    if (n_in < 1 || (arity > 0 && n_in != arity)) {
+        printf("Line %d: %s takes %s%d input%s.\n", b->line_no, el_names[kind],
+               arity < 0 ? "at least " : "", arity < 0 ? 1 : arity, arity == 1 || arity < 0 ? "" : "s");
+        return 0;
+    }
+
+    if (!grow((void **)&b->el, &b->cap_el, b->n_el + 1, sizeof(element_t)) ||
+        !grow((void **)&b->pins, &b->cap_pins, b->n_pins + n_in, sizeof(int))) return 0;
+    element_t *e = &b->el[b->n_el++];
+    e->kind = kind;
+    e->out = net_id(b, tok[1]);
+    e->first = b->n_pins;
+    e->n_in = n_in;
+    for (int k = 0; k < n_in; k++) b->pins[b->n_pins++] = net_id(b, tok[2 + k]);
+    if (e->out < 0) return 0;
+    for (int k = 0; k < n_in; k++) if (b->pins[e->first + k] < 0) return 0;
+    return 1;
+}
+
+static void emit(logic_sim_t *s, int op, int dst, int a, int b) {
+    ls_insn_t *in = &s->code[s->n_code++];
+    in->op = (unsigned char)op;
+    in->dst = dst;
+    in->a = a;
+    in->b = b;
+}
+
+static void emit_gate(logic_sim_t *s, const element_t *e, const int *pins) {
+    static const int chain_op[6] = { OP_AND, OP_OR, OP_AND, OP_OR, OP_XOR, OP_XOR };
+    const int *in = pins + e->first;
+    if (e->kind == EL_NOT) { emit(s, OP_NOT, e->out, in[0], 0); return; }
+    if (e->kind == EL_BUF || e->n_in == 1) emit(s, OP_COPY, e->out, in[0], 0);
+    else {
+        emit(s, chain_op[e->kind], e->out, in[0], in[1]);
+        for (int k = 2; k < e->n_in; k++) emit(s, chain_op[e->kind], e->out, e->out, in[k]);
+    }
+    if (e->kind == EL_NAND || e->kind == EL_NOR || e->kind == EL_XNOR)
+        emit(s, OP_NOT, e->out, e->out, 0);
+}
+
+/* Levelize the gates and emit the program: gates in dependency order,
+   then every flop's next state into its own slot */
+static int compile(builder_t *b) {
+    logic_sim_t *s = b->s;
+    int n = s->n_nets, n_el = b->n_el, ok = 0;
+    int *driver = malloc((n + 1) * sizeof(int));          /* element, -1 source, -2 none */
+    int *pending = calloc(n_el + 1, sizeof(int));
+    int *user_start = calloc(n + 2, sizeof(int));
+    int *users = malloc((b->n_pins + 1) * sizeof(int));
+    int *queue = malloc((n_el + 1) * sizeof(int));
+    if (!driver || !pending || !user_start || !users || !queue) goto done;
+
+    for (int i = 0; i < n; i++) driver[i] = -2;
+    s->const0 = s->const1 = -1;
+    for (int i = 0; i < n; i++) {
+        if (strcmp(s->names[i], "0") == 0) { s->const0 = i; driver[i] = -1; }
+        if (strcmp(s->names[i], "1") == 0) { s->const1 = i; driver[i] = -1; }
+    }
+    for (int i = 0; i < s->n_inputs; i++) {
+        int id = s->inputs[i];
+        if (driver[id] != -2) { printf("Input %s is declared twice or is a constant.\n", s->names[id]); goto done; }
+        driver[id] = -1;
+    }
+    for (int e = 0; e < n_el; e++) {
+        int o = b->el[e].out;
+        if (driver[o] != -2) { printf("Net %s has more than one driver.\n", s->names[o]); goto done; }
+        driver[o] = e;
+    }
+    for (int p = 0; p < b->n_pins; p++)
+        if (driver[b->pins[p]] == -2) { printf("Net %s has no driver.\n", s->names[b->pins[p]]); goto done; }
+    for (int i = 0; i < s->n_outputs; i++)
+        if (driver[s->outputs[i]] == -2) { printf("Output %s has no driver.\n", s->names[s->outputs[i]]); goto done; }
+
+    /* Gate -> gate dependencies; flops and inputs are level-0 sources */
+    int n_gates = 0, n_code = 0;
+    s->n_flops = 0;
+    for (int e = 0; e < n_el; e++) {
+        const element_t *el = &b->el[e];
+        if (el->kind >= EL_DFF) { s->n_flops++; n_code += 3; continue; }
+        n_gates++;
+        n_code += el->n_in + 1;
+        for (int k = 0; k < el->n_in; k++) {
+            int src = driver[b->pins[el->first + k]];
+            if (src >= 0 && b->el[src].kind < EL_DFF) {
+                pending[e]++;
+                user_start[b->pins[el->first + k] + 1]++;
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) user_start[i + 1] += user_start[i];
+    for (int e = 0; e < n_el; e++) {
+        const element_t *el = &b->el[e];
+        if (el->kind >= EL_DFF) continue;
+        for (int k = 0; k < el->n_in; k++) {
+            int net = b->pins[el->first + k], src = driver[net];
+            if (src >= 0 && b->el[src].kind < EL_DFF) users[user_start[net]++] = e;
+        }
+    }
+    for (int i = n; i > 0; i--) user_start[i] = user_start[i - 1];   /* undo the fill shift */
+    user_start[0] = 0;
+
+    /* One scratch slot after the nets, then the flops' next states */
+    s->n_slots = n + 1 + s->n_flops;
+    s->code = malloc((n_code + 1) * sizeof(ls_insn_t));
+    s->flop_q = malloc((s->n_flops + 1) * sizeof(int));
+    s->flop_next = malloc((s->n_flops + 1) * sizeof(int));
+    if (!s->code || !s->flop_q || !s->flop_next) goto done;
+
+    int head = 0, tail = 0;
+    for (int e = 0; e < n_el; e++)
+        if (b->el[e].kind < EL_DFF && pending[e] == 0) queue[tail++] = e;
+    while (head < tail) {
+        const element_t *el = &b->el[queue[head++]];
+        emit_gate(s, el, b->pins);
+        for (int u = user_start[el->out]; u < user_start[el->out + 1]; u++)
+            if (--pending[users[u]] == 0) queue[tail++] = users[u];
+    }
+    if (tail < n_gates) {
+        for (int e = 0; e < n_el; e++)
+            if (b->el[e].kind < EL_DFF && pending[e] > 0) {
+                printf("Combinational loop through net %s.\n", s->names[b->el[e].out]);
+                break;
+            }
+        goto done;
+    }
+
+    int scratch = n, f = 0;
+    for (int e = 0; e < n_el; e++) {
+        const element_t *el = &b->el[e];
+        if (el->kind < EL_DFF) continue;
+        const int *in = b->pins + el->first;
+        int q = el->out, next = n + 1 + f;
+        switch (el->kind) {
+            case EL_DFF: emit(s, OP_COPY, next, in[0], 0); break;
+            case EL_TFF: emit(s, OP_XOR, next, q, in[0]); break;
+            case EL_JKFF:                                   /* J·Q' + K'·Q */
+                emit(s, OP_ANDN, scratch, q, in[1]);
+                emit(s, OP_ANDN, next, in[0], q);
+                emit(s, OP_OR, next, next, scratch);
+                break;
+            default:                                        /* S + R'·Q */
+                emit(s, OP_ANDN, next, q, in[1]);
+                emit(s, OP_OR, next, next, in[0]);
+                break;
+        }
+        s->flop_q[f] = q;
+        s->flop_next[f++] = next;
+    }
+    ok = 1;
+
+done:
+    free(driver); free(pending); free(user_start); free(users); free(queue);
+    return ok;
+}
+
+logic_sim_t *lsim_parse(const char *text) {
+    logic_sim_t *s = calloc(1, sizeof(*s));
+    builder_t b = { s, 0, 0, 0, malloc(256 * sizeof(int)), 256, NULL, 0, 0, NULL, 0, 0, 0 };
+    char *copy = s ? strdup(text) : NULL;
+    int ok = s && b.slot && copy;
+
+    if (ok) memset(b.slot, -1, b.cap_slot * sizeof(int));
+    for (char *line = copy; ok && line; ) {
+        char *end = strchr(line, '\n');
+        if (end) *end = '\0';
+        b.line_no++;
+        ok = parse_line(&b, line);
+        line = end ? end + 1 : NULL;
+    }
+    if (ok && s->n_outputs == 0) { printf("Netlist has no OUTPUT line.\n"); ok = 0; }
+    if (ok) ok = compile(&b);
+    if (ok) ok = (s->held = calloc(s->n_inputs + 1, 1)) != NULL;
+
+    free(copy); free(b.slot); free(b.el); free(b.pins);
+    if (!ok) { lsim_free(s); return NULL; }
+    return s;
+}
+
+logic_sim_t *lsim_load(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) { printf("Error: cannot open %s\n", path); return NULL; }
+    size_t len = 0, cap = 4096;
+    char *text = malloc(cap);
+    size_t got;
+    while (text && (got = fread(text + len, 1, cap - len - 1, f)) > 0) {
+        len += got;
+        if (len + 1 == cap) {
+            char *bigger = realloc(text, cap *= 2);
+            if (!bigger) free(text);
+            text = bigger;
+        }
+    }
+    fclose(f);
+    if (!text) { printf("Out of memory.\n"); return NULL; }
+    text[len] = '\0';
+    logic_sim_t *s = lsim_parse(text);
+    free(text);
+    return s;
+}
+
+void lsim_free(logic_sim_t *s) {
+    if (!s) return;
+    free(s->names); free(s->inputs); free(s->held); free(s->outputs);
+    free(s->flop_q); free(s->flop_next); free(s->code); free(s->final);
+    free(s);
+}
+
+int lsim_inputs(const logic_sim_t *s) { return s->n_inputs; }
+int lsim_outputs(const logic_sim_t *s) { return s->n_outputs; }
+int lsim_flops(const logic_sim_t *s) { return s->n_flops; }
+int lsim_instructions(const logic_sim_t *s) { return s->n_code; }
+const char *lsim_input_name(const logic_sim_t *s, int i) { return s->names[s->inputs[i]]; }
+const char *lsim_output_name(const logic_sim_t *s, int i) { return s->names[s->outputs[i]]; }
+
+void lsim_set_input(logic_sim_t *s, int i, int value) {
+    if (i >= 0 && i < s->n_inputs) s->held[i] = value != 0;
+}
+
+/* ────────────────────────────────────────────────
+   SIMULATION
+   ──────────────────────────────────────────────── */
+
+static inline __attribute__((always_inline))
+void run_code(const logic_sim_t *s, ls_word_t *slots) {
+    for (int k = 0; k < s->n_code; k++) {
+        const ls_insn_t *in = &s->code[k];
+        ls_word_t a = slots[in->a], b = slots[in->b];
+        switch (in->op) {
+            case OP_AND:  slots[in->dst] = a & b; break;
+            case OP_OR:   slots[in->dst] = a | b; break;
+            case OP_XOR:  slots[in->dst] = a ^ b; break;
+            case OP_NOT:  slots[in->dst] = ~a; break;
+            case OP_ANDN: slots[in->dst] = a & ~b; break;
+            default:      slots[in->dst] = a; break;
+        }
+    }
+}
+
+static void run_code_generic(const logic_sim_t *s, ls_word_t *slots) {
+    run_code(s, slots);
+}
+
+#ifdef LS_X86
+__attribute__((target("avx2")))
+static void run_code_avx2(const logic_sim_t *s, ls_word_t *slots) {
+    run_code(s, slots);
+}
+#endif
+
+typedef void (*run_fn)(const logic_sim_t *s, ls_word_t *slots);
+
+static run_fn pick_run_fn(void) {
+#ifdef LS_X86
+    if (__builtin_cpu_supports("avx2")) return run_code_avx2;
+#endif
+    return run_code_generic;
+}
+
+/* Random stimulus bits for 64 vectors: a hash of seed, word, cycle and
+   input, so any vector can be replayed on its own */
+static uint64_t stimulus_word(uint64_t seed, uint64_t word, uint64_t cycle, int n_inputs, int input) {
+    uint64_t z = seed ^ (word * 0x9E3779B97F4A7C15ull) ^ ((cycle * n_inputs + input + 1) * 0xD1B54A32D192ED03ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static int slot_bit(const ls_word_t *slots, int slot) { return (int)(slots[slot][0] & 1); }
+
+static void print_trace_row(const logic_sim_t *s, FILE *f, uint64_t cycle, const ls_word_t *slots) {
+    fprintf(f, "%8llu ", (unsigned long long)cycle);
+    for (int i = 0; i < s->n_inputs; i++)
+        fprintf(f, " %*d", (int)strlen(lsim_input_name(s, i)), slot_bit(slots, s->inputs[i]));
+    fprintf(f, " |");
+    for (int i = 0; i < s->n_outputs; i++)
+        fprintf(f, " %*d", (int)strlen(lsim_output_name(s, i)), slot_bit(slots, s->outputs[i]));
+    fputc('\n', f);
+}
+
+/* Simulate one group of 256 vectors from reset; returns 0 on success */
+static int simulate_group(const logic_sim_t *s, run_fn run, uint64_t group, uint64_t n_cycles,
+                          int stimulus, uint64_t seed, FILE *trace, ls_word_t *final) {
+    ls_word_t *slots = aligned_alloc(32, (size_t)s->n_slots * sizeof(ls_word_t));
+    if (!slots) return 1;
+    const ls_word_t zero = { 0, 0, 0, 0 };
+    for (int i = 0; i < s->n_slots; i++) slots[i] = zero;
+    if (s->const1 >= 0) slots[s->const1] = ~zero;
+    for (int i = 0; i < s->n_inputs; i++) if (s->held[i]) slots[s->inputs[i]] = ~zero;
+
+    for (uint64_t c = 0; c < n_cycles; c++) {
+        if (stimulus == LSIM_RANDOM)
+            for (int i = 0; i < s->n_inputs; i++)
+                for (int u = 0; u < 4; u++)
+                    slots[s->inputs[i]][u] = stimulus_word(seed, group * 4 + u, c, s->n_inputs, i);
+        run(s, slots);
+        if (trace) print_trace_row(s, trace, c, slots);
+        for (int f = 0; f < s->n_flops; f++) slots[s->flop_q[f]] = slots[s->flop_next[f]];
+    }
+
+    /* Outputs after the last edge */
+    if (final) {
+        run(s, slots);
+        for (int o = 0; o < s->n_outputs; o++) final[o] = slots[s->outputs[o]];
+    }
+    free(slots);
+    return 0;
+}
+
+typedef struct {
+    const logic_sim_t *s;
+    run_fn run;
+    uint64_t n_cycles, seed;
+    int stimulus, failed;
+} run_job_t;
+
+static void run_task(void *ctx, int task) {
+    run_job_t *job = ctx;
+    const logic_sim_t *s = job->s;
+    if (simulate_group(s, job->run, task, job->n_cycles, job->stimulus, job->seed, NULL,
+                       s->final + (size_t)task * s->n_outputs))
+        job->failed = 1;
+}
+
+int lsim_run(logic_sim_t *s, int n_vectors, uint64_t n_cycles, int stimulus, uint64_t seed) {
+    if (n_vectors > LSIM_MAX_VECTORS) return 1;
+    int n_groups = n_vectors > 0 ? (n_vectors + GROUP_VECTORS - 1) / GROUP_VECTORS : 1;
+    free(s->final);
+    s->n_groups = 0;
+    s->final = aligned_alloc(32, (size_t)n_groups * s->n_outputs * sizeof(ls_word_t));
+    if (!s->final) return 1;
+
+    run_job_t job = { s, pick_run_fn(), n_cycles, seed, stimulus, 0 };
+    par_for(n_groups, run_task, &job);
+    if (job.failed) return 1;
+    s->n_groups = n_groups;
+    return 0;
+}
+
+int lsim_output(const logic_sim_t *s, int i, int vector) {
+    int g = vector / GROUP_VECTORS, lane = vector % GROUP_VECTORS;
+    if (i < 0 || i >= s->n_outputs || vector < 0 || g >= s->n_groups) return 0;
+    return (int)((s->final[(size_t)g * s->n_outputs + i][lane / 64] >> (lane % 64)) & 1);
+}
+
+uint64_t lsim_output_count(const logic_sim_t *s, int i) {
+    uint64_t count = 0;
+    if (i < 0 || i >= s->n_outputs) return 0;
+    for (int g = 0; g < s->n_groups; g++)
+        for (int u = 0; u < 4; u++)
+            count += __builtin_popcountll(s->final[(size_t)g * s->n_outputs + i][u]);
+    return count;
+}
+
+void lsim_trace(logic_sim_t *s, FILE *f, uint64_t n_cycles, int stimulus, uint64_t seed) {
+    fprintf(f, "   cycle ");
+    for (int i = 0; i < s->n_inputs; i++) fprintf(f, " %s", lsim_input_name(s, i));
+    fprintf(f, " |");
+    for (int i = 0; i < s->n_outputs; i++) fprintf(f, " %s", lsim_output_name(s, i));
+    fputc('\n', f);
+    if (simulate_group(s, pick_run_fn(), 0, n_cycles, stimulus, seed, f, NULL))
+        fprintf(f, "Out of memory.\n");
+}
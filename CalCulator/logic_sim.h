@@ -0,0 +1,60 @@
+#ifndef LOGIC_SIM_H
+#define LOGIC_SIM_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Cycle-based simulation of clocked circuits (counters, shift registers,
+   state machines). All flip-flops share one clock; every cycle the
+   combinational logic settles and then every flop loads its next state.
+
+   Netlist: one element per line, "<TYPE> <output net> <input nets...>",
+   plus INPUT / OUTPUT lines listing nets, e.g.
+       # 2-bit counter with enable
+       INPUT  en
+       OUTPUT q0 q1
+       TFF    q0 en
+       AND    c1 en q0
+       TFF    q1 c1
+   Gates: AND OR NAND NOR XOR XNOR (any number of inputs), NOT BUF.
+   Flops (reset to 0): DFF q d, TFF q t, JKFF q j k, SRFF q s r (S=R=1,
+   forbidden on a real SR flop, is treated as set). Nets "0" and "1" are
+   constants. The netlist is levelized into straight-line bit-parallel
+   code; each machine word carries 64 independent stimulus vectors. */
+
+typedef struct logic_sim logic_sim_t;
+
+/* NULL (after printing why) on a bad netlist or combinational loop */
+logic_sim_t *lsim_parse(const char *text);
+logic_sim_t *lsim_load(const char *path);
+void lsim_free(logic_sim_t *s);
+
+int lsim_inputs(const logic_sim_t *s);
+int lsim_outputs(const logic_sim_t *s);
+int lsim_flops(const logic_sim_t *s);
+int lsim_instructions(const logic_sim_t *s);
+const char *lsim_input_name(const logic_sim_t *s, int i);
+const char *lsim_output_name(const logic_sim_t *s, int i);
+
+#define LSIM_HOLD   0           /* inputs keep the values from lsim_set_input */
+#define LSIM_RANDOM 1           /* fresh random input bits every cycle */
+
+void lsim_set_input(logic_sim_t *s, int i, int value);
+
+#define LSIM_MAX_VECTORS (1 << 30)
+
+/* Simulate n_vectors independent copies (rounded up to a multiple of 256)
+   for n_cycles from reset, in parallel. Random stimulus depends only on
+   seed, vector and cycle, never on the thread count. Returns 0 on
+   success, 1 if out of memory or n_vectors > LSIM_MAX_VECTORS. */
+int lsim_run(logic_sim_t *s, int n_vectors, uint64_t n_cycles, int stimulus, uint64_t seed);
+
+/* After lsim_run: output i of a vector, and how many vectors have it set */
+int lsim_output(const logic_sim_t *s, int i, int vector);
+uint64_t lsim_output_count(const logic_sim_t *s, int i);
+
+/* Print inputs and outputs of vector 0 for the first n_cycles, one line
+   per cycle, as seen just before each clock edge */
+void lsim_trace(logic_sim_t *s, FILE *f, uint64_t n_cycles, int stimulus, uint64_t seed);
+
+#endif
@@ -1,53 +1,124 @@
-#include <stdio.h>
-#include "math_ops.h"
-#include "ohms_law.h"
-#include "inductor_calc.h"
-#include "resistor_calc.h"
-#include "capacitor_calc.h"
-
-
-
-
-int main(void) {
-    int choice;
-
-    do {
-        printf("\n==== ELECTRONICS CALCULATOR ====\n");
-        printf("5. Inductor Calculations\n");
-        printf("4. Capacitor Calculations\n");
-        printf("3. Resistor Calculations\n");
-        printf("2. Ohm's Law & Power\n");
-        printf("1. Mathematical Operations\n");
-        printf("0. Exit\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-
-        switch(choice) {
-            case 5:
-                 inductor_menu();
-                  break;
-
-            case 4:
-                capacitor_menu();
-                break;
-
-            case 3:
-                resistor_menu();
-                break;
-            case 2: 
-                ohms_menu(); 
-                break;
-            case 1:
-                math_menu();
-                break;
-            case 0:
-                printf("Exiting program...\n");
-                break;
-            default:
-                printf("Invalid option.\n");
-        }
-
-    } while(choice != 0);
-
-    return 0;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "math_ops.h"
+#include "ohms_law.h"
+#include "inductor_calc.h"
+#include "resistor_calc.h"
+#include "capacitor_calc.h"
+#include "digital_logic.h"
+#include "batch_mode.h"
+#include "expr_jit.h"
+#include "serve.h"
+#include "shm_ring.h"
+#include "bom_decode.h"
+#include "num_convert.h"
+#include "parallel.h"
+
+
+
+
+static void usage(const char *prog) {
+    printf("Usage: %s                      interactive menus\n", prog);
+    printf("       %s --batch IN [OUT]     one result line per request line\n", prog);
+    printf("       %s --bom IN [OUT]       decode a code,type (R/C/L) marking list\n", prog);
+    printf("       %s --convert IN [OUT]   rewrite every number in a file in another base\n", prog);
+    printf("       %s --serve SOCKET       answer requests on a Unix socket until Ctrl+C\n", prog);
+    printf("       %s --shm NAME           answer binary requests over shared memory (shm_ring.h)\n", prog);
+    printf("Options: --threads N   worker threads for batch work (default: all CPUs)\n");
+    printf("         --from B      base of the numbers in IN: 2, 8, 10, 16 or 0 = by prefix (default)\n");
+    printf("         --to B        base to write for --convert (default 16)\n");
+    printf("         --prefix      write 0x / 0b / 0 prefixes\n");
+    printf("         --no-jit      evaluate expressions with the interpreter, not native code\n");
+    printf("('-' means stdin/stdout)\n\n");
+    batch_print_help();
+}
+
+int main(int argc, char **argv) {
+    int choice;
+    const char *batch_in = NULL, *batch_out = "-";
+    const char *serve_path = NULL, *shm_name = NULL;
+    int mode = 0;                       /* 0 batch, 1 bom, 2 convert */
+    int from = NUM_AUTO, to = 16, flags = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            par_set_threads(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            from = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            to = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve_path = argv[++i];
+        } else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (strcmp(argv[i], "--no-jit") == 0) {
+            expr_jit_set_enabled(0);
+        } else if (strcmp(argv[i], "--prefix") == 0) {
+            flags |= NUM_PREFIX;
+        } else if ((strcmp(argv[i], "--batch") == 0 || strcmp(argv[i], "--bom") == 0 ||
+                    strcmp(argv[i], "--convert") == 0) && i + 1 < argc) {
+            mode = strcmp(argv[i], "--bom") == 0 ? 1 : strcmp(argv[i], "--convert") == 0 ? 2 : 0;
+            batch_in = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') batch_out = argv[++i];
+            else if (i + 1 < argc && strcmp(argv[i + 1], "-") == 0) batch_out = argv[++i];
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (serve_path)
+        return serve_run(serve_path);
+    if (shm_name)
+        return shm_serve(shm_name);
+    if (batch_in)
+        return mode == 1 ? bom_run(batch_in, batch_out)
+             : mode == 2 ? num_convert_file(batch_in, batch_out, from, to, flags)
+             : batch_run(batch_in, batch_out);
+
+    do {
+        printf("\n==== ELECTRONICS CALCULATOR ====\n");
+        printf("6. Digital Logic\n");
+        printf("5. Inductor Calculations\n");
+        printf("4. Capacitor Calculations\n");
+        printf("3. Resistor Calculations\n");
+        printf("2. Ohm's Law & Power\n");
+        printf("1. Mathematical Operations\n");
+        printf("0. Exit\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+
+        switch(choice) {
+            case 6:
+                digital_menu();
+                break;
+
+            case 5:
+                 inductor_menu();
+                  break;
+
+            case 4:
+                capacitor_menu();
+                break;
+
+            case 3:
+                resistor_menu();
+                break;
+            case 2: 
+                ohms_menu(); 
+                break;
+            case 1:
+                math_menu();
+                break;
+            case 0:
+                printf("Exiting program...\n");
+                break;
+            default:
+                printf("Invalid option.\n");
+        }
+
+    } while(choice != 0);
+
+    return 0;
+}
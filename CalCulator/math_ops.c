@@ -1,257 +1,542 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include "math_ops.h"
-#include <math.h>
-
-float power(float base, float exp) { return powf(base, exp); }
-float sqroot(float x) { return sqrtf(x); }
-float log10_val(float x) { return log10f(x); }
-
-/* 🔹 Convert a string like "4.7k", "10M", "2.2u", etc. to a float */
-float parse_with_prefix(const char *input)
-{
-    float value = 0.0;
-    char suffix = '\0';
-    char cleaned[20];
-    int i = 0;
-
-    // Step 1: Clean input — stop at first non-digit/non-dot/non-letter
-    while (input[i] && (isdigit(input[i]) || input[i] == '.' || isalpha(input[i])))
-    {
-        cleaned[i] = input[i];
-        i++;
-    }
-    cleaned[i] = '\0';
-
-    // Step 2: Extract number and optional suffix
-    int n = sscanf(cleaned, "%f%c", &value, &suffix);
-
-    if (n == 1)
-        return value; // no suffix
-    if (n != 2)
-        return value; // fallback
-
-    // Step 3: Normalize suffix to lowercase for simplicity
-    if (suffix == 'U')
-        suffix = 'u';
-    if (suffix == 'K')
-        suffix = 'k';
-    if (suffix == 'M')
-        suffix = 'M'; // keep M as Mega, lowercase m is milli
-
-    // Step 4: Apply multiplier
-    switch (suffix)
-    {
-    case 'T':
-        return value * 1e12; // tera
-    case 'G':
-        return value * 1e9; // giga
-    case 'M':
-        return value * 1e6; // mega
-    case 'k':
-        return value * 1e3; // kilo
-    case 'm':
-        return value * 1e-3; // milli
-    case 'u':
-        return value * 1e-6; // micro
-    case 'n':
-        return value * 1e-9; // nano
-    case 'p':
-        return value * 1e-12; // pico
-    case 'f':
-        return value * 1e-15; // femto
-    default:
-        return value; // unknown or none
-    }
-}
-
-void print_with_prefix(float value, const char *unit)
-{
-    const char *prefix;
-    double display_value;
-
-    if (value == 0.0f)
-    {
-        printf("0 %s\n", unit);
-        return;
-    }
-
-    if (value >= 1e12)
-    {
-        prefix = "T";
-        display_value = value / 1e12;
-    }
-    else if (value >= 1e9)
-    {
-        prefix = "G";
-        display_value = value / 1e9;
-    }
-    else if (value >= 1e6)
-    {
-        prefix = "M";
-        display_value = value / 1e6;
-    }
-    else if (value >= 1e3)
-    {
-        prefix = "k";
-        display_value = value / 1e3;
-    }
-    else if (value >= 1)
-    {
-        prefix = "";
-        display_value = value;
-    }
-    else if (value >= 1e-3)
-    {
-        prefix = "m";
-        display_value = value * 1e3;
-    }
-    else if (value >= 1e-6)
-    {
-        prefix = "µ";
-        display_value = value * 1e6;
-    }
-    else if (value >= 1e-9)
-    {
-        prefix = "n";
-        display_value = value * 1e9;
-    }
-    else if (value >= 1e-12)
-    {
-        prefix = "p";
-        display_value = value * 1e12;
-    }
-    else
-    {
-        prefix = "f";
-        display_value = value * 1e15;
-    }
-
-    printf("%.4f %s%s\n", display_value, prefix, unit);
-}
-
-/* 🔹 Basic math functions */
-float add(float a, float b) { return a + b; }
-float sub(float a, float b) { return a - b; }
-float mul(float a, float b) { return a * b; }
-
-float div_safe(float a, float b, int *ok)
-{
-    if (b == 0)
-    {
-        *ok = 0;
-        return 0.0;
-    }
-    *ok = 1;
-    return a / b;
-}
-
-/* 🔹 Interactive Math Menu */
-void math_menu(void)
-{
-    int choice;
-    char input1[20], input2[20];
-    float a, b, result;
-    int ok;
-
-    do
-    {
-        printf("\n==== MATHEMATICAL OPERATIONS ====\n");
-        printf("1. Addition\n");
-        printf("2. Subtraction\n");
-        printf("3. Multiplication\n");
-        printf("4. Division\n");
-        printf("0. Return to Main Menu\n");
-        printf("5. Power (x^y)\n");
-        printf("6. Square Root\n");
-        printf("7. Logarithm (base 10)\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        getchar(); // consume newline
-
-        if (choice == 0)
-            break;
-        if (choice >= 1 && choice <= 5)
-        {
-            printf("Enter first value (supports T,G,M,k,m,u,n,p,f): ");
-            scanf("%s", input1);
-            printf("Enter second value (supports T,G,M,k,m,u,n,p,f): ");
-            scanf("%s", input2);
-            a = parse_with_prefix(input1);
-            b = parse_with_prefix(input2);
-        }
-
-        switch (choice)
-        {
-        case 1: // Addition
-            result = add(a, b);
-            printf("Result = ");
-            print_with_prefix(result, "");
-            break;
-
-        case 2: // Subtraction
-            result = sub(a, b);
-            printf("Result = ");
-            print_with_prefix(result, "");
-            break;
-
-        case 3: // Multiplication
-            result = mul(a, b);
-            printf("Result = ");
-            print_with_prefix(result, "");
-            break;
-
-        case 4: // Division
-            result = div_safe(a, b, &ok);
-            if (ok)
-            {
-                printf("Result = ");
-                print_with_prefix(result, "");
-            }
-            else
-            {
-                printf("Error: Division by zero!\n");
-            }
-            break;
-
-        case 5: // Power (x^y)
-            result = power(a, b);
-            printf("Result = ");
-            print_with_prefix(result, "");
-            break;
-
-        case 6: // Square Root
-            printf("Enter value (supports prefixes): ");
-            scanf("%s", input1);
-            a = parse_with_prefix(input1);
-            if (a < 0)
-                printf("Error: Cannot take square root of a negative number!\n");
-            else
-            {
-                result = sqroot(a);
-                printf("√(%.4f) = ", a);
-                print_with_prefix(result, "");
-            }
-            break;
-
-        case 7: // Logarithm (base 10)
-            printf("Enter value (supports prefixes): ");
-            scanf("%s", input1);
-            a = parse_with_prefix(input1);
-            if (a <= 0)
-                printf("Error: Logarithm undefined for zero or negative numbers!\n");
-            else
-            {
-                result = log10_val(a);
-                printf("log10(%.4f) = %.6f\n", a, result);
-            }
-            break;
-
-        default:
-            printf("Invalid choice!\n");
-        }
-
-    } while (choice != 0);
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include "math_ops.h"
+#include "reduce.h"
+#include <math.h>
+
+float power(float base, float exp) { return powf(base, exp); }
+float sqroot(float x) { return sqrtf(x); }
+float log10_val(float x) { return log10f(x); }
+
+/* 🔹 Exact powers of ten: any integer below 2^53 scaled by one of these is
+   correctly rounded (one IEEE multiply or divide of two exact values) */
+static const double pow10_exact[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Rare slow path (more than 19 significant digits, or a value outside the
+   exact fast path): copy the digits of s[begin..end) without the point
+   into "<digits>e<exp>" and let strtod do the correct rounding. */
+static double slow_decimal(const char *s, size_t begin, size_t end, int exp10)
+{
+    char buf[800];
+    int k = 0, n = 0;
+    char digits[12];
+
+    for (size_t i = begin; i < end; i++)
+    {
+        if (s[i] == '.') continue;
+        if (k < (int)sizeof(buf) - 16) buf[k++] = s[i];
+        else if (s[i] != '0') { buf[k - 1] |= 1; exp10++; } // beyond double resolution: sticky
+        else exp10++;
+    }
+    buf[k++] = 'e';
+    if (exp10 < 0) { buf[k++] = '-'; exp10 = -exp10; }
+    do { digits[n++] = (char)('0' + exp10 % 10); exp10 /= 10; } while (exp10);
+    while (n) buf[k++] = digits[--n];
+    buf[k] = '\0';
+    return strtod(buf, NULL);
+}
+
+/* 🔹 Parse "4.7k", "-2.2e-3", "10M", "4.7001k", "100µ" ... from s[0..len).
+   Single pass, no copies, never reads past len. The SI prefix is folded
+   into the decimal exponent before the one final rounding, so 4.7001k is
+   the double nearest to 4700.1. */
+double parse_prefix_n(const char *s, size_t len, size_t *consumed)
+{
+    size_t i = 0, begin, end;
+    int neg = 0, any = 0, sig = 0, exact = 1;
+    int exp10 = 0;      // exponent applying to mant (kept digits only)
+    int scale = 0;      // exponent part + SI prefix
+    int frac = 0;       // digits after the point
+    uint64_t mant = 0;
+
+    if (i < len && (s[i] == '+' || s[i] == '-'))
+        neg = s[i++] == '-';
+    begin = i;
+
+    // Step 1: mantissa digits (19 fit in mant, any more force the slow path)
+    for (; i < len && s[i] >= '0' && s[i] <= '9'; i++, any = 1)
+    {
+        if (sig < 19) { mant = mant * 10 + (uint64_t)(s[i] - '0'); sig += mant != 0; }
+        else { exp10++; exact &= s[i] == '0'; }
+    }
+    if (i < len && s[i] == '.')
+    {
+        for (i++; i < len && s[i] >= '0' && s[i] <= '9'; i++, any = 1, frac++)
+        {
+            if (sig < 19) { mant = mant * 10 + (uint64_t)(s[i] - '0'); sig += mant != 0; exp10--; }
+            else exact &= s[i] == '0';
+        }
+    }
+    end = i;
+    if (!any)
+    {
+        if (consumed) *consumed = 0;
+        return 0.0;
+    }
+
+    // Step 2: optional exponent, only taken if digits follow
+    if (i < len && (s[i] == 'e' || s[i] == 'E'))
+    {
+        size_t j = i + 1;
+        int eneg = 0, e = 0;
+        if (j < len && (s[j] == '+' || s[j] == '-')) eneg = s[j++] == '-';
+        if (j < len && s[j] >= '0' && s[j] <= '9')
+        {
+            for (; j < len && s[j] >= '0' && s[j] <= '9'; j++)
+                if (e < 10000) e = e * 10 + (s[j] - '0');
+            scale = eneg ? -e : e;
+            i = j;
+        }
+    }
+
+    // Step 3: optional SI prefix (K and U accepted for k and u, m is milli)
+    if (i < len)
+    {
+        switch (s[i])
+        {
+        case 'T': scale += 12; i++; break;
+        case 'G': scale += 9; i++; break;
+        case 'M': scale += 6; i++; break;
+        case 'k': case 'K': scale += 3; i++; break;
+        case 'm': scale -= 3; i++; break;
+        case 'u': case 'U': scale -= 6; i++; break;
+        case 'n': scale -= 9; i++; break;
+        case 'p': scale -= 12; i++; break;
+        case 'f': scale -= 15; i++; break;
+        case '\xC2': // UTF-8 µ (as printed by print_with_prefix)
+            if (i + 1 < len && s[i + 1] == '\xB5') { scale -= 6; i += 2; }
+            break;
+        }
+    }
+    if (consumed) *consumed = i;
+
+    // Step 4: one rounding
+    double value;
+    exp10 += scale;
+    if (mant == 0)
+        value = 0.0;
+    else if (exact && mant < (1ull << 53) && exp10 >= -22 && exp10 <= 22)
+        value = exp10 >= 0 ? (double)mant * pow10_exact[exp10] : (double)mant / pow10_exact[-exp10];
+    else
+        value = slow_decimal(s, begin, end, scale - frac);
+    return neg ? -value : value;
+}
+
+/* 🔹 Convert a string like "4.7k", "10M", "2.2u", etc. to a float */
+float parse_with_prefix(const char *input)
+{
+    return (float)parse_prefix_n(input, strlen(input), NULL);
+}
+
+static double pow10_any(int e)
+{
+    return e >= 0 && e <= 22 ? pow10_exact[e] : e < 0 && e >= -22 ? 1.0 / pow10_exact[-e] : pow(10.0, e);
+}
+
+/* Round v to p significant digits (v ≈ *m × 10^*k) and check exactly that
+   the result reads back as v. Returns 1 if it does, 0 if it does not and
+   -1 if the exact check is impossible (mantissa or exponent too large). */
+static int try_digits(double v, int e, int p, int single, uint64_t *mant, int *q)
+{
+    int k = e - p + 1;
+    if (k < -22 || k > 22) return -1;
+    double m = nearbyint(k >= 0 ? v / pow10_exact[k] : v * pow10_exact[-k]);
+    if (m >= 9007199254740992.0) return -1;     // 2^53
+    double r = k >= 0 ? m * pow10_exact[k] : m / pow10_exact[-k];
+    if (!(single ? (float)r == (float)v : r == v))
+    {
+        // With 16 digits the scaling itself can be off by one unit
+        if (m < 1e15) return 0;
+        for (int d = -1; d <= 1; d += 2)
+        {
+            double mm = m + d;
+            if (mm >= 9007199254740992.0) continue;
+            r = k >= 0 ? mm * pow10_exact[k] : mm / pow10_exact[-k];
+            if (r == v) { *mant = (uint64_t)mm; *q = k; return 1; }
+        }
+        return 0;
+    }
+    *mant = (uint64_t)m;
+    *q = k;
+    return 1;
+}
+
+/* 🔹 Shortest digits: the fewest significant digits m × 10^q that read back
+   as the same double (or the same float when 'single' is set). Rounding to
+   more digits only gets closer, so the digit count is binary-searched; the
+   rare values the exact check cannot settle go through printf/strtod. */
+static void shortest_digits(double v, int single, uint64_t *mant, int *q)
+{
+    int e2;
+    frexp(v, &e2);
+    int e = (int)floor((e2 - 1) * 0.30102999566398119521);
+    if (v >= pow10_any(e + 1)) e++;
+    else if (v < pow10_any(e)) e--;
+
+    int lo = 1, hi = single ? 9 : 17, ok = 0;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        int r = try_digits(v, e, mid, single, mant, q);
+        if (r < 0) break;
+        if (r) hi = mid;
+        else lo = mid + 1;
+    }
+    if (lo == hi && try_digits(v, e, lo, single, mant, q) == 1) ok = 1;
+    if (ok) return;
+
+    // Fallback: the first printf rounding from 'lo' digits up that reads back
+    char buf[40];
+    for (int p = lo; p <= 17; p++)
+    {
+        snprintf(buf, sizeof(buf), "%.*e", p - 1, v);
+        double r = strtod(buf, NULL);
+        if (single ? (float)r == (float)v : r == v) break;
+    }
+    uint64_t m = 0;
+    char *c = buf;
+    for (; *c && *c != 'e'; c++)
+        if (*c >= '0' && *c <= '9') m = m * 10 + (uint64_t)(*c - '0');
+    int digits = 0;
+    for (uint64_t t = m; t; t /= 10) digits++;
+    *mant = m;
+    *q = atoi(c + 1) - (digits - 1);
+}
+
+static size_t put_str(char *buf, size_t cap, size_t at, const char *s)
+{
+    for (; *s; s++, at++)
+        if (at + 1 < cap) buf[at] = *s;
+    return at;
+}
+
+static size_t format_prefixed(char *buf, size_t cap, double value, const char *unit, int single)
+{
+    static const char *const prefixes[] = { "f", "p", "n", "µ", "m", "", "k", "M", "G", "T" };
+    char digits[24];
+    size_t at = 0;
+    int n = 0, q;
+    uint64_t m;
+
+    if (value < 0) { at = put_str(buf, cap, at, "-"); value = -value; }
+
+    if (value == 0.0 || isnan(value) || isinf(value))
+    {
+        at = put_str(buf, cap, at, value == 0.0 ? "0 " : isnan(value) ? "nan " : "inf ");
+        at = put_str(buf, cap, at, unit);
+        if (cap) buf[at < cap ? at : cap - 1] = '\0';
+        return at;
+    }
+
+    shortest_digits(value, single, &m, &q);
+    while (m % 10 == 0) { m /= 10; q++; }
+    for (uint64_t t = m; t; t /= 10) digits[n++] = (char)('0' + t % 10);
+
+    // Engineering exponent of the leading digit, clamped to f..T
+    int lead = q + n - 1;
+    int eng = lead >= 0 ? lead / 3 * 3 : -((-lead + 2) / 3 * 3);
+    if (eng < -15) eng = -15;
+    if (eng > 12) eng = 12;
+    int int_digits = lead - eng + 1;
+
+    char num[64];
+    int k = 0;
+    if (int_digits < -5 || int_digits > 6)
+    {
+        // Far outside f..T: plain scientific notation, no prefix
+        num[k++] = digits[--n];
+        if (n) num[k++] = '.';
+        while (n) num[k++] = digits[--n];
+        k += snprintf(num + k, sizeof(num) - k, "e%d", lead);
+        eng = 0;
+    }
+    else if (int_digits <= 0)
+    {
+        num[k++] = '0';
+        num[k++] = '.';
+        for (int z = 0; z < -int_digits; z++) num[k++] = '0';
+        while (n) num[k++] = digits[--n];
+    }
+    else
+    {
+        for (int d = 0; d < int_digits; d++)
+            num[k++] = n ? digits[--n] : '0';
+        if (n) num[k++] = '.';
+        while (n) num[k++] = digits[--n];
+    }
+    num[k++] = ' ';
+    num[k] = '\0';
+
+    at = put_str(buf, cap, at, num);
+    at = put_str(buf, cap, at, prefixes[(eng + 15) / 3]);
+    at = put_str(buf, cap, at, unit);
+    if (cap) buf[at < cap ? at : cap - 1] = '\0';
+    return at;
+}
+
+size_t format_with_prefix(char *buf, size_t cap, double value, const char *unit)
+{
+    return format_prefixed(buf, cap, value, unit, 0);
+}
+
+size_t format_with_prefix_array(char *buf, size_t cap, const double *values, size_t n, const char *unit)
+{
+    size_t used = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t len = format_prefixed(buf + used, cap - used, values[i], unit, 0);
+        if (used + len + 1 >= cap) break;   // keep only complete lines
+        used += len;
+        buf[used++] = '\n';
+    }
+    return used;
+}
+
+int write_with_prefix_array(FILE *f, const double *values, size_t n, const char *unit)
+{
+    // Values are formatted in blocks so huge arrays do not need one huge
+    // buffer; each block goes out with a single fwrite
+    const size_t block = 65536;
+    size_t per_value = PREFIX_FMT_MAX + strlen(unit);
+    size_t cap = (n < block ? n : block) * per_value + 1;
+    char *buf = malloc(cap);
+    int rc = 0;
+    if (!buf) return -1;
+
+    for (size_t i = 0; i < n && rc == 0; i += block)
+    {
+        size_t count = n - i < block ? n - i : block;
+        size_t len = format_with_prefix_array(buf, cap, values + i, count, unit);
+        if (fwrite(buf, 1, len, f) != len) rc = -1;
+    }
+    free(buf);
+    return rc;
+}
+
+/* 🔹 Print with the best-fitting prefix, e.g. 4.7 kΩ. The value is a float,
+   so the digits shown are the shortest that identify that float. */
+void print_with_prefix(float value, const char *unit)
+{
+    char buf[128];
+    size_t len = format_prefixed(buf, sizeof(buf) - 1, value, unit, 1);
+    buf[len++] = '\n';
+    fwrite(buf, 1, len, stdout);
+}
+
+/* 🔹 Plain shortest round-trip number (no prefix), %g-style layout */
+size_t format_shortest(char *buf, size_t cap, double value)
+{
+    char digits[24], num[48];
+    int n = 0, k = 0, q;
+    uint64_t m;
+
+    if (value == 0.0 || isnan(value) || isinf(value))
+    {
+        const char *s = value == 0.0 ? (signbit(value) ? "-0" : "0")
+                      : isnan(value) ? "nan" : value < 0 ? "-inf" : "inf";
+        size_t at = put_str(buf, cap, 0, s);
+        if (cap) buf[at < cap ? at : cap - 1] = '\0';
+        return at;
+    }
+    if (value < 0) { num[k++] = '-'; value = -value; }
+
+    shortest_digits(value, 0, &m, &q);
+    while (m % 10 == 0) { m /= 10; q++; }
+    for (uint64_t t = m; t; t /= 10) digits[n++] = (char)('0' + t % 10);
+
+    int lead = q + n - 1;
+    if (lead < -4 || lead > 15)
+    {
+        num[k++] = digits[--n];
+        if (n) num[k++] = '.';
+        while (n) num[k++] = digits[--n];
+        k += snprintf(num + k, sizeof(num) - k, "e%+03d", lead);
+    }
+    else if (lead < 0)
+    {
+        num[k++] = '0';
+        num[k++] = '.';
+        for (int z = 0; z < -lead - 1; z++) num[k++] = '0';
+        while (n) num[k++] = digits[--n];
+    }
+    else
+    {
+        for (int d = 0; d <= lead; d++) num[k++] = n ? digits[--n] : '0';
+        if (n) num[k++] = '.';
+        while (n) num[k++] = digits[--n];
+    }
+    num[k] = '\0';
+
+    size_t at = put_str(buf, cap, 0, num);
+    if (cap) buf[at < cap ? at : cap - 1] = '\0';
+    return at;
+}
+
+/* 🔹 Basic math functions */
+float add(float a, float b) { return a + b; }
+float sub(float a, float b) { return a - b; }
+float mul(float a, float b) { return a * b; }
+
+float div_safe(float a, float b, int *ok)
+{
+    if (b == 0)
+    {
+        *ok = 0;
+        return 0.0;
+    }
+    *ok = 1;
+    return a / b;
+}
+
+/* 🔹 Series / parallel combinations */
+double series_total(const double *values, int n)
+{
+    return sum_array(values, n > 0 ? (size_t)n : 0);
+}
+
+double parallel_total(const double *values, int n)
+{
+    return 1.0 / reciprocal_sum_array(values, n > 0 ? (size_t)n : 0);
+}
+
+double *read_values(const char *label, int n)
+{
+    double *values = malloc((size_t)n * sizeof(double));
+    if (!values)
+    {
+        printf("Error: out of memory.\n");
+        return NULL;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        char buf[32];
+        printf("%s%d: ", label, i + 1);
+        scanf("%31s", buf);
+        values[i] = parse_prefix_n(buf, strlen(buf), NULL);
+    }
+    return values;
+}
+
+double read_number(const char *prompt)
+{
+    char buf[64];
+    size_t used;
+    printf("%s", prompt);
+    if (scanf("%63s", buf) != 1) return NAN;
+    double v = parse_prefix_n(buf, strlen(buf), &used);
+    return used ? v : NAN;
+}
+
+/* 🔹 Interactive Math Menu */
+void math_menu(void)
+{
+    int choice;
+    char input1[20], input2[20];
+    float a = 0, b = 0, result;
+    int ok;
+
+    do
+    {
+        printf("\n==== MATHEMATICAL OPERATIONS ====\n");
+        printf("1. Addition\n");
+        printf("2. Subtraction\n");
+        printf("3. Multiplication\n");
+        printf("4. Division\n");
+        printf("0. Return to Main Menu\n");
+        printf("5. Power (x^y)\n");
+        printf("6. Square Root\n");
+        printf("7. Logarithm (base 10)\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        getchar(); // consume newline
+
+        if (choice == 0)
+            break;
+        if (choice >= 1 && choice <= 5)
+        {
+            printf("Enter first value (supports T,G,M,k,m,u,n,p,f): ");
+            scanf("%s", input1);
+            printf("Enter second value (supports T,G,M,k,m,u,n,p,f): ");
+            scanf("%s", input2);
+            a = parse_with_prefix(input1);
+            b = parse_with_prefix(input2);
+        }
+
+        switch (choice)
+        {
+        case 1: // Addition
+            result = add(a, b);
+            printf("Result = ");
+            print_with_prefix(result, "");
+            break;
+
+        case 2: // Subtraction
+            result = sub(a, b);
+            printf("Result = ");
+            print_with_prefix(result, "");
+            break;
+
+        case 3: // Multiplication
+            result = mul(a, b);
+            printf("Result = ");
+            print_with_prefix(result, "");
+            break;
+
+        case 4: // Division
+            result = div_safe(a, b, &ok);
+            if (ok)
+            {
+                printf("Result = ");
+                print_with_prefix(result, "");
+            }
+            else
+            {
+                printf("Error: Division by zero!\n");
+            }
+            break;
+
+        case 5: // Power (x^y)
+            result = power(a, b);
+            printf("Result = ");
+            print_with_prefix(result, "");
+            break;
+
+        case 6: // Square Root
+            printf("Enter value (supports prefixes): ");
+            scanf("%s", input1);
+            a = parse_with_prefix(input1);
+            if (a < 0)
+                printf("Error: Cannot take square root of a negative number!\n");
+            else
+            {
+                result = sqroot(a);
+                printf("√(%.4f) = ", a);
+                print_with_prefix(result, "");
+            }
+            break;
+
+        case 7: // Logarithm (base 10)
+            printf("Enter value (supports prefixes): ");
+            scanf("%s", input1);
+            a = parse_with_prefix(input1);
+            if (a <= 0)
+                printf("Error: Logarithm undefined for zero or negative numbers!\n");
+            else
+            {
+                result = log10_val(a);
+                printf("log10(%.4f) = %.6f\n", a, result);
+            }
+            break;
+
+        default:
+            printf("Invalid choice!\n");
+        }
+
+    } while (choice != 0);
+}
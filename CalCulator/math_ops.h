@@ -1,18 +1,56 @@
-#ifndef MATH_OPS_H
-#define MATH_OPS_H
-
-void math_menu(void);
-
-// Parse user input with SI prefixes (T, G, M, k, m, u, n, p, f)
-float parse_with_prefix(const char *input);
-
-// Print values automatically with best-fitting prefix
-void print_with_prefix(float value, const char *unit);
-
-// Math operations
-float add(float a, float b);
-float sub(float a, float b);
-float mul(float a, float b);
-float div_safe(float a, float b, int *ok);
-
-#endif
+#ifndef MATH_OPS_H
+#define MATH_OPS_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+void math_menu(void);
+
+// Parse user input with SI prefixes (T, G, M, k, m, u, n, p, f)
+float parse_with_prefix(const char *input);
+
+// Double-precision parser behind parse_with_prefix(): reads one number and
+// optional prefix from s[0..len) (no NUL needed) and stores the number of
+// bytes used in *consumed (0 = no number; consumed may be NULL)
+double parse_prefix_n(const char *s, size_t len, size_t *consumed);
+
+// Print values automatically with best-fitting prefix
+void print_with_prefix(float value, const char *unit);
+
+// Longest number part format_with_prefix() can produce (excluding the unit)
+#define PREFIX_FMT_MAX 32
+
+// Engineering notation ("4.7 kΩ") with the shortest digits that read back
+// as the same double, written to buf (always NUL-terminated if cap > 0).
+// Returns the full length, which may exceed cap - 1 if truncated.
+size_t format_with_prefix(char *buf, size_t cap, double value, const char *unit);
+
+// Format n values one per line ('\n'-terminated, no NUL) into buf and return
+// the bytes used; stops early rather than writing a partial line
+size_t format_with_prefix_array(char *buf, size_t cap, const double *values, size_t n, const char *unit);
+
+// Format n values and write them to f in large single writes (0 on success)
+int write_with_prefix_array(FILE *f, const double *values, size_t n, const char *unit);
+
+// Shortest round-trip plain number, e.g. 594.8275862068966 or 1.5e-07
+size_t format_shortest(char *buf, size_t cap, double value);
+
+// Math operations
+float add(float a, float b);
+float sub(float a, float b);
+float mul(float a, float b);
+float div_safe(float a, float b, int *ok);
+
+// Series / parallel combinations of n values (R and L in series add,
+// C in series combines like R in parallel)
+double series_total(const double *values, int n);
+double parallel_total(const double *values, int n);
+
+// Prompt "<label>1: ", "<label>2: ", ... for n values (prefixes allowed);
+// returns a malloc'd array the caller frees, or NULL if out of memory
+double *read_values(const char *label, int n);
+
+// Prompt once for a number with optional SI prefix; NAN if none was given
+double read_number(const char *prompt);
+
+#endif
@@ -0,0 +1,479 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "monte_carlo.h"
+#include "expression_eval.h"
+#include "expr_jit.h"
+#include "resistor_calc.h"
+#include "math_ops.h"
+#include "parallel.h"
+
+#define BLOCK      4096             /* trials per task */
+#define FINE_BINS  65536            /* histogram bins used to find percentiles */
+#define MAX_PARAMS 64
+
+const double mc_percent_points[MC_N_PCT] = { 0.1, 1, 5, 50, 95, 99, 99.9 };
+
+/* ────────────────────────────────────────────────
+   COUNTER-BASED RANDOM NUMBERS
+   Draw t of stream s is splitmix64 run from a state
+   derived from (seed, s): no generator state to
+   carry, so trials can be made in any order.
+   ──────────────────────────────────────────────── */
+
+static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline double draw_uniform(uint64_t key, uint64_t trial) {
+    return (double)(mix64(key + trial * 0x9E3779B97F4A7C15ull) >> 11) * 0x1.0p-53;    /* [0, 1) */
+}
+
+/* ────────────────────────────────────────────────
+   TRIALS
+   Three passes regenerate the same trials:
+     1. count, sum, min, max per block
+     2. spread around the mean and a fine histogram
+     3. the values in the bins holding the percentiles
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    double *vals;
+    size_t n, cap;
+    int failed;
+} mc_pick_t;
+
+typedef struct {
+    const expr_jit_t *jit;          /* native code for the expression, or the interpreter */
+    const mc_param_t *params;
+    int n_params;
+    uint64_t keys[2 * MAX_PARAMS];
+    uint64_t trials;
+    int pass;
+    double *scratch;                /* per worker: n_params + 1 rows of BLOCK */
+
+    double *block_sum, *block_min, *block_max, *block_sq;
+    uint64_t *block_valid;
+
+    double lo, inv_width, mean;
+    uint64_t *fine;                 /* per worker: FINE_BINS */
+    const unsigned char *target;    /* pass 3: fine bins to keep */
+    mc_pick_t *picks;               /* per worker */
+} mc_job_t;
+
+static size_t scratch_rows(const mc_job_t *j) { return (size_t)j->n_params + 1; }
+
+/* Results of the trials in one block into out; returns the count */
+static size_t run_block(const mc_job_t *j, int block, double *cols, double *out) {
+    uint64_t first = (uint64_t)block * BLOCK;
+    size_t n = j->trials - first < BLOCK ? (size_t)(j->trials - first) : BLOCK;
+    const double *col_ptr[MAX_PARAMS];
+
+    for (int p = 0; p < j->n_params; p++) {
+        const mc_param_t *mp = &j->params[p];
+        double *c = cols + (size_t)p * BLOCK, nom = mp->nominal, tol = mp->tolerance / 100.0;
+        col_ptr[p] = c;
+        if (mp->dist == MC_UNIFORM) {
+            for (size_t r = 0; r < n; r++)
+                c[r] = nom * (1.0 + tol * (2.0 * draw_uniform(j->keys[2 * p], first + r) - 1.0));
+        } else if (mp->dist == MC_GAUSSIAN) {
+            for (size_t r = 0; r < n; r++) {       /* Box-Muller */
+                double u1 = 1.0 - draw_uniform(j->keys[2 * p], first + r);
+                double u2 = draw_uniform(j->keys[2 * p + 1], first + r);
+                double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+                c[r] = nom * (1.0 + tol / 3.0 * z);
+            }
+        } else {
+            for (size_t r = 0; r < n; r++) c[r] = nom;
+        }
+    }
+    expr_jit_eval_batch(j->jit, col_ptr, n, out);
+    return n;
+}
+
+static inline int fine_bin(const mc_job_t *j, double x) {
+    double b = (x - j->lo) * j->inv_width;
+    return b < FINE_BINS - 1 ? (int)b : FINE_BINS - 1;
+}
+
+static void pick_push(mc_pick_t *p, double v) {
+    if (p->n == p->cap) {
+        size_t cap = p->cap ? 2 * p->cap : 1024;
+        double *nv = realloc(p->vals, cap * sizeof(double));
+        if (!nv) { p->failed = 1; return; }
+        p->vals = nv;
+        p->cap = cap;
+    }
+    p->vals[p->n++] = v;
+}
+
+static void mc_task(void *ctx, int block, int worker) {
+    mc_job_t *j = ctx;
+    double *cols = j->scratch + (size_t)worker * scratch_rows(j) * BLOCK;
+    double *out = cols + (size_t)j->n_params * BLOCK;
+    size_t n = run_block(j, block, cols, out);
+
+    if (j->pass == 1) {
+        double sum = 0, lo = INFINITY, hi = -INFINITY;
+        uint64_t valid = 0;
+        for (size_t r = 0; r < n; r++) {
+            double x = out[r];
+            if (!isfinite(x)) continue;
+            sum += x;
+            valid++;
+            if (x < lo) lo = x;
+            if (x > hi) hi = x;
+        }
+        j->block_sum[block] = sum;
+        j->block_valid[block] = valid;
+        j->block_min[block] = lo;
+        j->block_max[block] = hi;
+    } else if (j->pass == 2) {
+        uint64_t *fine = j->fine + (size_t)worker * FINE_BINS;
+        double sq = 0;
+        for (size_t r = 0; r < n; r++) {
+            double x = out[r];
+            if (!isfinite(x)) continue;
+            sq += (x - j->mean) * (x - j->mean);
+            fine[fine_bin(j, x)]++;
+        }
+        j->block_sq[block] = sq;
+    } else {
+        for (size_t r = 0; r < n; r++) {
+            double x = out[r];
+            if (isfinite(x) && j->target[fine_bin(j, x)]) pick_push(&j->picks[worker], x);
+        }
+    }
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Exact order statistics: locate each rank's fine bin, then sort only the
+   values that fell into those bins */
+static int find_percentiles(mc_job_t *j, const uint64_t *fine, int n_blocks, int workers, mc_result_t *res) {
+    unsigned char *target = calloc(FINE_BINS, 1);
+    int bin[MC_N_PCT];
+    uint64_t offset[MC_N_PCT];
+    if (!target) return 1;
+
+    for (int k = 0; k < MC_N_PCT; k++) {
+        uint64_t rank = (uint64_t)llround(mc_percent_points[k] / 100.0 * (double)(res->valid - 1)), cum = 0;
+        int b = 0;
+        while (cum + fine[b] <= rank) cum += fine[b++];
+        bin[k] = b;
+        offset[k] = rank - cum;
+        target[b] = 1;
+    }
+
+    j->pass = 3;
+    j->target = target;
+    par_for_worker(n_blocks, mc_task, j);
+
+    size_t total = 0;
+    int failed = 0;
+    for (int w = 0; w < workers; w++) { total += j->picks[w].n; failed |= j->picks[w].failed; }
+    double *all = failed ? NULL : malloc((total ? total : 1) * sizeof(double));
+    if (all) {
+        size_t at = 0;
+        for (int w = 0; w < workers; w++) {
+            memcpy(all + at, j->picks[w].vals, j->picks[w].n * sizeof(double));
+            at += j->picks[w].n;
+        }
+        qsort(all, total, sizeof(double), cmp_double);
+        for (int k = 0; k < MC_N_PCT; k++) {
+            uint64_t before = 0;            /* picked values in lower target bins */
+            for (int b = 0; b < bin[k]; b++) if (target[b]) before += fine[b];
+            res->percentile[k] = all[before + offset[k]];
+        }
+    }
+    int rc = all == NULL;
+    free(all);
+    free(target);
+    return rc;
+}
+
+/* ────────────────────────────────────────────────
+   SENSITIVITY AND WORST CASE
+   One forward-mode pass gives every partial
+   derivative; their signs pick the two corners of
+   the tolerance box, which are then evaluated
+   exactly (2 evaluations instead of 2N).
+   ──────────────────────────────────────────────── */
+
+static int compile_params(const char *expr, const mc_param_t *params, int n_params, double *nominal,
+                          expr_program_t **prog) {
+    const char *names[MAX_PARAMS] = { 0 };
+    if (n_params < 0 || n_params > MAX_PARAMS) { printf("Error: at most %d parameters.\n", MAX_PARAMS); return 1; }
+    for (int p = 0; p < n_params; p++) {
+        if (!isfinite(params[p].nominal) || !(params[p].tolerance >= 0) ||
+            params[p].dist < MC_FIXED || params[p].dist > MC_GAUSSIAN) {
+            printf("Error: bad value, tolerance or distribution for %s.\n", params[p].name);
+            return 1;
+        }
+        names[p] = params[p].name;
+        nominal[p] = params[p].nominal;
+    }
+    *prog = expr_compile_vars(expr, names, n_params);
+    return *prog == NULL;
+}
+
+/* Tolerance band half-width in the parameter's own units */
+static double band(const mc_param_t *p) {
+    return p->dist == MC_FIXED ? 0 : fabs(p->nominal) * p->tolerance / 100;
+}
+
+int mc_sensitivity(const char *expr, const mc_param_t *params, int n_params,
+                   double *nominal, double *partial, double *worst_lo, double *worst_hi) {
+    double nom[MAX_PARAMS] = { 0 }, lo[MAX_PARAMS], hi[MAX_PARAMS];
+    expr_program_t *prog;
+    if (compile_params(expr, params, n_params, nom, &prog)) return 1;
+
+    *nominal = expr_eval_grad(prog, nom, partial);
+    for (int p = 0; p < n_params; p++) {
+        double d = partial[p] < 0 ? -band(&params[p]) : band(&params[p]);
+        lo[p] = nom[p] - d;
+        hi[p] = nom[p] + d;
+    }
+    *worst_lo = expr_eval(prog, lo);
+    *worst_hi = expr_eval(prog, hi);
+    expr_free(prog);
+    return 0;
+}
+
+int mc_run(const char *expr, const mc_param_t *params, int n_params, uint64_t trials, uint64_t seed,
+           mc_result_t *res) {
+    double nominal[MAX_PARAMS] = { 0 };
+    expr_program_t *prog;
+    memset(res, 0, sizeof *res);
+    if (trials == 0 || trials / BLOCK >= (1u << 31)) { printf("Error: trial count out of range.\n"); return 1; }
+    if (compile_params(expr, params, n_params, nominal, &prog)) return 1;
+
+    mc_job_t j = { 0 };
+    int n_blocks = (int)((trials + BLOCK - 1) / BLOCK), workers = par_threads(), rc = 0;
+    expr_jit_t *jit = expr_jit_compile(prog);
+    j.jit = jit;
+    j.params = params;
+    j.n_params = n_params;
+    j.trials = trials;
+    for (int s = 0; s < 2 * n_params; s++) j.keys[s] = mix64(seed ^ mix64((uint64_t)s + 1));
+    j.scratch = malloc((size_t)workers * scratch_rows(&j) * BLOCK * sizeof(double));
+    j.block_sum = malloc(n_blocks * sizeof(double));
+    j.block_min = malloc(n_blocks * sizeof(double));
+    j.block_max = malloc(n_blocks * sizeof(double));
+    j.block_sq = malloc(n_blocks * sizeof(double));
+    j.block_valid = malloc(n_blocks * sizeof(uint64_t));
+    j.fine = calloc((size_t)workers * FINE_BINS, sizeof(uint64_t));
+    j.picks = calloc(workers, sizeof(mc_pick_t));
+    if (!jit || !j.scratch || !j.block_sum || !j.block_min || !j.block_max || !j.block_sq || !j.block_valid ||
+        !j.fine || !j.picks) {
+        printf("Error: out of memory\n");
+        rc = 1;
+        goto done;
+    }
+
+    res->trials = trials;
+    res->nominal = expr_eval(prog, nominal);
+
+    /* Block partials are combined in block order, never in finishing order */
+    j.pass = 1;
+    par_for_worker(n_blocks, mc_task, &j);
+    double sum = 0;
+    res->min = INFINITY;
+    res->max = -INFINITY;
+    for (int b = 0; b < n_blocks; b++) {
+        sum += j.block_sum[b];
+        res->valid += j.block_valid[b];
+        if (j.block_min[b] < res->min) res->min = j.block_min[b];
+        if (j.block_max[b] > res->max) res->max = j.block_max[b];
+    }
+    if (res->valid == 0) goto done;
+    res->mean = sum / (double)res->valid;
+
+    j.pass = 2;
+    j.mean = res->mean;
+    j.lo = res->min;
+    j.inv_width = res->max > res->min ? FINE_BINS / (res->max - res->min) : 0;
+    par_for_worker(n_blocks, mc_task, &j);
+    double sq = 0;
+    for (int b = 0; b < n_blocks; b++) sq += j.block_sq[b];
+    res->stddev = res->valid > 1 ? sqrt(sq / (double)(res->valid - 1)) : 0;
+
+    /* Worker histograms hold integer counts, so their sum is exact */
+    uint64_t *fine = j.fine;
+    for (int w = 1; w < workers; w++)
+        for (int b = 0; b < FINE_BINS; b++) fine[b] += j.fine[(size_t)w * FINE_BINS + b];
+    for (int b = 0; b < FINE_BINS; b++) res->hist[b / (FINE_BINS / MC_HIST_BINS)] += fine[b];
+
+    if (find_percentiles(&j, fine, n_blocks, workers, res)) { printf("Error: out of memory\n"); rc = 1; }
+
+done:
+    if (j.picks)
+        for (int w = 0; w < workers; w++) free(j.picks[w].vals);
+    free(j.picks);
+    free(j.fine);
+    free(j.block_valid);
+    free(j.block_sq);
+    free(j.block_max);
+    free(j.block_min);
+    free(j.block_sum);
+    free(j.scratch);
+    expr_jit_free(jit);
+    expr_free(prog);
+    return rc;
+}
+
+/* ────────────────────────────────────────────────
+   REPORT AND PROMPTS
+   ──────────────────────────────────────────────── */
+
+static void print_value(const char *label, double v, const char *unit) {
+    char buf[PREFIX_FMT_MAX + 16];
+    format_with_prefix(buf, sizeof buf, v, unit);
+    printf("%s%s\n", label, buf);
+}
+
+void mc_print(const mc_result_t *res, const char *unit) {
+    printf("%llu trials, %llu with a finite result\n",
+           (unsigned long long)res->trials, (unsigned long long)res->valid);
+    print_value("Nominal:   ", res->nominal, unit);
+    if (res->valid == 0) return;
+    print_value("Mean:      ", res->mean, unit);
+    print_value("Std dev:   ", res->stddev, unit);
+    print_value("Minimum:   ", res->min, unit);
+    print_value("Maximum:   ", res->max, unit);
+    if (res->nominal != 0)
+        printf("Spread:    %+.4f%% .. %+.4f%% of nominal\n",
+               100 * (res->min / res->nominal - 1), 100 * (res->max / res->nominal - 1));
+    for (int k = 0; k < MC_N_PCT; k++) {
+        char label[32];
+        snprintf(label, sizeof label, "%5g%%:    ", mc_percent_points[k]);
+        print_value(label, res->percentile[k], unit);
+    }
+
+    uint64_t peak = 1;
+    for (int b = 0; b < MC_HIST_BINS; b++) if (res->hist[b] > peak) peak = res->hist[b];
+    double width = (res->max - res->min) / MC_HIST_BINS;
+    printf("Histogram:\n");
+    for (int b = 0; b < MC_HIST_BINS; b++) {
+        int bar = (int)(50 * res->hist[b] / peak);
+        printf("  %12.6g %-3s %10llu |%.*s\n", res->min + (b + 0.5) * width, unit,
+               (unsigned long long)res->hist[b], bar,
+               "##################################################");
+    }
+}
+
+void mc_print_sensitivity(const mc_param_t *params, int n_params, double nominal, const double *partial,
+                          double worst_lo, double worst_hi, const char *unit) {
+    double swing = 0;
+    for (int p = 0; p < n_params; p++) swing += fabs(partial[p]) * band(&params[p]);
+    printf("Sensitivity at nominal:\n");
+    printf("  %-15s %14s %12s %10s\n", "Part", "d/dx", "%/%", "Share");
+    for (int p = 0; p < n_params; p++) {
+        double rel = nominal != 0 ? partial[p] * params[p].nominal / nominal : NAN;
+        double share = swing > 0 ? 100 * fabs(partial[p]) * band(&params[p]) / swing : 0;
+        printf("  %-15.15s %14.6g %12.4f %9.1f%%\n", params[p].name, partial[p], rel, share);
+    }
+    print_value("Worst-case low:  ", worst_lo, unit);
+    print_value("Worst-case high: ", worst_hi, unit);
+}
+
+/* A value with SI prefix, or colour bands joined by '-' such as
+   "yellow-violet-red-gold" (which also give the tolerance) */
+static int read_component(const char *prompt, double *value, double *tol) {
+    char buf[128];
+    printf("%s", prompt);
+    if (scanf("%127s", buf) != 1) return 0;
+
+    if (strchr(buf, '-') && buf[0] != '-') {
+        const char *bands[6];
+        int n = 0;
+        for (char *tok = strtok(buf, "-"); tok && n < 6; tok = strtok(NULL, "-")) bands[n++] = tok;
+        if (n < 4 || !color_decode(bands, n, value, tol)) { printf("Invalid colour bands.\n"); return 0; }
+        if (*tol < 0) *tol = 20;        /* no tolerance band */
+        return 1;
+    }
+    size_t used;
+    *value = parse_prefix_n(buf, strlen(buf), &used);
+    *tol = -1;
+    if (!used) { printf("Invalid value.\n"); return 0; }
+    return 1;
+}
+
+void monte_carlo_dialog(void) {
+    static char names[MAX_PARAMS][16];
+    mc_param_t params[MAX_PARAMS];
+    char expr[512] = "";
+    int kind, n, dist;
+
+    printf("Circuit (1 = resistors in series, 2 = resistors in parallel, 3 = expression): ");
+    if (scanf("%d", &kind) != 1 || kind < 1 || kind > 3) { printf("Invalid option.\n"); return; }
+    if (kind == 3) {
+        printf("Expression using variable names, e.g. V*R2/(R1+R2) (no spaces): ");
+        if (scanf("%511s", expr) != 1) return;
+        printf("Number of variables: ");
+    } else {
+        printf("Number of resistors: ");
+    }
+    if (scanf("%d", &n) != 1 || n < 1 || n > (kind == 3 ? MAX_PARAMS : 20)) { printf("Invalid count.\n"); return; }
+    printf("Distribution (1 = uniform within tolerance, 2 = gaussian, tolerance = 3σ): ");
+    if (scanf("%d", &dist) != 1) return;
+    dist = dist == 2 ? MC_GAUSSIAN : MC_UNIFORM;
+
+    size_t len = kind == 2 ? (size_t)snprintf(expr, sizeof expr, "1/(") : 0;     /* 1/(1/R1+1/R2+...) */
+    for (int p = 0; p < n; p++) {
+        if (kind == 3) {
+            printf("Name of variable %d: ", p + 1);
+            if (scanf("%15s", names[p]) != 1) return;
+        } else {
+            snprintf(names[p], sizeof names[p], "R%d", p + 1);
+            const char *fmt = kind == 1 ? "%s%s" : "%s1/%s";
+            len += snprintf(expr + len, sizeof expr - len, fmt, p ? "+" : "", names[p]);
+        }
+        char prompt[96];
+        snprintf(prompt, sizeof prompt, "%.15s value (e.g. 4.7k, or bands like yellow-violet-red-gold): ", names[p]);
+        double value, tol;
+        if (!read_component(prompt, &value, &tol)) return;
+        if (tol < 0) {
+            printf("%s tolerance (%%): ", names[p]);
+            if (scanf("%lf", &tol) != 1) return;
+        } else {
+            printf("%s tolerance from bands: ±%g%%\n", names[p], tol);
+        }
+        params[p] = (mc_param_t){ names[p], value, tol, tol > 0 ? dist : MC_FIXED };
+    }
+    if (kind == 2) snprintf(expr + len, sizeof expr - len, ")");
+
+    double trials;
+    unsigned long long seed = 1;
+    char buf[64];
+    size_t used;
+    printf("Number of trials (e.g. 10M): ");
+    if (scanf("%63s", buf) != 1) return;
+    trials = parse_prefix_n(buf, strlen(buf), &used);
+    if (!used || !(trials >= 1)) { printf("Invalid count.\n"); return; }
+    printf("Random seed: ");
+    scanf("%llu", &seed);
+
+    double nominal, partial[MAX_PARAMS], worst_lo, worst_hi;
+    const char *unit = kind == 3 ? "" : "Ω";
+    if (mc_sensitivity(expr, params, n, &nominal, partial, &worst_lo, &worst_hi)) return;
+
+    struct timespec t0, t1;
+    mc_result_t res;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int rc = mc_run(expr, params, n, (uint64_t)trials, seed, &res);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc) return;
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    printf("Circuit: %s\n", expr);
+    mc_print_sensitivity(params, n, nominal, partial, worst_lo, worst_hi, unit);
+    mc_print(&res, unit);
+    printf("Done in %.3f s (%.1f M trials/s over three passes)\n", secs, res.trials / secs / 1e6);
+}
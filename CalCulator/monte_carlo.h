@@ -0,0 +1,64 @@
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include <stdint.h>
+
+/* Monte Carlo tolerance analysis: draw every component from its
+   tolerance band, evaluate the circuit expression (e.g. "R1+R2",
+   "1/(1/R1+1/R2)" or "V*R2/(R1+R2)") and collect the spread of the
+   result.
+
+   Trial t draws parameter p from a counter-based generator keyed on
+   (seed, t, p), so any thread can produce any trial and the statistics
+   for a seed are the same whatever the thread count. */
+
+#define MC_FIXED    0           /* always the nominal value */
+#define MC_UNIFORM  1           /* anywhere within ±tolerance */
+#define MC_GAUSSIAN 2           /* normal, tolerance = 3 sigma */
+
+typedef struct {
+    const char *name;           /* variable name in the expression */
+    double nominal;
+    double tolerance;           /* percent */
+    int dist;                   /* MC_FIXED, MC_UNIFORM or MC_GAUSSIAN */
+} mc_param_t;
+
+#define MC_HIST_BINS 32
+#define MC_N_PCT     7          /* 0.1, 1, 5, 50, 95, 99, 99.9 % */
+
+extern const double mc_percent_points[MC_N_PCT];
+
+typedef struct {
+    uint64_t trials;
+    uint64_t valid;             /* trials with a finite result */
+    double nominal;             /* result with every part at nominal */
+    double mean, stddev, min, max;
+    double percentile[MC_N_PCT];            /* exact order statistics */
+    uint64_t hist[MC_HIST_BINS];            /* equal bins over [min, max] */
+} mc_result_t;
+
+/* Returns 0, or 1 (after printing why) on a bad expression, parameter or
+   out of memory */
+int mc_run(const char *expr, const mc_param_t *params, int n_params, uint64_t trials, uint64_t seed,
+           mc_result_t *res);
+
+/* Sensitivity and worst case from a single derivative pass at nominal:
+   partial[p] = d result / d params[p]; worst_lo / worst_hi are the result
+   with every part pushed to the end of its tolerance band that the sign
+   of its derivative says lowers / raises it. Returns 0, or 1 (after
+   printing why) on a bad expression or parameter. */
+int mc_sensitivity(const char *expr, const mc_param_t *params, int n_params,
+                   double *nominal, double *partial, double *worst_lo, double *worst_hi);
+
+/* Table of the above: derivative, % change per % change, and each part's
+   share of the worst-case swing */
+void mc_print_sensitivity(const mc_param_t *params, int n_params, double nominal, const double *partial,
+                          double worst_lo, double worst_hi, const char *unit);
+
+/* Summary, percentiles and a text histogram */
+void mc_print(const mc_result_t *res, const char *unit);
+
+/* Interactive prompts behind the resistor menu */
+void monte_carlo_dialog(void);
+
+#endif
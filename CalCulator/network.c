@@ -0,0 +1,477 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "math_ops.h"
+#include "parallel.h"
+#include "network.h"
+
+#define CG_TOL     1e-12
+#define NAME_LEN   32
+
+/* Sparse symmetric matrix, compressed rows, columns sorted per row */
+typedef struct {
+    int n;
+    int *row;       /* n + 1 offsets */
+    int *col;
+    double *val;
+} csr_t;
+
+struct res_network {
+    int n_nodes, n_edges;
+    int *ea, *eb;
+    double *g;                  /* edge conductances */
+    char (*names)[NAME_LEN];    /* NULL for networks built from indices */
+
+    /* Built on first query */
+    int prepared;
+    int *comp;                  /* component id (= its ground node) per node */
+    int *unknown;               /* node -> matrix row, -1 for ground nodes */
+    csr_t A;                    /* reduced Laplacian */
+    csr_t L;                    /* IC(0) factor, lower triangle incl. diagonal */
+};
+
+/* ────────────────────────────────────────────────
+   CONSTRUCTION
+   ──────────────────────────────────────────────── */
+
+res_network_t *network_create(int n_nodes, int n_edges, const int *node_a,
+                              const int *node_b, const double *ohms) {
+    res_network_t *net = calloc(1, sizeof(*net));
+    if (!net) return NULL;
+    net->n_nodes = n_nodes;
+    net->n_edges = n_edges;
+    net->ea = malloc((n_edges + 1) * sizeof(int));
+    net->eb = malloc((n_edges + 1) * sizeof(int));
+    net->g = malloc((n_edges + 1) * sizeof(double));
+    if (!net->ea || !net->eb || !net->g) { network_free(net); return NULL; }
+
+    for (int e = 0; e < n_edges; e++) {
+        if (node_a[e] < 0 || node_a[e] >= n_nodes || node_b[e] < 0 || node_b[e] >= n_nodes ||
+            !(ohms[e] > 0.0)) {
+            printf("Invalid resistor %d (nodes %d-%d, %g Ω).\n", e + 1, node_a[e], node_b[e], ohms[e]);
+            network_free(net);
+            return NULL;
+        }
+        net->ea[e] = node_a[e];
+        net->eb[e] = node_b[e];
+        net->g[e] = 1.0 / ohms[e];
+    }
+    return net;
+}
+
+/* Drops everything network_prepare() builds, complete or not */
+static void network_unprepare(res_network_t *net) {
+    free(net->comp); free(net->unknown);
+    free(net->A.row); free(net->A.col); free(net->A.val);
+    free(net->L.row); free(net->L.col); free(net->L.val);
+    net->comp = net->unknown = NULL;
+    memset(&net->A, 0, sizeof net->A);
+    memset(&net->L, 0, sizeof net->L);
+    net->prepared = 0;
+}
+
+void network_free(res_network_t *net) {
+    if (!net) return;
+    free(net->ea); free(net->eb); free(net->g); free(net->names);
+    network_unprepare(net);
+    free(net);
+}
+
+int network_nodes(const res_network_t *net) { return net->n_nodes; }
+
+/* Node-name lookup table used while loading (open addressing) */
+typedef struct {
+    int *slot;
+    int cap;
+} name_table_t;
+
+static unsigned hash_name(const char *s) {
+    unsigned h = 2166136261u;
+    while (*s) h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+static int name_find(const name_table_t *t, char (*names)[NAME_LEN], const char *name, int *pos) {
+    unsigned i = hash_name(name) & (t->cap - 1);
+    while (t->slot[i] >= 0) {
+        if (strcmp(names[t->slot[i]], name) == 0) { *pos = i; return t->slot[i]; }
+        i = (i + 1) & (t->cap - 1);
+    }
+    *pos = i;
+    return -1;
+}
+
+int network_node(const res_network_t *net, const char *name) {
+    if (!net->names) {
+        char *end;
+        long v = strtol(name, &end, 10);
+        return (*end == '\0' && v >= 0 && v < net->n_nodes) ? (int)v : -1;
+    }
+    for (int i = 0; i < net->n_nodes; i++)
+        if (strcmp(net->names[i], name) == 0) return i;
+    return -1;
+}
+
+res_network_t *network_load(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) { printf("Error: cannot open %s\n", path); return NULL; }
+
+    int cap_e = 256, n_e = 0, cap_n = 256, n_n = 0;
+    int *ea = malloc(cap_e * sizeof(int)), *eb = malloc(cap_e * sizeof(int));
+    double *ohms = malloc(cap_e * sizeof(double));
+    char (*names)[NAME_LEN] = malloc(cap_n * sizeof(*names));
+    name_table_t tab = { malloc(512 * sizeof(int)), 512 };
+    char line[256];
+    int line_no = 0, ok = ea && eb && ohms && names && tab.slot;
+    res_network_t *net = NULL;
+
+    if (ok) memset(tab.slot, -1, tab.cap * sizeof(int));
+    while (ok && fgets(line, sizeof(line), f)) {
+        char n1[NAME_LEN], n2[NAME_LEN], val[64];
+        line_no++;
+        char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+        if (sscanf(p, "%31s %31s %63s", n1, n2, val) != 3) {
+            printf("Line %d: expected \"<node> <node> <value>\".\n", line_no);
+            ok = 0;
+            break;
+        }
+
+        size_t used;
+        double R = parse_prefix_n(val, strlen(val), &used);
+        if (used == 0 || !(R > 0.0)) {
+            printf("Line %d: resistance must be a positive value.\n", line_no);
+            ok = 0;
+            break;
+        }
+
+        int ids[2];
+        const char *nm[2] = { n1, n2 };
+        for (int k = 0; k < 2 && ok; k++) {
+            int pos, id = name_find(&tab, names, nm[k], &pos);
+            if (id < 0) {
+                if (n_n == cap_n) {
+                    void *b = realloc(names, (cap_n *= 2) * sizeof(*names));
+                    if (!b) { ok = 0; break; }
+                    names = b;
+                }
+                id = n_n++;
+                strcpy(names[id], nm[k]);
+                tab.slot[pos] = id;
+                if (n_n * 2 > tab.cap) {        /* grow and rehash */
+                    int *old = tab.slot;
+                    int old_cap = tab.cap;
+                    tab.cap *= 2;
+                    tab.slot = malloc(tab.cap * sizeof(int));
+                    if (!tab.slot) { tab.slot = old; tab.cap = old_cap; ok = 0; break; }
+                    memset(tab.slot, -1, tab.cap * sizeof(int));
+                    for (int s = 0; s < old_cap; s++) {
+                        if (old[s] < 0) continue;
+                        name_find(&tab, names, names[old[s]], &pos);
+                        tab.slot[pos] = old[s];
+                    }
+                    free(old);
+                }
+            }
+            ids[k] = id;
+        }
+        if (!ok) break;
+
+        if (n_e == cap_e) {
+            cap_e *= 2;
+            int *a2 = realloc(ea, cap_e * sizeof(int));
+            if (a2) ea = a2;
+            int *b2 = realloc(eb, cap_e * sizeof(int));
+            if (b2) eb = b2;
+            double *o2 = realloc(ohms, cap_e * sizeof(double));
+            if (o2) ohms = o2;
+            if (!a2 || !b2 || !o2) { ok = 0; break; }
+        }
+        ea[n_e] = ids[0];
+        eb[n_e] = ids[1];
+        ohms[n_e] = R;
+        n_e++;
+    }
+    fclose(f);
+
+    if (ok && n_e == 0) { printf("Netlist %s has no resistors.\n", path); ok = 0; }
+    if (ok) net = network_create(n_n, n_e, ea, eb, ohms);
+    if (net) { net->names = names; names = NULL; }
+    else if (ok) printf("Error: out of memory\n");
+
+    free(ea); free(eb); free(ohms); free(names); free(tab.slot);
+    return net;
+}
+
+/* ────────────────────────────────────────────────
+   LAPLACIAN AND IC(0) PRECONDITIONER
+   Each connected component is grounded at its
+   lowest-numbered node, which makes the reduced
+   Laplacian symmetric positive definite.
+   ──────────────────────────────────────────────── */
+
+static int uf_find(int *parent, int x) {
+    while (parent[x] != x) x = parent[x] = parent[parent[x]];
+    return x;
+}
+
+typedef struct {
+    int col;
+    double val;
+} entry_t;
+
+static int cmp_entry(const void *a, const void *b) {
+    return ((const entry_t *)a)->col - ((const entry_t *)b)->col;
+}
+
+static int build_laplacian(res_network_t *net) {
+    int n = net->n_nodes;
+    int *parent = malloc(n * sizeof(int));
+    net->comp = malloc(n * sizeof(int));
+    net->unknown = malloc(n * sizeof(int));
+    if (!parent || !net->comp || !net->unknown) { free(parent); return 0; }
+
+    for (int i = 0; i < n; i++) parent[i] = i;
+    for (int e = 0; e < net->n_edges; e++) {
+        int a = uf_find(parent, net->ea[e]), b = uf_find(parent, net->eb[e]);
+        if (a != b) parent[a < b ? b : a] = a < b ? a : b;   /* root = lowest node */
+    }
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        net->comp[i] = uf_find(parent, i);
+        net->unknown[i] = net->comp[i] == i ? -1 : m++;
+    }
+    free(parent);
+
+    /* Count entries per row: diagonal plus one per incident non-ground edge end */
+    csr_t *A = &net->A;
+    A->n = m;
+    A->row = calloc(m + 1, sizeof(int));
+    if (!A->row) return 0;
+    for (int e = 0; e < net->n_edges; e++) {
+        int a = net->unknown[net->ea[e]], b = net->unknown[net->eb[e]];
+        if (net->ea[e] == net->eb[e]) continue;
+        if (a >= 0) A->row[a + 1] += 1 + (b >= 0);
+        if (b >= 0) A->row[b + 1] += 1 + (a >= 0);
+    }
+    for (int i = 0; i < m; i++) A->row[i + 1] += A->row[i];
+
+    int nnz = A->row[m];
+    entry_t *ent = malloc((nnz + 1) * sizeof(entry_t));
+    int *fill = malloc((m + 1) * sizeof(int));
+    if (!ent || !fill) { free(ent); free(fill); return 0; }
+    memcpy(fill, A->row, m * sizeof(int));
+
+    for (int e = 0; e < net->n_edges; e++) {
+        int a = net->unknown[net->ea[e]], b = net->unknown[net->eb[e]];
+        double g = net->g[e];
+        if (net->ea[e] == net->eb[e]) continue;
+        if (a >= 0) {
+            ent[fill[a]++] = (entry_t){ a, g };
+            if (b >= 0) ent[fill[a]++] = (entry_t){ b, -g };
+        }
+        if (b >= 0) {
+            ent[fill[b]++] = (entry_t){ b, g };
+            if (a >= 0) ent[fill[b]++] = (entry_t){ a, -g };
+        }
+    }
+    free(fill);
+
+    /* Sort each row and merge duplicates (parallel resistors, repeated diagonal) */
+    A->col = malloc((nnz + 1) * sizeof(int));
+    A->val = malloc((nnz + 1) * sizeof(double));
+    if (!A->col || !A->val) { free(ent); return 0; }
+    int out = 0;
+    for (int i = 0; i < m; i++) {
+        int begin = A->row[i], end = A->row[i + 1];
+        qsort(ent + begin, end - begin, sizeof(entry_t), cmp_entry);
+        A->row[i] = out;
+        for (int k = begin; k < end; k++) {
+            if (out > A->row[i] && A->col[out - 1] == ent[k].col) A->val[out - 1] += ent[k].val;
+            else { A->col[out] = ent[k].col; A->val[out] = ent[k].val; out++; }
+        }
+    }
+    A->row[m] = out;
+    free(ent);
+    return 1;
+}
+
+/* Incomplete Cholesky with the sparsity of A's lower triangle */
+static int build_ic0(res_network_t *net) {
+    const csr_t *A = &net->A;
+    csr_t *L = &net->L;
+    int m = A->n;
+
+    L->n = m;
+    L->row = malloc((m + 1) * sizeof(int));
+    if (!L->row) return 0;
+    L->row[0] = 0;
+    for (int i = 0; i < m; i++) {
+        int cnt = 0;
+        for (int k = A->row[i]; k < A->row[i + 1]; k++) cnt += A->col[k] <= i;
+        L->row[i + 1] = L->row[i] + cnt;
+    }
+    L->col = malloc((L->row[m] + 1) * sizeof(int));
+    L->val = malloc((L->row[m] + 1) * sizeof(double));
+    if (!L->col || !L->val) return 0;
+
+    for (int i = 0; i < m; i++) {
+        int p = L->row[i];
+        for (int k = A->row[i]; k < A->row[i + 1] && A->col[k] <= i; k++, p++) {
+            L->col[p] = A->col[k];
+            L->val[p] = A->val[k];
+        }
+    }
+
+    for (int i = 0; i < m; i++) {
+        int ri0 = L->row[i], ri1 = L->row[i + 1];       /* diagonal is last */
+        for (int p = ri0; p < ri1 - 1; p++) {
+            int k = L->col[p];
+            /* L_ik = (A_ik - sum over common j < k of L_ij L_kj) / L_kk */
+            double s = L->val[p];
+            int a = ri0, b = L->row[k], bend = L->row[k + 1] - 1;
+            while (a < p && b < bend) {
+                if (L->col[a] == L->col[b]) s -= L->val[a++] * L->val[b++];
+                else if (L->col[a] < L->col[b]) a++;
+                else b++;
+            }
+            L->val[p] = s / L->val[bend];
+        }
+        double d = L->val[ri1 - 1];
+        for (int q = ri0; q < ri1 - 1; q++) d -= L->val[q] * L->val[q];
+        if (!(d > 0.0)) d = L->val[ri1 - 1];        /* breakdown: keep the plain diagonal */
+        L->val[ri1 - 1] = sqrt(d);
+    }
+    return 1;
+}
+
+static int network_prepare(res_network_t *net) {
+    if (net->prepared) return 1;
+    if (!build_laplacian(net) || !build_ic0(net)) {
+        network_unprepare(net);
+        printf("Error: out of memory\n");
+        return 0;
+    }
+    net->prepared = 1;
+    return 1;
+}
+
+/* ────────────────────────────────────────────────
+   PRECONDITIONED CONJUGATE GRADIENTS
+   ──────────────────────────────────────────────── */
+
+static void spmv(const csr_t *A, const double *x, double *y) {
+    for (int i = 0; i < A->n; i++) {
+        double s = 0.0;
+        for (int k = A->row[i]; k < A->row[i + 1]; k++) s += A->val[k] * x[A->col[k]];
+        y[i] = s;
+    }
+}
+
+/* z = (L Lᵀ)⁻¹ r */
+static void precondition(const csr_t *L, const double *r, double *z) {
+    int m = L->n;
+    for (int i = 0; i < m; i++) {
+        double s = r[i];
+        int last = L->row[i + 1] - 1;
+        for (int k = L->row[i]; k < last; k++) s -= L->val[k] * z[L->col[k]];
+        z[i] = s / L->val[last];
+    }
+    for (int i = m - 1; i >= 0; i--) {
+        int last = L->row[i + 1] - 1;
+        z[i] /= L->val[last];
+        for (int k = L->row[i]; k < last; k++) z[L->col[k]] -= L->val[k] * z[i];
+    }
+}
+
+static double dot(const double *a, const double *b, int n) {
+    double s = 0.0;
+    for (int i = 0; i < n; i++) s += a[i] * b[i];
+    return s;
+}
+
+/* Solve A x = b; work holds 4 m doubles. Returns 0 if the iteration
+   cap was reached before the residual fell below CG_TOL. */
+static int pcg(const csr_t *A, const csr_t *L, const double *b, double *x, double *work) {
+    int m = A->n;
+    double *r = work, *z = work + m, *p = work + 2 * m, *q = work + 3 * m;
+
+    memset(x, 0, m * sizeof(double));
+    memcpy(r, b, m * sizeof(double));
+    precondition(L, r, z);
+    memcpy(p, z, m * sizeof(double));
+    double rz = dot(r, z, m), bnorm = sqrt(dot(b, b, m));
+    if (bnorm == 0.0) return 1;
+
+    for (int it = 0; it < 10 * m + 100; it++) {
+        spmv(A, p, q);
+        double alpha = rz / dot(p, q, m);
+        for (int i = 0; i < m; i++) { x[i] += alpha * p[i]; r[i] -= alpha * q[i]; }
+        if (sqrt(dot(r, r, m)) <= CG_TOL * bnorm) return 1;
+        precondition(L, r, z);
+        double rz_new = dot(r, z, m);
+        double beta = rz_new / rz;
+        rz = rz_new;
+        for (int i = 0; i < m; i++) p[i] = z[i] + beta * p[i];
+    }
+    return 0;
+}
+
+typedef struct {
+    res_network_t *net;
+    const int *from, *to;
+    double *out;
+    atomic_int no_memory, unconverged;      /* queries that failed, counted across workers */
+} query_job_t;
+
+static void query_task(void *ctx, int qi) {
+    query_job_t *job = ctx;
+    res_network_t *net = job->net;
+    int a = job->from[qi], b = job->to[qi], m = net->A.n;
+
+    if (a == b) { job->out[qi] = 0.0; return; }
+    if (net->comp[a] != net->comp[b]) { job->out[qi] = INFINITY; return; }
+
+    double *buf = calloc((size_t)6 * m + 1, sizeof(double));
+    if (!buf) {
+        job->out[qi] = NAN;
+        atomic_fetch_add_explicit(&job->no_memory, 1, memory_order_relaxed);
+        return;
+    }
+    double *rhs = buf, *x = buf + m, *work = buf + 2 * m;
+    int ua = net->unknown[a], ub = net->unknown[b];
+    if (ua >= 0) rhs[ua] = 1.0;
+    if (ub >= 0) rhs[ub] = -1.0;
+
+    if (pcg(&net->A, &net->L, rhs, x, work)) {
+        job->out[qi] = (ua >= 0 ? x[ua] : 0.0) - (ub >= 0 ? x[ub] : 0.0);
+    } else {
+        job->out[qi] = NAN;
+        atomic_fetch_add_explicit(&job->unconverged, 1, memory_order_relaxed);
+    }
+    free(buf);
+}
+
+int network_resistance(res_network_t *net, int n_queries, const int *from,
+                       const int *to, double *out) {
+    for (int q = 0; q < n_queries; q++) {
+        if (from[q] < 0 || from[q] >= net->n_nodes || to[q] < 0 || to[q] >= net->n_nodes) {
+            printf("Invalid node in query %d.\n", q + 1);
+            return 1;
+        }
+    }
+    if (!network_prepare(net)) return 1;
+
+    query_job_t job = { net, from, to, out, 0, 0 };
+    par_for(n_queries, query_task, &job);
+    int no_memory = atomic_load(&job.no_memory), unconverged = atomic_load(&job.unconverged);
+    if (no_memory) printf("Error: out of memory\n");
+    if (unconverged)
+        printf("Warning: %d of %d queries did not converge (network too ill-conditioned).\n",
+               unconverged, n_queries);
+    return no_memory || unconverged;
+}
@@ -0,0 +1,37 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+/* Equivalent resistance between node pairs of an arbitrary resistor
+   network (meshes, bridges, ladders), found by solving the graph
+   Laplacian with incomplete-Cholesky preconditioned conjugate gradients.
+
+   Netlist file: one resistor per line, "<node> <node> <value>", e.g.
+       # Wheatstone bridge
+       in  a   1k
+       in  b   2.2k
+       a   b   4.7k
+       a   gnd 3.3k
+       b   gnd 1k
+   Node names are any words; values accept SI prefixes. */
+
+typedef struct res_network res_network_t;
+
+/* Returns NULL (after printing why) on a bad file or netlist */
+res_network_t *network_load(const char *path);
+res_network_t *network_create(int n_nodes, int n_edges, const int *node_a,
+                              const int *node_b, const double *ohms);
+void network_free(res_network_t *net);
+
+int network_nodes(const res_network_t *net);
+int network_node(const res_network_t *net, const char *name);   /* -1 if unknown */
+
+/* out[q] = resistance between from[q] and to[q] (INFINITY when the two
+   nodes are not connected). The Laplacian and its preconditioner are
+   built once on first use and shared by all queries, which are solved
+   in parallel. Returns 0 on success, or 1 after printing why: out of
+   memory, or a query whose solve hit its iteration cap before
+   converging (that query's out[] is NAN rather than a guess). */
+int network_resistance(res_network_t *net, int n_queries, const int *from,
+                       const int *to, double *out);
+
+#endif
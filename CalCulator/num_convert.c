@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel.h"
+#include "file_map.h"
+#include "num_convert.h"
+
+#define CONVERT_WINDOW (64u << 20)      /* bytes of input converted per round */
+
+#define ONES  0x0101010101010101ull
+#define HIGHS 0x8080808080808080ull
+
+/* ────────────────────────────────────────────────
+   PARSING
+   Eight characters are loaded into one word; range
+   checks and digit packing then run on all eight
+   bytes at once (SWAR).
+   ──────────────────────────────────────────────── */
+
+static uint64_t load8(const char *s) {
+    uint64_t x;
+    memcpy(&x, s, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap64(x);
+#endif
+    return x;                           /* first character in the low byte */
+}
+
+/* High bit of every byte with lo <= byte <= hi; bytes must be < 0x80 */
+static uint64_t bytes_in_range(uint64_t x, unsigned lo, unsigned hi) {
+    uint64_t above = x + ONES * (127 - hi);
+    uint64_t from = x + ONES * (128 - lo);
+    return from & ~above & HIGHS;
+}
+
+/* Eight digit values (one per byte, first = most significant) of 'bits'
+   bits each, packed into one 8*bits-bit number */
+static uint64_t pack_digits(uint64_t x, int bits) {
+    x = ((x << bits) | (x >> 8)) & 0x00FF00FF00FF00FFull;
+    x = ((x << 2 * bits) | (x >> 16)) & 0x0000FFFF0000FFFFull;
+    return ((x << 4 * bits) | (x >> 32)) & ((1ull << 8 * bits) - 1);
+}
+
+/* Value of eight digits in x, or 0 (and *ok = 0) if any byte is not a digit */
+static uint64_t chunk8(uint64_t x, int base, int *ok) {
+    if (x & HIGHS) { *ok = 0; return 0; }
+    switch (base) {
+        case 2:
+            *ok = (x & ~ONES) == ONES * '0';
+            return pack_digits(x & ONES, 1);
+        case 8:
+            *ok = bytes_in_range(x, '0', '7') == HIGHS;
+            return pack_digits(x & ONES * 7, 3);
+        case 16: {
+            uint64_t digit = bytes_in_range(x, '0', '9');
+            uint64_t alpha = bytes_in_range(x | ONES * 0x20, 'a', 'f');
+            *ok = (digit | alpha) == HIGHS;
+            return pack_digits((x & ONES * 0x0F) + (alpha >> 7) * 9, 4);
+        }
+        default:
+            *ok = bytes_in_range(x, '0', '9') == HIGHS;
+            x -= ONES * '0';
+            x = x * 10 + (x >> 8);              /* digit pairs in bytes 0, 2, 4, 6 */
+            return (((x & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+                    (((x >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    }
+}
+
+static int digit_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;
+    return c >= 'a' && c <= 'f' ? c - 'a' + 10 : 99;
+}
+
+static int valid_base(int base) {
+    return base == 2 || base == 8 || base == 10 || base == 16;
+}
+
+static int parse_digits(const char *s, size_t len, int base, uint64_t *out) {
+    int shift = base == 2 ? 1 : base == 8 ? 3 : base == 16 ? 4 : 0;
+    uint64_t v = 0;
+    size_t i = 0;
+    if (len == 0) return NUM_INVALID;
+
+    for (; i + 8 <= len; i += 8) {
+        int ok;
+        uint64_t chunk = chunk8(load8(s + i), base, &ok);
+        if (!ok) return NUM_INVALID;
+        if (shift) {
+            if (v >> (64 - 8 * shift)) return NUM_OVERFLOW;
+            v = (v << 8 * shift) | chunk;
+        } else if (__builtin_mul_overflow(v, 100000000ull, &v) || __builtin_add_overflow(v, chunk, &v)) {
+            return NUM_OVERFLOW;
+        }
+    }
+    for (; i < len; i++) {
+        int d = digit_value(s[i]);
+        if (d >= base) return NUM_INVALID;
+        if (shift) {
+            if (v >> (64 - shift)) return NUM_OVERFLOW;
+            v = (v << shift) | (uint64_t)d;
+        } else if (__builtin_mul_overflow(v, 10, &v) || __builtin_add_overflow(v, (uint64_t)d, &v)) {
+            return NUM_OVERFLOW;
+        }
+    }
+    *out = v;
+    return NUM_OK;
+}
+
+int num_parse(const char *s, size_t len, int base, uint64_t *out) {
+    int prefix = 0;
+    if (len > 2 && s[0] == '0') {
+        switch (s[1] | 0x20) {
+            case 'x': prefix = 16; break;
+            case 'b': prefix = 2; break;
+            case 'o': prefix = 8; break;
+        }
+    }
+    if (base == NUM_AUTO) base = prefix ? prefix : len > 1 && s[0] == '0' ? 8 : 10;
+    if (!valid_base(base)) return NUM_INVALID;
+    if (prefix == base) { s += 2; len -= 2; }
+    return parse_digits(s, len, base, out);
+}
+
+/* ────────────────────────────────────────────────
+   FORMATTING
+   Digits come from small tables, written from the
+   least significant end.
+   ──────────────────────────────────────────────── */
+
+static const char dec_pairs[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static const char bin_nibbles[16][4] = {
+    {'0','0','0','0'}, {'0','0','0','1'}, {'0','0','1','0'}, {'0','0','1','1'},
+    {'0','1','0','0'}, {'0','1','0','1'}, {'0','1','1','0'}, {'0','1','1','1'},
+    {'1','0','0','0'}, {'1','0','0','1'}, {'1','0','1','0'}, {'1','0','1','1'},
+    {'1','1','0','0'}, {'1','1','0','1'}, {'1','1','1','0'}, {'1','1','1','1'}
+};
+
+size_t num_format(uint64_t v, int base, int min_digits, int flags, char *buf) {
+    char digits[64];
+    char *end = digits + sizeof(digits), *p = end;
+
+    switch (base) {
+        case 2:
+            for (int i = 0; i < 16; i++) memcpy(end - 4 * (i + 1), bin_nibbles[(v >> 4 * i) & 15], 4);
+            p = end - (v ? 64 - __builtin_clzll(v) : 1);
+            break;
+        case 8:
+            do { *--p = (char)('0' + (v & 7)); v >>= 3; } while (v);
+            break;
+        case 10:
+            while (v >= 100) { p -= 2; memcpy(p, dec_pairs + 2 * (v % 100), 2); v /= 100; }
+            if (v >= 10) { p -= 2; memcpy(p, dec_pairs + 2 * v, 2); }
+            else *--p = (char)('0' + v);
+            break;
+        case 16:
+            do { *--p = hex_digits[v & 15]; v >>= 4; } while (v);
+            break;
+        default:
+            buf[0] = '\0';
+            return 0;
+    }
+
+    if (min_digits > 64) min_digits = 64;
+    if (base == 2) { if (end - p < min_digits) p = end - min_digits; }
+    else while (end - p < min_digits) *--p = '0';
+
+    size_t n = 0;
+    if (flags & NUM_PREFIX) {
+        if (base == 2) { buf[n++] = '0'; buf[n++] = 'b'; }
+        if (base == 8 && !(p[0] == '0' && end - p == 1)) buf[n++] = '0';
+        if (base == 16) { buf[n++] = '0'; buf[n++] = 'x'; }
+    }
+    int count = (int)(end - p);
+    if (base == 2 && (flags & NUM_GROUP)) {
+        for (int i = 0; i < count; i++) {
+            if (i && (count - i) % 4 == 0) buf[n++] = ' ';
+            buf[n++] = p[i];
+        }
+    } else {
+        memcpy(buf + n, p, count);
+        n += count;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+/* ────────────────────────────────────────────────
+   BULK CONVERSION
+   Same scheme as the BOM decoder: the mapped file is
+   walked in CONVERT_WINDOW pieces cut at line ends,
+   each piece is split across the worker pool, and the
+   per-task outputs are written in task order.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    file_out_t out;
+    size_t converted, skipped;
+} conv_out_t;
+
+typedef struct {
+    const char *data;
+    size_t size;
+    int n_tasks, in_base, out_base, flags;
+    conv_out_t *outs;
+} conv_chunk_t;
+
+static int is_token_char(unsigned char c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+}
+
+static void convert_task(void *ctx, int task) {
+    conv_chunk_t *c = ctx;
+    conv_out_t *o = &c->outs[task];
+    const char *data = c->data;
+    size_t pos = file_line_start(data, c->size, c->size / c->n_tasks * task);
+    size_t stop = task == c->n_tasks - 1 ? c->size
+                : file_line_start(data, c->size, c->size / c->n_tasks * (task + 1));
+
+    file_out_t *b = &o->out;
+    b->len = 0;
+    while (pos < stop) {
+        size_t start = pos;
+        while (pos < stop && !is_token_char((unsigned char)data[pos])) pos++;
+        if (pos > start) {                              /* separators as they are */
+            if (!file_out_reserve(b, pos - start)) return;
+            memcpy(b->buf + b->len, data + start, pos - start);
+            b->len += pos - start;
+        }
+
+        start = pos;
+        while (pos < stop && is_token_char((unsigned char)data[pos])) pos++;
+        if (pos == start) continue;
+        if (!file_out_reserve(b, (pos - start) + NUM_MAX_CHARS)) return;
+        uint64_t v;
+        if (num_parse(data + start, pos - start, c->in_base, &v) == NUM_OK) {
+            b->len += num_format(v, c->out_base, 1, c->flags, b->buf + b->len);
+            o->converted++;
+        } else {
+            memcpy(b->buf + b->len, data + start, pos - start);
+            b->len += pos - start;
+            o->skipped++;
+        }
+    }
+}
+
+int num_convert_file(const char *in_path, const char *out_path, int in_base, int out_base, int flags) {
+    if ((in_base != NUM_AUTO && !valid_base(in_base)) || !valid_base(out_base)) {
+        fprintf(stderr, "Error: bases must be 2, 8, 10 or 16\n");
+        return 1;
+    }
+    file_map_t in;
+    int rc = file_map(in_path, &in);
+    if (rc) { fprintf(stderr, "Error: cannot read %s (%s)\n", in_path, file_map_error(rc)); return 1; }
+    FILE *out = strcmp(out_path, "-") == 0 ? stdout : fopen(out_path, "wb");
+    if (!out) {
+        fprintf(stderr, "Error: cannot create %s\n", out_path);
+        file_unmap(&in);
+        return 1;
+    }
+
+    /* rc: 1 = out of memory, 2 = writing failed */
+    int n_tasks = par_threads() * 4;
+    conv_out_t *outs = calloc(n_tasks, sizeof(conv_out_t));
+    size_t converted = 0, skipped = 0;
+    if (!outs) rc = 1;
+
+    for (size_t pos = 0; !rc && pos < in.size; ) {
+        size_t end = pos + CONVERT_WINDOW < in.size ? file_line_start(in.data, in.size, pos + CONVERT_WINDOW) : in.size;
+        conv_chunk_t chunk = { in.data + pos, end - pos, n_tasks, in_base, out_base, flags, outs };
+        if (chunk.size < (size_t)n_tasks * 64) chunk.n_tasks = 1;      /* not worth splitting */
+        par_for(chunk.n_tasks, convert_task, &chunk);
+        for (int t = 0; t < chunk.n_tasks; t++)
+            if (outs[t].out.failed) rc = 1;
+        for (int t = 0; !rc && t < chunk.n_tasks; t++)
+            if (fwrite(outs[t].out.buf, 1, outs[t].out.len, out) != outs[t].out.len) rc = 2;
+        pos = end;
+    }
+
+    if (outs)
+        for (int t = 0; t < n_tasks; t++) {
+            converted += outs[t].converted;
+            skipped += outs[t].skipped;
+            free(outs[t].out.buf);
+        }
+    free(outs);
+    file_unmap(&in);
+    if (out != stdout) { if (fclose(out) != 0 && !rc) rc = 2; }
+    else if (fflush(out) != 0 && !rc) rc = 2;
+
+    if (rc == 1) fprintf(stderr, "Error: out of memory\n");
+    else if (rc == 2) fprintf(stderr, "Error: writing %s failed\n", out_path);
+    else fprintf(stderr, "%zu numbers converted, %zu other words kept\n", converted, skipped);
+    return rc != 0;
+}
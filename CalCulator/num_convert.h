@@ -0,0 +1,42 @@
+#ifndef NUM_CONVERT_H
+#define NUM_CONVERT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* 64-bit unsigned integers in binary, octal, decimal and hex.
+
+   Parsing takes base 2, 8, 10 or 16, or NUM_AUTO to pick the base from
+   the prefix: 0x hex, 0b binary, 0o or a leading 0 octal, else decimal.
+   With an explicit base the matching prefix is optional. Eight digits
+   at a time are checked and combined inside one 64-bit word. */
+
+#define NUM_AUTO     0
+
+#define NUM_OK       0
+#define NUM_INVALID  1          /* empty, bad digit or bad prefix */
+#define NUM_OVERFLOW 2          /* does not fit in 64 bits */
+
+int num_parse(const char *s, size_t len, int base, uint64_t *out);
+
+/* Format flags */
+#define NUM_PREFIX   1          /* 0b / 0 / 0x in front (nothing for decimal) */
+#define NUM_GROUP    2          /* space between binary nibbles */
+
+/* Longest output: 64 binary digits, 15 group spaces, prefix, NUL */
+#define NUM_MAX_CHARS 82
+
+/* Digits of v in base 2, 8, 10 or 16 (upper-case hex), zero-padded to at
+   least min_digits. Writes a NUL-terminated string and returns its
+   length, or 0 for an unsupported base. */
+size_t num_format(uint64_t v, int base, int min_digits, int flags, char *buf);
+
+/* Convert every number in a text file (register dumps, memory images):
+   each run of letters and digits that parses in in_base is rewritten in
+   out_base; everything else, including tokens that do not parse, is
+   copied unchanged. The file is memory-mapped and converted on the
+   worker pool; output keeps input order ("-" = stdin/stdout). Returns
+   0 on success, or 1 after telling stderr why. */
+int num_convert_file(const char *in_path, const char *out_path, int in_base, int out_base, int flags);
+
+#endif
@@ -1,7 +1,7 @@
-#ifndef OHMS_LAW_H
-#define OHMS_LAW_H
-
-/* Public interface for Ohm's law module */
-void ohms_menu(void);
-
-#endif /* OHMS_LAW_H */
+#ifndef OHMS_LAW_H
+#define OHMS_LAW_H
+
+/* Public interface for Ohm's law module */
+void ohms_menu(void);
+
+#endif /* OHMS_LAW_H */
@@ -0,0 +1,133 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "parallel.h"
+
+#define PAR_MAX_THREADS 256
+
+static int n_threads = 0;
+
+void par_set_threads(int n) {
+    if (n < 0) n = 0;
+    if (n > PAR_MAX_THREADS) n = PAR_MAX_THREADS;
+    n_threads = n;
+}
+
+int par_threads(void) {
+    if (n_threads > 0) return n_threads;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    if (cpus > PAR_MAX_THREADS) cpus = PAR_MAX_THREADS;
+    return (int)cpus;
+}
+
+typedef struct {
+    _Alignas(64) atomic_uint_least64_t range;  /* next task << 32 | end */
+} par_slot_t;
+
+typedef struct {
+    void (*fn)(void *ctx, int task, int worker);
+    void *ctx;
+    int n_workers;
+    par_slot_t slot[PAR_MAX_THREADS];
+} par_job_t;
+
+typedef struct {
+    par_job_t *job;
+    int id;
+} par_arg_t;
+
+#define RANGE(lo, hi) ((uint64_t)(lo) << 32 | (uint32_t)(hi))
+
+/* Next task from the worker's own run, -1 when it is empty */
+static int take_own(par_slot_t *s) {
+    uint64_t r = atomic_load_explicit(&s->range, memory_order_relaxed);
+    for (;;) {
+        uint32_t lo = (uint32_t)(r >> 32), hi = (uint32_t)r;
+        if (lo >= hi) return -1;
+        if (atomic_compare_exchange_weak_explicit(&s->range, &r, RANGE(lo + 1, hi),
+                                                  memory_order_relaxed, memory_order_relaxed))
+            return (int)lo;
+    }
+}
+
+/* Move the back half of another worker's run into our own slot */
+static int steal(par_job_t *job, int id) {
+    for (int k = 1; k < job->n_workers; k++) {
+        par_slot_t *v = &job->slot[(id + k) % job->n_workers];
+        uint64_t r = atomic_load_explicit(&v->range, memory_order_relaxed);
+        for (;;) {
+            uint32_t lo = (uint32_t)(r >> 32), hi = (uint32_t)r;
+            if (lo >= hi) break;
+            uint32_t mid = hi - (hi - lo + 1) / 2;
+            if (atomic_compare_exchange_weak_explicit(&v->range, &r, RANGE(lo, mid),
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                atomic_store_explicit(&job->slot[id].range, RANGE(mid, hi), memory_order_relaxed);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void *par_worker(void *arg) {
+    par_arg_t *a = arg;
+    par_job_t *job = a->job;
+    int t;
+    do {
+        while ((t = take_own(&job->slot[a->id])) >= 0)
+            job->fn(job->ctx, t, a->id);
+    } while (steal(job, a->id));
+    return NULL;
+}
+
+void par_for_worker(int n_tasks, void (*fn)(void *ctx, int task, int worker), void *ctx) {
+    if (n_tasks <= 0) return;
+
+    par_job_t *job = aligned_alloc(64, sizeof(par_job_t));
+    if (!job) {                         /* no memory for the pool: run inline */
+        for (int t = 0; t < n_tasks; t++) fn(ctx, t, 0);
+        return;
+    }
+    int n = par_threads();
+    if (n > n_tasks) n = n_tasks;
+    job->fn = fn;
+    job->ctx = ctx;
+    job->n_workers = n;
+    for (int i = 0; i < n; i++)
+        atomic_init(&job->slot[i].range, RANGE((int64_t)n_tasks * i / n, (int64_t)n_tasks * (i + 1) / n));
+
+    pthread_t tid[PAR_MAX_THREADS];
+    par_arg_t args[PAR_MAX_THREADS];
+    int started = 0;
+    for (int i = 0; i < n; i++) args[i] = (par_arg_t){ job, i };
+    for (int i = 1; i < n; i++) {
+        if (pthread_create(&tid[started], NULL, par_worker, &args[i]) != 0) break;
+        started++;
+    }
+
+    par_worker(&args[0]);   /* the caller works too and steals what failed threads left */
+
+    for (int i = 0; i < started; i++)
+        pthread_join(tid[i], NULL);
+    free(job);
+}
+
+/* Plain tasks ride on the worker form */
+typedef struct {
+    void (*fn)(void *ctx, int task);
+    void *ctx;
+} par_plain_t;
+
+static void par_plain(void *ctx, int task, int worker) {
+    par_plain_t *p = ctx;
+    (void)worker;
+    p->fn(p->ctx, task);
+}
+
+void par_for(int n_tasks, void (*fn)(void *ctx, int task), void *ctx) {
+    par_plain_t p = { fn, ctx };
+    par_for_worker(n_tasks, par_plain, &p);
+}
@@ -0,0 +1,19 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+/* Minimal worker pool shared by the bulk/batch engines.
+   par_for() runs fn(ctx, task) for every task in [0, n_tasks) on up to
+   par_threads() threads (the calling thread is one of them) and returns
+   once all tasks are done. Each thread starts on its own contiguous run
+   of tasks and, once that is used up, steals half of what is left of
+   another thread's run, so tasks may run in any order and on any thread. */
+
+void par_set_threads(int n);   /* 0 = one per online CPU */
+int par_threads(void);
+void par_for(int n_tasks, void (*fn)(void *ctx, int task), void *ctx);
+
+/* Same, also passing the worker running the task, 0 <= worker <
+   par_threads(), for per-thread scratch space and partial results */
+void par_for_worker(int n_tasks, void (*fn)(void *ctx, int task, int worker), void *ctx);
+
+#endif
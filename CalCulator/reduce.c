@@ -0,0 +1,220 @@
+#include <stdlib.h>
+#include "parallel.h"
+#include "reduce.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REDUCE_X86 1
+#endif
+
+#define LANES          8
+#define BLOCK          8192                 /* elements per partial sum */
+#define BLOCKS_PER_TASK 64
+#define LEAF_BLOCKS    1024                 /* partials kept on the stack at once */
+#define PAR_MIN        (1u << 20)           /* below this one thread is faster */
+
+/* A sum carried with its running rounding error */
+typedef struct {
+    double s, c;
+} csum_t;
+
+/* Error-free addition: s + e == a + b exactly */
+static inline void two_sum(double a, double b, double *s, double *e) {
+    double t = a + b;
+    double bp = t - a;
+    *e = (a - (t - bp)) + (b - bp);
+    *s = t;
+}
+
+static csum_t csum_merge(csum_t a, csum_t b) {
+    csum_t r;
+    double e;
+    two_sum(a.s, b.s, &r.s, &e);
+    r.c = a.c + b.c + e;
+    return r;
+}
+
+/* Lanes are always folded in the same order, whatever filled them */
+static csum_t fold_lanes(const double *s, const double *c) {
+    csum_t r = { s[0], c[0] };
+    for (int l = 1; l < LANES; l++) {
+        csum_t x = { s[l], c[l] };
+        r = csum_merge(r, x);
+    }
+    return r;
+}
+
+/* ────────────────────────────────────────────────
+   BLOCK KERNELS
+   Element i of a block always goes to lane i % 8.
+   ──────────────────────────────────────────────── */
+
+static void block_tail(const double *v, size_t from, size_t n, int recip, double *s, double *c) {
+    for (size_t i = from; i < n; i++) {
+        double x = recip ? 1.0 / v[i] : v[i], e;
+        int l = (int)(i % LANES);
+        two_sum(s[l], x, &s[l], &e);
+        c[l] += e;
+    }
+}
+
+static csum_t block_scalar(const double *v, size_t n, int recip) {
+    double s[LANES] = { 0 }, c[LANES] = { 0 };
+    block_tail(v, 0, n, recip, s, c);
+    return fold_lanes(s, c);
+}
+
+#ifdef REDUCE_X86
+
+#define SSE_STEP(S, C, X) do {                                          \
+        __m128d t_ = _mm_add_pd(S, X);                                  \
+        __m128d bp_ = _mm_sub_pd(t_, S);                                \
+        C = _mm_add_pd(C, _mm_add_pd(_mm_sub_pd(S, _mm_sub_pd(t_, bp_)),\
+                                     _mm_sub_pd(X, bp_)));              \
+        S = t_;                                                         \
+    } while (0)
+
+__attribute__((target("sse2")))
+static csum_t block_sse2(const double *v, size_t n, int recip) {
+    __m128d s0 = _mm_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    __m128d c0 = s0, c1 = s0, c2 = s0, c3 = s0;
+    const __m128d one = _mm_set1_pd(1.0);
+    size_t i = 0;
+
+    for (; i + LANES <= n; i += LANES) {
+        __m128d x0 = _mm_loadu_pd(v + i), x1 = _mm_loadu_pd(v + i + 2);
+        __m128d x2 = _mm_loadu_pd(v + i + 4), x3 = _mm_loadu_pd(v + i + 6);
+        if (recip) {
+            x0 = _mm_div_pd(one, x0); x1 = _mm_div_pd(one, x1);
+            x2 = _mm_div_pd(one, x2); x3 = _mm_div_pd(one, x3);
+        }
+        SSE_STEP(s0, c0, x0); SSE_STEP(s1, c1, x1);
+        SSE_STEP(s2, c2, x2); SSE_STEP(s3, c3, x3);
+    }
+
+    double s[LANES], c[LANES];
+    _mm_storeu_pd(s, s0); _mm_storeu_pd(s + 2, s1); _mm_storeu_pd(s + 4, s2); _mm_storeu_pd(s + 6, s3);
+    _mm_storeu_pd(c, c0); _mm_storeu_pd(c + 2, c1); _mm_storeu_pd(c + 4, c2); _mm_storeu_pd(c + 6, c3);
+    block_tail(v, i, n, recip, s, c);
+    return fold_lanes(s, c);
+}
+
+#define AVX_STEP(S, C, X) do {                                                  \
+        __m256d t_ = _mm256_add_pd(S, X);                                       \
+        __m256d bp_ = _mm256_sub_pd(t_, S);                                     \
+        C = _mm256_add_pd(C, _mm256_add_pd(_mm256_sub_pd(S, _mm256_sub_pd(t_, bp_)), \
+                                           _mm256_sub_pd(X, bp_)));             \
+        S = t_;                                                                 \
+    } while (0)
+
+__attribute__((target("avx2")))
+static csum_t block_avx2(const double *v, size_t n, int recip) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, c0 = s0, c1 = s0;
+    const __m256d one = _mm256_set1_pd(1.0);
+    size_t i = 0;
+
+    for (; i + LANES <= n; i += LANES) {
+        __m256d x0 = _mm256_loadu_pd(v + i), x1 = _mm256_loadu_pd(v + i + 4);
+        if (recip) {
+            x0 = _mm256_div_pd(one, x0);
+            x1 = _mm256_div_pd(one, x1);
+        }
+        AVX_STEP(s0, c0, x0);
+        AVX_STEP(s1, c1, x1);
+    }
+
+    double s[LANES], c[LANES];
+    _mm256_storeu_pd(s, s0); _mm256_storeu_pd(s + 4, s1);
+    _mm256_storeu_pd(c, c0); _mm256_storeu_pd(c + 4, c1);
+    block_tail(v, i, n, recip, s, c);
+    return fold_lanes(s, c);
+}
+
+#endif
+
+typedef csum_t (*block_fn)(const double *v, size_t n, int recip);
+
+static block_fn pick_block_fn(void) {
+#ifdef REDUCE_X86
+    if (__builtin_cpu_supports("avx2")) return block_avx2;
+    if (__builtin_cpu_supports("sse2")) return block_sse2;
+#endif
+    return block_scalar;
+}
+
+/* ────────────────────────────────────────────────
+   DRIVER
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    const double *v;
+    size_t n;
+    int recip;
+    block_fn fn;
+    csum_t *parts;                  /* partials of blocks b0 .. b0+n_tasks*BLOCKS_PER_TASK */
+    size_t b0, b1;
+} reduce_job_t;
+
+static void reduce_task(void *ctx, int task) {
+    reduce_job_t *job = ctx;
+    size_t b0 = job->b0 + (size_t)task * BLOCKS_PER_TASK;
+    size_t b1 = b0 + BLOCKS_PER_TASK < job->b1 ? b0 + BLOCKS_PER_TASK : job->b1;
+    for (size_t b = b0; b < b1; b++) {
+        size_t off = b * BLOCK;
+        size_t len = job->n - off < BLOCK ? job->n - off : BLOCK;
+        job->parts[b - job->b0] = job->fn(job->v + off, len, job->recip);
+    }
+}
+
+/* Fixed pairwise tree over the block partials */
+static csum_t merge_range(const csum_t *parts, size_t lo, size_t hi) {
+    if (hi - lo == 1) return parts[lo];
+    size_t mid = lo + (hi - lo) / 2;
+    return csum_merge(merge_range(parts, lo, mid), merge_range(parts, mid, hi));
+}
+
+/* Blocks lo .. hi-1, at most LEAF_BLOCKS of them, summed on the pool
+   into a stack array and merged */
+static csum_t reduce_leaf(reduce_job_t *job, size_t lo, size_t hi) {
+    csum_t parts[LEAF_BLOCKS];
+    job->parts = parts;
+    job->b0 = lo;
+    job->b1 = hi;
+    int n_tasks = (int)((hi - lo + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK);
+    if (job->n >= PAR_MIN)
+        par_for(n_tasks, reduce_task, job);
+    else
+        for (int t = 0; t < n_tasks; t++) reduce_task(job, t);
+    return merge_range(parts, 0, hi - lo);
+}
+
+/* Splits exactly where merge_range() would over all the partials, so
+   the order of additions does not depend on how many are held at once */
+static csum_t reduce_range(reduce_job_t *job, size_t lo, size_t hi) {
+    if (hi - lo <= LEAF_BLOCKS) return reduce_leaf(job, lo, hi);
+    size_t mid = lo + (hi - lo) / 2;
+    return csum_merge(reduce_range(job, lo, mid), reduce_range(job, mid, hi));
+}
+
+static double reduce(const double *v, size_t n, int recip) {
+    block_fn fn = pick_block_fn();
+    if (n == 0) return 0.0;
+
+    size_t n_blocks = (n + BLOCK - 1) / BLOCK;
+    if (n_blocks == 1) {
+        csum_t r = fn(v, n, recip);
+        return r.s + r.c;
+    }
+
+    reduce_job_t job = { v, n, recip, fn, NULL, 0, 0 };
+    csum_t r = reduce_range(&job, 0, n_blocks);
+    return r.s + r.c;
+}
+
+double sum_array(const double *v, size_t n) {
+    return reduce(v, n, 0);
+}
+
+double reciprocal_sum_array(const double *v, size_t n) {
+    return reduce(v, n, 1);
+}
@@ -0,0 +1,21 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <stddef.h>
+
+/* Compensated (Kahan-Babuska) sums over large arrays, for series and
+   parallel combinations of many components:
+       R, L in series / C in parallel:  sum_array()
+       R, L in parallel / C in series:  1 / reciprocal_sum_array()
+
+   Results are bit-identical whatever SIMD width the CPU offers (AVX2,
+   SSE2 or plain C) and however many threads par_for() uses: the array
+   is cut into fixed blocks, each block is summed in eight fixed lanes,
+   and the block partials are merged in a fixed pairwise order. No
+   memory is allocated, so the order cannot change under memory
+   pressure either. */
+
+double sum_array(const double *v, size_t n);
+double reciprocal_sum_array(const double *v, size_t n);   /* Σ 1/v[i] */
+
+#endif
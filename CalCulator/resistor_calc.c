@@ -1,313 +1,575 @@
-#include <stdio.h>
-#include <string.h>
-#include <ctype.h>
-#include <math.h>
-#include <stdlib.h>
-#include "math_ops.h"
-#include "resistor_calc.h"
-
-/* ────────────────────────────────────────────────
-   MATERIAL RESISTIVITY TABLE (Ω·m)
-   ──────────────────────────────────────────────── */
-
-typedef struct {
-    const char *name;
-    float rho;
-} material_t;
-
-static const material_t materials[] = {
-    {"Copper",   1.68e-8},
-    {"Aluminum", 2.82e-8},
-    {"Gold",     2.44e-8},
-    {"Silver",   1.59e-8},
-    {"Nichrome", 1.10e-6},
-    {"Iron",     1.00e-7},
-    {"Tungsten", 5.60e-8},
-    {NULL, 0.0f}
-};
-
-/* Utility */
-static float input_value(const char *prompt) {
-    char buf[32];
-    printf("%s", prompt);
-    scanf("%31s", buf);
-    return parse_with_prefix(buf);
-}
-
-/* ────────────────────────────────────────────────
-   BASIC CALCULATIONS (Series / Parallel / Resistivity)
-   ──────────────────────────────────────────────── */
-
-static void series_calc(void) {
-    int n;
-    printf("Enter number of resistors in series: ");
-    scanf("%d", &n);
-
-    if (n <= 0) { printf("Invalid number.\n"); return; }
-
-    float total = 0.0f;
-    for (int i = 0; i < n; i++) {
-        printf("R%d: ", i + 1);
-        char buf[32];
-        scanf("%31s", buf);
-        total += parse_with_prefix(buf);
-    }
-
-    printf("Equivalent Series Resistance = ");
-    print_with_prefix(total, "Ω");
-}
-
-static void parallel_calc(void) {
-    int n;
-    printf("Enter number of resistors in parallel: ");
-    scanf("%d", &n);
-
-    if (n <= 0) { printf("Invalid number.\n"); return; }
-
-    float inv_total = 0.0f;
-    for (int i = 0; i < n; i++) {
-        printf("R%d: ", i + 1);
-        char buf[32];
-        scanf("%31s", buf);
-        float R = parse_with_prefix(buf);
-        if (R == 0.0f) { printf("Error: R cannot be 0.\n"); return; }
-        inv_total += 1.0f / R;
-    }
-
-    float total = 1.0f / inv_total;
-    printf("Equivalent Parallel Resistance = ");
-    print_with_prefix(total, "Ω");
-}
-
-static void resistivity_calc(void) {
-    int choice;
-    printf("\nChoose material:\n");
-    for (int i = 0; materials[i].name; i++) {
-        printf("%d. %s\n", i + 1, materials[i].name);
-    }
-    printf("Select option: ");
-    scanf("%d", &choice);
-
-    if (choice <= 0 || materials[choice - 1].name == NULL) {
-        printf("Invalid choice.\n");
-        return;
-    }
-
-    float rho = materials[choice - 1].rho;
-    float L = input_value("Enter length L (m, supports prefixes): ");
-    float A = input_value("Enter cross-sectional area A (m^2): ");
-    if (A == 0.0f) { printf("Error: Area cannot be 0.\n"); return; }
-
-    float R = rho * (L / A);
-    printf("Resistance (R = ρL/A) for %s = ", materials[choice - 1].name);
-    print_with_prefix(R, "Ω");
-}
-
-/* ────────────────────────────────────────────────
-   COLOUR CODE SECTION
-   ──────────────────────────────────────────────── */
-
-typedef struct {
-    const char *name;
-    int digit;
-    float multiplier;
-    float tolerance;
-} color_t;
-
-static const color_t colors[] = {
-    {"black",  0, 1.0f,   -1},
-    {"brown",  1, 10.0f,  1},
-    {"red",    2, 100.0f, 2},
-    {"orange", 3, 1e3f,   -1},
-    {"yellow", 4, 1e4f,   -1},
-    {"green",  5, 1e5f,   0.5f},
-    {"blue",   6, 1e6f,   0.25f},
-    {"violet", 7, 1e7f,   0.1f},
-    {"grey",   8, 1e8f,   0.05f},
-    {"white",  9, 1e9f,   -1},
-    {"gold",  -1, 0.1f,   5},
-    {"silver",-1, 0.01f, 10},
-    {NULL, -1, -1, -1}
-};
-
-static int find_color(const char *name) {
-    for (int i = 0; colors[i].name; i++) {
-        if (strcasecmp(name, colors[i].name) == 0)
-            return i;
-    }
-    return -1;
-}
-
-static void decode_color(void) {
-    char c1[16], c2[16], c3[16], c4[16], c5[16];
-    int type;
-    printf("Enter type (4 for 4-band, 5 for 5-band): ");
-    scanf("%d", &type);
-
-    if (type == 4) {
-        printf("Enter colours (Band1 Band2 Multiplier Tolerance): ");
-        scanf("%s %s %s %s", c1, c2, c3, c4);
-        int i1 = find_color(c1);
-        int i2 = find_color(c2);
-        int i3 = find_color(c3);
-        int i4 = find_color(c4);
-
-        if (i1 < 0 || i2 < 0 || i3 < 0 || i4 < 0) { printf("Invalid colour.\n"); return; }
-
-        float value = (colors[i1].digit * 10 + colors[i2].digit) * colors[i3].multiplier;
-        printf("Resistance = ");
-        print_with_prefix(value, "Ω");
-        if (colors[i4].tolerance > 0)
-            printf("Tolerance = ±%.2f%%\n", colors[i4].tolerance);
-    } 
-    else if (type == 5) {
-        printf("Enter colours (Band1 Band2 Band3 Multiplier Tolerance): ");
-        scanf("%s %s %s %s %s", c1, c2, c3, c4, c5);
-        int i1 = find_color(c1);
-        int i2 = find_color(c2);
-        int i3 = find_color(c3);
-        int i4 = find_color(c4);
-        int i5 = find_color(c5);
-
-        if (i1 < 0 || i2 < 0 || i3 < 0 || i4 < 0 || i5 < 0) { printf("Invalid colour.\n"); return; }
-
-        float value = (colors[i1].digit * 100 + colors[i2].digit * 10 + colors[i3].digit)
-                       * colors[i4].multiplier;
-        printf("Resistance = ");
-        print_with_prefix(value, "Ω");
-        if (colors[i5].tolerance > 0)
-            printf("Tolerance = ±%.2f%%\n", colors[i5].tolerance);
-    } 
-    else printf("Invalid type.\n");
-}
-
-static void encode_color(void) {
-    char buf[32];
-    printf("Enter resistance (e.g. 4.7k, 10M): ");
-    scanf("%31s", buf);
-
-    float R = parse_with_prefix(buf);
-    if (R <= 0.0f) { printf("Invalid resistance.\n"); return; }
-
-    int exp = 0;
-    while (R >= 100 && exp < 9) { R /= 10; exp++; }
-    while (R < 10 && exp > -2)  { R *= 10; exp--; }
-
-    int d1 = (int)R / 10;
-    int d2 = ((int)R) % 10;
-
-    const char *mult_color = NULL;
-    for (int i = 0; colors[i].name; i++)
-        if (fabs(colors[i].multiplier - pow(10, exp)) < 0.001f)
-            mult_color = colors[i].name;
-
-    const char *tol_color = "gold";
-    const char *digit_colors[] = {
-        "black","brown","red","orange","yellow","green","blue","violet","grey","white"
-    };
-
-    if (!mult_color) { printf("Value out of range.\n"); return; }
-
-    printf("Colour Bands: %s - %s - %s - %s\n",
-           digit_colors[d1], digit_colors[d2], mult_color, tol_color);
-}
-
-/* ────────────────────────────────────────────────
-   SMD CODE SECTION
-   ──────────────────────────────────────────────── */
-
-static void smd_decode(void) {
-    char code[8];
-    printf("Enter SMD resistor code (e.g. 472, 1001, 49C): ");
-    scanf("%7s", code);
-    for (int i = 0; code[i]; i++) code[i] = toupper(code[i]);
-    int len = strlen(code);
-
-    // EIA-96 (2 digits + letter)
-    if (isalpha(code[len - 1]) && len == 3) {
-        int num; char letter;
-        sscanf(code, "%2d%c", &num, &letter);
-        static const int eia96_values[97] = {
-            0,100,102,105,107,110,113,115,118,121,124,127,130,133,137,140,143,147,
-            150,154,158,162,165,169,174,178,182,187,191,196,200,205,210,215,221,
-            226,232,237,243,249,255,261,267,274,280,287,294,301,309,316,324,332,
-            340,348,357,365,374,383,392,402,412,422,432,442,453,464,475,487,499,
-            511,523,536,549,562,576,590,604,619,634,649,665,681,698,715,732,750,
-            768,787,806,825,845,866,887,909,931,953,976
-        };
-        static const float eia96_mult[12] = {
-            1e-3,1e-2,1e-1,1,10,100,1e3,1e4,1e5,1e6,1e7,1e8
-        };
-        const char mult_char[] = "YZRABCDEFHJK";
-        float base = (num >= 1 && num <= 96) ? eia96_values[num] : 0;
-        float mult = 0;
-        for (int i = 0; i < 12; i++) if (letter == mult_char[i]) mult = eia96_mult[i];
-        if (base == 0 || mult == 0) { printf("Invalid EIA-96 code.\n"); return; }
-        float value = base * mult;
-        printf("EIA-96 Resistor = "); print_with_prefix(value, "Ω"); return;
-    }
-
-    // 3 or 4 digit code
-    if (len == 3 || len == 4) {
-        int digits = atoi(code);
-        int multiplier = digits % 10;
-        int base = digits / 10;
-        float value = base * pow(10, multiplier);
-        printf("SMD %d-digit Resistor = ", len);
-        print_with_prefix(value, "Ω");
-        return;
-    }
-
-    printf("Unknown or unsupported SMD code format.\n");
-}
-
-static void smd_encode(void) {
-    char buf[32];
-    printf("Enter resistance (e.g. 4.7k, 1M): ");
-    scanf("%31s", buf);
-    float value = parse_with_prefix(buf);
-    if (value <= 0) { printf("Invalid value.\n"); return; }
-
-    float temp = value;
-    int multiplier = 0;
-    while (temp >= 100) { temp /= 10; multiplier++; }
-    while (temp < 10 && multiplier > 0) { temp *= 10; multiplier--; }
-
-    int base = (int)(temp + 0.5f);
-    int code = base * 10 + multiplier;
-    printf("Approx. 3-digit SMD Code: %03d\n", code);
-}
-
-/* ────────────────────────────────────────────────
-   MAIN RESISTOR MENU
-   ──────────────────────────────────────────────── */
-
-void resistor_menu(void) {
-    int choice;
-    do {
-        printf("\n==== RESISTOR CALCULATOR ====\n");
-        printf("1. Series Combination\n");
-        printf("2. Parallel Combination\n");
-        printf("3. Resistance from Resistivity (ρL/A)\n");
-        printf("4. Colour Code → Resistance\n");
-        printf("5. Resistance → Colour Code\n");
-        printf("6. SMD Code → Resistance\n");
-        printf("7. Resistance → SMD Code\n");
-        printf("0. Return to Main Menu\n");
-        printf("Enter your choice: ");
-        scanf("%d", &choice);
-        getchar();
-
-        switch (choice) {
-            case 1: series_calc(); break;
-            case 2: parallel_calc(); break;
-            case 3: resistivity_calc(); break;
-            case 4: decode_color(); break;
-            case 5: encode_color(); break;
-            case 6: smd_decode(); break;
-            case 7: smd_encode(); break;
-            case 0: break;
-            default: printf("Invalid option.\n");
-        }
-    } while (choice != 0);
-}
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "math_ops.h"
+#include "eseries.h"
+#include "network.h"
+#include "resistor_calc.h"
+#include "monte_carlo.h"
+
+/* ────────────────────────────────────────────────
+   MATERIAL RESISTIVITY TABLE (Ω·m)
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    const char *name;
+    float rho;
+} material_t;
+
+static const material_t materials[] = {
+    {"Copper",   1.68e-8},
+    {"Aluminum", 2.82e-8},
+    {"Gold",     2.44e-8},
+    {"Silver",   1.59e-8},
+    {"Nichrome", 1.10e-6},
+    {"Iron",     1.00e-7},
+    {"Tungsten", 5.60e-8},
+    {NULL, 0.0f}
+};
+
+/* Utility */
+static float input_value(const char *prompt) {
+    char buf[32];
+    printf("%s", prompt);
+    scanf("%31s", buf);
+    return parse_with_prefix(buf);
+}
+
+/* ────────────────────────────────────────────────
+   BASIC CALCULATIONS (Series / Parallel / Resistivity)
+   ──────────────────────────────────────────────── */
+
+static void series_calc(void) {
+    int n;
+    printf("Enter number of resistors in series: ");
+    scanf("%d", &n);
+
+    if (n <= 0) { printf("Invalid number.\n"); return; }
+
+    double *values = read_values("R", n);
+    if (!values) return;
+    double total = series_total(values, n);
+    free(values);
+
+    printf("Equivalent Series Resistance = ");
+    print_with_prefix(total, "Ω");
+}
+
+static void parallel_calc(void) {
+    int n;
+    printf("Enter number of resistors in parallel: ");
+    scanf("%d", &n);
+
+    if (n <= 0) { printf("Invalid number.\n"); return; }
+
+    double *values = read_values("R", n);
+    if (!values) return;
+    for (int i = 0; i < n; i++) {
+        if (values[i] == 0.0) { printf("Error: R cannot be 0.\n"); free(values); return; }
+    }
+    double total = parallel_total(values, n);
+    free(values);
+
+    printf("Equivalent Parallel Resistance = ");
+    print_with_prefix(total, "Ω");
+}
+
+static void resistivity_calc(void) {
+    int choice;
+    printf("\nChoose material:\n");
+    for (int i = 0; materials[i].name; i++) {
+        printf("%d. %s\n", i + 1, materials[i].name);
+    }
+    printf("Select option: ");
+    scanf("%d", &choice);
+
+    if (choice <= 0 || materials[choice - 1].name == NULL) {
+        printf("Invalid choice.\n");
+        return;
+    }
+
+    float rho = materials[choice - 1].rho;
+    float L = input_value("Enter length L (m, supports prefixes): ");
+    float A = input_value("Enter cross-sectional area A (m^2): ");
+    if (A == 0.0f) { printf("Error: Area cannot be 0.\n"); return; }
+
+    float R = rho * (L / A);
+    printf("Resistance (R = ρL/A) for %s = ", materials[choice - 1].name);
+    print_with_prefix(R, "Ω");
+}
+
+/* ────────────────────────────────────────────────
+   COLOUR CODE SECTION
+   Colour index = digit for black..white, then gold
+   and silver; "gray" is accepted as an alias.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    const char *name;
+    int digit;          /* -1: not a digit band */
+    int exponent;       /* multiplier band = 10^exponent */
+    float tolerance;    /* percent, -1 if none */
+    int tempco;         /* ppm/K, -1 if none */
+} color_t;
+
+#define N_COLORS 12     /* gold = 10, silver = 11 */
+
+static const color_t colors[] = {
+    {"black",  0,  0, -1,    250},
+    {"brown",  1,  1, 1,     100},
+    {"red",    2,  2, 2,     50},
+    {"orange", 3,  3, -1,    15},
+    {"yellow", 4,  4, -1,    25},
+    {"green",  5,  5, 0.5f,  20},
+    {"blue",   6,  6, 0.25f, 10},
+    {"violet", 7,  7, 0.1f,  5},
+    {"grey",   8,  8, 0.05f, 1},
+    {"white",  9,  9, -1,    -1},
+    {"gold",  -1, -1, 5,     -1},
+    {"silver",-1, -2, 10,    -1},
+    {"gray",   8,  8, 0.05f, 1},
+};
+
+/* Perfect hash of the names above: (c0 + 3*c2 + len) & 31, lower case */
+static const signed char color_slot[32] = {
+    -1, 2,-1, 4,-1, 6,-1,-1,-1, 7, 0,-1,-1,-1,12,10,
+    -1,-1,-1,-1, 1,-1,-1, 9, 3,-1, 8, 5,-1,11,-1,-1
+};
+
+/* 10^-3 .. 10^13, exact from 10^0 up */
+static const double pow10_tab[] = {
+    1e-3, 1e-2, 1e-1, 1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13
+};
+#define P10(e) pow10_tab[(e) + 3]
+#define P10_MIN (-3)
+#define P10_MAX 13
+
+/* v · 10^e, dividing for negative e so that e.g. 47 · 10^-1 is exactly 4.7 */
+static double scale10(double v, int e) {
+    return e >= 0 ? v * P10(e) : v / P10(-e);
+}
+
+int color_index(const char *name, size_t len) {
+    if (len < 3 || len > 6) return -1;
+    int i = color_slot[((name[0] | 32) + 3 * (name[2] | 32) + (int)len) & 31];
+    if (i < 0) return -1;
+    const char *ref = colors[i].name;
+    for (size_t k = 0; k < len; k++)
+        if ((name[k] | 32) != ref[k]) return -1;
+    return ref[len] == '\0' ? i : -1;
+}
+
+const char *color_name(int index) {
+    return index >= 0 && index < N_COLORS ? colors[index].name : NULL;
+}
+
+static int find_color(const char *name) {
+    return color_index(name, strlen(name));
+}
+
+int color_tempco(const char *band) {
+    int i = find_color(band);
+    return i < 0 ? -1 : colors[i].tempco;
+}
+
+int color_decode(const char *const *bands, int n_bands, double *ohms, double *tolerance) {
+    unsigned char idx[6];
+    if (n_bands < 4 || n_bands > 6) return 0;
+    for (int b = 0; b < n_bands; b++) {
+        int i = find_color(bands[b]);
+        if (i < 0) return 0;
+        idx[b] = (unsigned char)i;
+    }
+    if (n_bands == 6 && colors[idx[5]].tempco < 0) return 0;
+
+    if (color_decode_array(idx, 1, n_bands, ohms) != 1) return 0;
+    *tolerance = colors[idx[n_bands == 4 ? 3 : 4]].tolerance;
+    return 1;
+}
+
+size_t color_decode_array(const unsigned char *bands, size_t n, int n_bands, double *ohms) {
+    int digits = n_bands == 4 ? 2 : 3;
+    size_t ok = 0;
+    if (n_bands < 4 || n_bands > 6) return 0;
+
+    for (size_t r = 0; r < n; r++, bands += n_bands) {
+        int base = 0, valid = 1;
+        for (int b = 0; b < digits; b++) {
+            int d = bands[b] < N_COLORS + 1 ? colors[bands[b]].digit : -1;
+            valid &= d >= 0;
+            base = base * 10 + d;
+        }
+        int m = bands[digits];
+        valid &= m < N_COLORS + 1;
+        double v = valid ? scale10(base, colors[m].exponent) : NAN;
+        ohms[r] = v;
+        ok += valid;
+    }
+    return ok;
+}
+
+/* ohms ≈ m · 10^exp with m of exactly 'digits' digits (or fewer when exp
+   would fall below min_exp). Returns 0 when the value can't be shown. */
+static int split_digits(double ohms, int digits, int min_exp, int max_exp, int *m, int *exp) {
+    if (!(ohms >= 1e-3 && ohms < 1e12)) return 0;
+
+    int b;
+    frexp(ohms, &b);
+    int e = ((b - 1) * 1233) >> 12;                 /* floor(log10) or one less */
+    e += ohms >= P10(e + 1);
+
+    int ex = e - (digits - 1);
+    if (ex < min_exp) ex = min_exp;
+    double scaled = scale10(ohms, -ex);
+    long mant = (long)(scaled + 0.5);
+    if (mant >= (long)P10(digits)) { mant /= 10; ex++; }
+    if (mant == 0 || ex > max_exp) return 0;
+    *m = (int)mant;
+    *exp = ex;
+    return 1;
+}
+
+/* One value to colour indices; 0 if out of range */
+static int encode_bands(double ohms, int n_bands, unsigned char *out) {
+    int digits = n_bands == 4 ? 2 : 3, m, ex;
+    if (!split_digits(ohms, digits, -2, 9, &m, &ex)) return 0;
+
+    if (digits == 3) { out[0] = m / 100; out[1] = m / 10 % 10; out[2] = m % 10; }
+    else             { out[0] = m / 10; out[1] = m % 10; }
+    out[digits] = ex >= 0 ? ex : 9 - ex;            /* -1 gold, -2 silver */
+    out[digits + 1] = n_bands == 4 ? 10 : 1;        /* gold 5 % / brown 1 % */
+    if (n_bands == 6) out[5] = 1;                   /* brown 100 ppm/K */
+    return 1;
+}
+
+size_t color_encode_array(const double *ohms, size_t n, int n_bands, unsigned char *bands) {
+    size_t ok = 0;
+    if (n_bands < 4 || n_bands > 6) return 0;
+    for (size_t r = 0; r < n; r++, bands += n_bands) {
+        int good = encode_bands(ohms[r], n_bands, bands);
+        if (!good) memset(bands, 0xFF, n_bands);
+        ok += good;
+    }
+    return ok;
+}
+
+int color_encode_bands(double ohms, int n_bands, const char **bands) {
+    unsigned char idx[6];
+    if (n_bands < 4 || n_bands > 6 || !encode_bands(ohms, n_bands, idx)) return 0;
+    for (int b = 0; b < n_bands; b++) bands[b] = colors[idx[b]].name;
+    return 1;
+}
+
+int color_encode(double ohms, const char *bands[4]) {
+    return color_encode_bands(ohms, 4, bands);
+}
+
+static int read_band_count(void) {
+    int type;
+    printf("Enter type (4, 5 or 6 bands): ");
+    scanf("%d", &type);
+    if (type < 4 || type > 6) { printf("Invalid type.\n"); return 0; }
+    return type;
+}
+
+static void decode_color(void) {
+    char c[6][16];
+    const char *bands[6] = { c[0], c[1], c[2], c[3], c[4], c[5] };
+    double value, tol;
+    int type = read_band_count();
+    if (!type) return;
+
+    if (type == 4) {
+        printf("Enter colours (Band1 Band2 Multiplier Tolerance): ");
+        scanf("%15s %15s %15s %15s", c[0], c[1], c[2], c[3]);
+    }
+    else if (type == 5) {
+        printf("Enter colours (Band1 Band2 Band3 Multiplier Tolerance): ");
+        scanf("%15s %15s %15s %15s %15s", c[0], c[1], c[2], c[3], c[4]);
+    }
+    else {
+        printf("Enter colours (Band1 Band2 Band3 Multiplier Tolerance TempCo): ");
+        scanf("%15s %15s %15s %15s %15s %15s", c[0], c[1], c[2], c[3], c[4], c[5]);
+    }
+
+    if (!color_decode(bands, type, &value, &tol)) { printf("Invalid colour.\n"); return; }
+
+    printf("Resistance = ");
+    print_with_prefix(value, "Ω");
+    if (tol > 0)
+        printf("Tolerance = ±%.2f%%\n", tol);
+    if (type == 6)
+        printf("Temperature coefficient = %d ppm/K\n", color_tempco(c[5]));
+}
+
+static void encode_color(void) {
+    char buf[32];
+    const char *bands[6];
+    int type = read_band_count();
+    if (!type) return;
+    printf("Enter resistance (e.g. 4.7k, 10M): ");
+    scanf("%31s", buf);
+
+    double R = parse_prefix_n(buf, strlen(buf), NULL);
+    if (R <= 0.0) { printf("Invalid resistance.\n"); return; }
+
+    if (!color_encode_bands(R, type, bands)) { printf("Value out of range.\n"); return; }
+
+    printf("Colour Bands: %s", bands[0]);
+    for (int b = 1; b < type; b++) printf(" - %s", bands[b]);
+    printf("\n");
+}
+
+/* ────────────────────────────────────────────────
+   SMD CODE SECTION
+   ──────────────────────────────────────────────── */
+
+/* EIA-96 multiplier letters, 10^-3 .. 10^8 */
+static const char mult_char[] = "YZRABCDEFHJK";
+
+/* Index of the largest E96 mantissa <= 100 + i, built from eseries.c
+   on first use */
+static unsigned char e96_floor[900];
+static pthread_once_t e96_floor_once = PTHREAD_ONCE_INIT;
+
+static void init_e96_floor(void) {
+    int idx = 0;
+    for (int i = 0; i < 900; i++) {
+        while (idx < 95 && eseries_mantissa(96, idx + 1) <= 100 + i) idx++;
+        e96_floor[i] = (unsigned char)idx;
+    }
+}
+
+int smd_resistor_value(const char *code, size_t len, double *ohms) {
+    // EIA-96 (2 digits + letter)
+    if (len == 3 && isalpha((unsigned char)code[2])) {
+        if (!isdigit((unsigned char)code[0]) || !isdigit((unsigned char)code[1])) return SMD_INVALID;
+        int num = (code[0] - '0') * 10 + (code[1] - '0');
+        char letter = toupper((unsigned char)code[2]);
+        const char *m = strchr(mult_char, letter);
+        if (num < 1 || num > 96 || !m) return SMD_INVALID;
+        *ohms = scale10(eseries_mantissa(96, num - 1), m - mult_char - 3);
+        return SMD_EIA96;
+    }
+
+    // 3 or 4 digit code: significant digits followed by the power of ten,
+    // or digits with R marking the decimal point (4R7, R47, 49R9)
+    if (len == 3 || len == 4) {
+        int base = 0, point = -1;
+        for (size_t i = 0; i < len; i++) {
+            if ((code[i] | 32) == 'r' && point < 0) { point = (int)i; continue; }
+            if (!isdigit((unsigned char)code[i])) return SMD_INVALID;
+        }
+        if (point >= 0) {
+            for (size_t i = 0; i < len; i++)
+                if ((int)i != point) base = base * 10 + (code[i] - '0');
+            *ohms = scale10(base, point - (int)len + 1);
+            return SMD_DIGITS;
+        }
+        for (size_t i = 0; i + 1 < len; i++) base = base * 10 + (code[i] - '0');
+        *ohms = base * P10(code[len - 1] - '0');
+        return SMD_DIGITS;
+    }
+
+    return SMD_INVALID;
+}
+
+/* Digits of m, most significant first, with 'R' at the decimal point */
+static size_t put_r_notation(char *code, int m, int digits, int exp) {
+    size_t n = 0;
+    for (int d = digits - 1; d >= 0; d--) {
+        if (d == -exp - 1) code[n++] = 'R';
+        code[n++] = '0' + (int)(m / (long)P10(d)) % 10;
+    }
+    code[n] = '\0';
+    return n;
+}
+
+size_t smd_resistor_code(double ohms, int style, char code[8]) {
+    int m, ex;
+    code[0] = '\0';
+
+    if (style == SMD_STYLE_EIA96) {
+        pthread_once(&e96_floor_once, init_e96_floor);
+        if (!split_digits(ohms, 3, P10_MIN, P10_MAX, &m, &ex)) return 0;
+        /* split_digits rounded to 3 digits; redo the E96 choice on the exact value */
+        double scaled = scale10(ohms, -ex);
+        if (scaled * scaled < 97.6 * 100) return 0;    /* nearer 97.6 mΩ than 01Y */
+        int f = (int)scaled - 100;
+        int lo = e96_floor[f < 0 ? 0 : f > 899 ? 899 : f];
+        int lo_m = eseries_mantissa(96, lo);
+        int hi_m = lo < 95 ? eseries_mantissa(96, lo + 1) : 1000;
+        int idx = scaled * scaled >= (double)lo_m * hi_m ? lo + 1 : lo;
+        if (idx == 96) { idx = 0; ex++; }
+        if (ex < -3 || ex > 8) return 0;
+        code[0] = '0' + (idx + 1) / 10;
+        code[1] = '0' + (idx + 1) % 10;
+        code[2] = mult_char[ex + 3];
+        code[3] = '\0';
+        return 3;
+    }
+
+    int digits = style == SMD_STYLE_4DIGIT ? 3 : 2;
+    if (!split_digits(ohms, digits, -digits, 9, &m, &ex)) return 0;
+    if (ex < 0) return put_r_notation(code, m, digits, ex);
+
+    size_t n = put_r_notation(code, m, digits, 0);
+    code[n++] = '0' + ex;
+    code[n] = '\0';
+    return n;
+}
+
+size_t smd_encode_array(const double *ohms, size_t n, int style, char (*codes)[8]) {
+    size_t ok = 0;
+    for (size_t i = 0; i < n; i++) ok += smd_resistor_code(ohms[i], style, codes[i]) > 0;
+    return ok;
+}
+
+static void smd_decode(void) {
+    char code[8];
+    printf("Enter SMD resistor code (e.g. 472, 1001, 4R7, 49C): ");
+    scanf("%7s", code);
+    size_t len = strlen(code);
+    double value;
+
+    switch (smd_resistor_value(code, len, &value)) {
+        case SMD_EIA96:
+            printf("EIA-96 Resistor = "); print_with_prefix(value, "Ω");
+            break;
+        case SMD_DIGITS:
+            printf("SMD %d-digit Resistor = ", (int)len);
+            print_with_prefix(value, "Ω");
+            break;
+        default:
+            if (len == 3 && isalpha((unsigned char)code[2])) printf("Invalid EIA-96 code.\n");
+            else printf("Unknown or unsupported SMD code format.\n");
+    }
+}
+
+static void smd_encode(void) {
+    char buf[32], code[8];
+    printf("Enter resistance (e.g. 4.7k, 1M): ");
+    scanf("%31s", buf);
+    double value = parse_prefix_n(buf, strlen(buf), NULL);
+    if (value <= 0) { printf("Invalid value.\n"); return; }
+
+    if (smd_resistor_code(value, SMD_STYLE_3DIGIT, code)) printf("3-digit SMD Code: %s\n", code);
+    else printf("3-digit SMD Code: out of range\n");
+    if (smd_resistor_code(value, SMD_STYLE_4DIGIT, code)) printf("4-digit SMD Code: %s\n", code);
+    else printf("4-digit SMD Code: out of range\n");
+    if (smd_resistor_code(value, SMD_STYLE_EIA96, code)) {
+        char value_str[PREFIX_FMT_MAX + 8];
+        double actual = 0;
+        smd_resistor_value(code, 3, &actual);
+        format_with_prefix(value_str, sizeof(value_str), actual, "Ω");
+        printf("EIA-96 Code:      %s (%s)\n", code, value_str);
+    }
+}
+
+static void network_calc(void) {
+    char path[256], n1[32], n2[32];
+    printf("Enter netlist file (lines of \"<node> <node> <value>\"): ");
+    scanf("%255s", path);
+    res_network_t *net = network_load(path);
+    if (!net) return;
+
+    int n;
+    printf("Netlist loaded: %d nodes.\n", network_nodes(net));
+    printf("How many node pairs to measure? ");
+    scanf("%d", &n);
+    if (n <= 0) { printf("Invalid count.\n"); network_free(net); return; }
+
+    int *from = malloc(n * sizeof(int)), *to = malloc(n * sizeof(int));
+    double *ohms = malloc(n * sizeof(double));
+    int ok = from && to && ohms;
+    for (int i = 0; ok && i < n; i++) {
+        printf("Pair %d (e.g. in gnd): ", i + 1);
+        scanf("%31s %31s", n1, n2);
+        from[i] = network_node(net, n1);
+        to[i] = network_node(net, n2);
+        if (from[i] < 0 || to[i] < 0) {
+            printf("Unknown node %s.\n", from[i] < 0 ? n1 : n2);
+            ok = 0;
+        }
+    }
+
+    if (ok && network_resistance(net, n, from, to, ohms) == 0) {
+        for (int i = 0; i < n; i++) {
+            printf("R(pair %d) = ", i + 1);
+            if (isinf(ohms[i])) printf("open circuit (nodes not connected)\n");
+            else print_with_prefix(ohms[i], "Ω");
+        }
+    }
+    free(from); free(to); free(ohms);
+    network_free(net);
+}
+
+static void eseries_calc(void) {
+    char buf[32];
+    int series, max_parts, k;
+    printf("Enter target resistance (e.g. 5.3k): ");
+    scanf("%31s", buf);
+    double target = parse_prefix_n(buf, strlen(buf), NULL);
+    printf("Series (12, 24, 96 or 192): ");
+    scanf("%d", &series);
+    printf("Maximum resistors (1-3): ");
+    scanf("%d", &max_parts);
+    printf("How many results? ");
+    scanf("%d", &k);
+    if (k > 50) k = 50;
+
+    eseries_combo_t best[50];
+    int n = eseries_best(series, target, max_parts, k, best);
+    if (n < 0) { printf("Invalid input.\n"); return; }
+
+    char desc[3 * (PREFIX_FMT_MAX + 8) + 16], value[PREFIX_FMT_MAX + 8];
+    for (int i = 0; i < n; i++) {
+        eseries_format(&best[i], desc, sizeof(desc));
+        format_with_prefix(value, sizeof(value), best[i].value, "Ω");
+        printf("%2d. %-40s = %-16s (%+.3g%%)\n", i + 1, desc, value, best[i].error * 100);
+    }
+}
+
+/* ────────────────────────────────────────────────
+   MAIN RESISTOR MENU
+   ──────────────────────────────────────────────── */
+
+void resistor_menu(void) {
+    int choice;
+    do {
+        printf("\n==== RESISTOR CALCULATOR ====\n");
+        printf("1. Series Combination\n");
+        printf("2. Parallel Combination\n");
+        printf("3. Resistance from Resistivity (ρL/A)\n");
+        printf("4. Colour Code → Resistance\n");
+        printf("5. Resistance → Colour Code\n");
+        printf("6. SMD Code → Resistance\n");
+        printf("7. Resistance → SMD Code\n");
+        printf("8. Network Resistance (netlist file)\n");
+        printf("9. Best E-Series Combination for a Value\n");
+        printf("10. Monte Carlo Tolerance Analysis\n");
+        printf("0. Return to Main Menu\n");
+        printf("Enter your choice: ");
+        scanf("%d", &choice);
+        getchar();
+
+        switch (choice) {
+            case 1: series_calc(); break;
+            case 2: parallel_calc(); break;
+            case 3: resistivity_calc(); break;
+            case 4: decode_color(); break;
+            case 5: encode_color(); break;
+            case 6: smd_decode(); break;
+            case 7: smd_encode(); break;
+            case 8: network_calc(); break;
+            case 9: eseries_calc(); break;
+            case 10: monte_carlo_dialog(); break;
+            case 0: break;
+            default: printf("Invalid option.\n");
+        }
+    } while (choice != 0);
+}
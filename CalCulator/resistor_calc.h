@@ -1,6 +1,50 @@
-#ifndef RESISTOR_CALC_H
-#define RESISTOR_CALC_H
-
-void resistor_menu(void);
-
-#endif
+#ifndef RESISTOR_CALC_H
+#define RESISTOR_CALC_H
+
+#include <stddef.h>
+
+void resistor_menu(void);
+
+/* Return codes of smd_resistor_value() */
+#define SMD_INVALID 0
+#define SMD_DIGITS  1   /* 3- or 4-digit code, e.g. 472, 1001 */
+#define SMD_EIA96   2   /* EIA-96 code, e.g. 49C */
+
+/* Colour bands (names such as "red", any case): 4, 5 or 6 bands; digits,
+   then multiplier and tolerance, then for 6 bands the temperature
+   coefficient. tolerance is in percent, -1 if the band carries none.
+   Returns 0 on an unknown or misplaced colour. */
+int color_decode(const char *const *bands, int n_bands, double *ohms, double *tolerance);
+int color_tempco(const char *band);             /* ppm/K, -1 if none */
+
+/* Nearest 4-band code (two digits, multiplier, gold); 0 if out of range */
+int color_encode(double ohms, const char *bands[4]);
+
+/* Nearest 4-, 5- or 6-band code: 4 bands end in gold (5 %), 5 and 6 in
+   brown (1 %), 6 with a brown 100 ppm/K band. 0 if out of range. */
+int color_encode_bands(double ohms, int n_bands, const char **bands);
+
+/* Colour indices: digit for black..white, 10 gold, 11 silver */
+int color_index(const char *name, size_t len);  /* -1 if unknown */
+const char *color_name(int index);
+
+/* Bulk forms over colour indices, n_bands per value. A value that cannot
+   be encoded gets 0xFF bands; an invalid code decodes to NaN. Both return
+   the number of values converted. */
+size_t color_encode_array(const double *ohms, size_t n, int n_bands, unsigned char *bands);
+size_t color_decode_array(const unsigned char *bands, size_t n, int n_bands, double *ohms);
+
+/* Decode an SMD resistor marking (need not be NUL-terminated) to ohms */
+int smd_resistor_value(const char *code, size_t len, double *ohms);
+
+/* Styles for smd_resistor_code() */
+#define SMD_STYLE_3DIGIT  3     /* 472, 4R7 */
+#define SMD_STYLE_4DIGIT  4     /* 4701, 49R9 */
+#define SMD_STYLE_EIA96   96    /* nearest E96 value, e.g. 01C */
+
+/* Marking for a value (NUL-terminated in code); returns its length,
+   0 if the value cannot be marked in that style */
+size_t smd_resistor_code(double ohms, int style, char code[8]);
+size_t smd_encode_array(const double *ohms, size_t n, int style, char (*codes)[8]);
+
+#endif
@@ -0,0 +1,316 @@
+#define _GNU_SOURCE             /* accept4() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "serve.h"
+#include "batch_mode.h"
+#include "expression_eval.h"
+#include "parallel.h"
+
+#define SERVE_READ      (64u << 10) /* input taken from one client per turn */
+#define SERVE_MAX_LINE  4096        /* longest request line */
+#define SERVE_EVENTS    16          /* events one worker takes per wait */
+#define SERVE_ACCEPTS   64          /* connections accepted per turn */
+#define SERVE_MAX_THREADS 256
+
+/* ────────────────────────────────────────────────
+   CONNECTIONS
+   Every fd is registered EPOLLONESHOT, so exactly
+   one worker owns a connection between its wakeup
+   and the re-arm at the end of its turn. That is
+   what keeps pipelined replies in request order
+   without any per-connection lock.
+   ──────────────────────────────────────────────── */
+
+typedef struct conn {
+    struct conn *prev, *next;   /* all open connections */
+    int fd;
+    int eof;                    /* client has finished sending */
+    int discarding;             /* dropping the rest of an over-long line */
+    char *in;                   /* bytes not yet answered: a partial line */
+    size_t in_len, in_cap;
+    char *out;                  /* replies the socket has not taken yet */
+    size_t out_off, out_len, out_cap;
+} conn_t;
+
+typedef struct {
+    int epfd, listen_fd;
+    pthread_mutex_t lock;       /* guards the connection list */
+    conn_t *conns;
+    atomic_ullong n_conns, n_requests;
+} server_t;
+
+static int stop_fd = -1;
+static char listen_tag, stop_tag;   /* epoll data of the two non-client fds */
+
+void serve_stop(void) {
+    uint64_t one = 1;
+    /* Never read back, so the eventfd stays readable and wakes every worker */
+    if (stop_fd >= 0 && write(stop_fd, &one, sizeof one) < 0) { /* nothing to do */ }
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    serve_stop();
+}
+
+static int reserve(char **buf, size_t *cap, size_t need) {
+    if (need <= *cap) return 1;
+    size_t n = *cap ? *cap : 4096;
+    while (n < need) n *= 2;
+    char *b = realloc(*buf, n);
+    if (!b) return 0;
+    *buf = b;
+    *cap = n;
+    return 1;
+}
+
+static void conn_close(server_t *s, conn_t *c) {
+    pthread_mutex_lock(&s->lock);
+    if (c->prev) c->prev->next = c->next; else s->conns = c->next;
+    if (c->next) c->next->prev = c->prev;
+    pthread_mutex_unlock(&s->lock);
+    close(c->fd);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+static const char too_long[] = "error: request line too long";
+
+/* Answer every complete line; at EOF an unterminated last line too */
+static int answer(server_t *s, conn_t *c) {
+    size_t pos = 0;
+    unsigned long long n = 0;
+
+    /* The rest of an over-long line: drop it up to its newline, then
+       answer the whole line with one error and carry on after it */
+    if (c->discarding) {
+        char *nl = memchr(c->in, '\n', c->in_len);
+        if (!nl && !c->eof) {
+            c->in_len = 0;
+            return 0;
+        }
+        if (!reserve(&c->out, &c->out_cap, c->out_len + sizeof too_long + 1)) return 1;
+        memcpy(c->out + c->out_len, too_long, sizeof too_long - 1);
+        c->out_len += sizeof too_long - 1;
+        c->out[c->out_len++] = '\n';
+        pos = nl ? (size_t)(nl - c->in) + 1 : c->in_len;
+        c->discarding = 0;
+        n++;
+    }
+
+    for (;;) {
+        char *nl = memchr(c->in + pos, '\n', c->in_len - pos);
+        size_t len = nl ? (size_t)(nl - (c->in + pos)) : c->in_len - pos;
+        if (!nl && (!c->eof || len == 0)) break;
+        if (!reserve(&c->out, &c->out_cap, c->out_len + BATCH_LINE_OUT + 1)) return 1;
+        if (len > SERVE_MAX_LINE) {
+            c->out_len += (size_t)snprintf(c->out + c->out_len, BATCH_LINE_OUT, "%s", too_long);
+        } else {
+            c->out_len += batch_eval_line(c->in + pos, len, c->out + c->out_len, BATCH_LINE_OUT);
+        }
+        c->out[c->out_len++] = '\n';
+        pos += len + (nl != NULL);
+        n++;
+    }
+    memmove(c->in, c->in + pos, c->in_len - pos);
+    c->in_len -= pos;
+    atomic_fetch_add_explicit(&s->n_requests, n, memory_order_relaxed);
+
+    /* A partial line this long can only become an over-long request:
+       stop buffering it and answer it when its newline arrives */
+    if (c->in_len > SERVE_MAX_LINE) {
+        c->in_len = 0;
+        c->discarding = 1;
+    }
+    return 0;
+}
+
+/* One turn for a connection this worker owns; returns 1 to close it */
+static int conn_turn(server_t *s, conn_t *c, uint32_t events) {
+    if (events & EPOLLERR) return 1;
+
+    /* Read only once earlier replies are out: a client that does not
+       read its answers stops being read itself */
+    if (!c->eof && c->out_off == c->out_len) {
+        c->out_off = c->out_len = 0;
+        for (size_t got = 0; got < SERVE_READ; ) {
+            if (!reserve(&c->in, &c->in_cap, c->in_len + 16384)) return 1;
+            ssize_t n = read(c->fd, c->in + c->in_len, c->in_cap - c->in_len);
+            if (n > 0) { c->in_len += (size_t)n; got += (size_t)n; continue; }
+            if (n == 0) { c->eof = 1; break; }
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return 1;
+        }
+        if (answer(s, c)) return 1;
+    }
+
+    while (c->out_off < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+        if (n > 0) { c->out_off += (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return 1;
+    }
+    int pending = c->out_off < c->out_len;
+    if (c->eof && !pending) return 1;
+
+    struct epoll_event ev = { .events = (pending ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT, .data.ptr = c };
+    return epoll_ctl(s->epfd, EPOLL_CTL_MOD, c->fd, &ev) != 0;
+}
+
+static void accept_clients(server_t *s) {
+    for (int k = 0; k < SERVE_ACCEPTS; k++) {
+        int fd = accept4(s->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno == EMFILE || errno == ENFILE) {
+                /* Out of descriptors: back off instead of spinning on the backlog */
+                struct timespec pause = { 0, 10 * 1000000 };
+                nanosleep(&pause, NULL);
+            }
+            break;
+        }
+        conn_t *c = calloc(1, sizeof *c);
+        if (!c) { close(fd); continue; }
+        c->fd = fd;
+        pthread_mutex_lock(&s->lock);
+        c->next = s->conns;
+        if (s->conns) s->conns->prev = c;
+        s->conns = c;
+        pthread_mutex_unlock(&s->lock);
+
+        struct epoll_event ev = { .events = EPOLLIN | EPOLLONESHOT, .data.ptr = c };
+        if (epoll_ctl(s->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) { conn_close(s, c); continue; }
+        atomic_fetch_add_explicit(&s->n_conns, 1, memory_order_relaxed);
+    }
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLONESHOT, .data.ptr = &listen_tag };
+    epoll_ctl(s->epfd, EPOLL_CTL_MOD, s->listen_fd, &ev);
+}
+
+static void *serve_worker(void *arg) {
+    server_t *s = arg;
+    struct epoll_event ev[SERVE_EVENTS];
+    expr_set_quiet(1);
+    for (;;) {
+        int n = epoll_wait(s->epfd, ev, SERVE_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return NULL;
+        }
+        for (int i = 0; i < n; i++) {
+            void *tag = ev[i].data.ptr;
+            if (tag == &stop_tag) return NULL;
+            if (tag == &listen_tag) accept_clients(s);
+            else if (conn_turn(s, tag, ev[i].events)) conn_close(s, tag);
+        }
+    }
+}
+
+/* ────────────────────────────────────────────────
+   SETUP AND SHUTDOWN
+   ──────────────────────────────────────────────── */
+
+/* Thousands of clients need thousands of descriptors */
+static void raise_fd_limit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+static int open_socket(const char *path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof addr.sun_path) { printf("Error: socket path too long\n"); return -1; }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) { printf("Error: cannot create socket\n"); return -1; }
+
+    /* A socket file nobody answers on is left over from an earlier run */
+    struct stat st;
+    if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int live = probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof addr) == 0;
+        if (probe >= 0) close(probe);
+        if (live) { printf("Error: a server is already running on %s\n", path); close(fd); return -1; }
+        unlink(path);
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof addr) != 0 || listen(fd, SOMAXCONN) != 0) {
+        printf("Error: cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int serve_run(const char *socket_path) {
+    server_t s = { .epfd = -1, .listen_fd = -1, .conns = NULL };
+    struct sigaction sa = { .sa_handler = on_signal }, old_int, old_term;
+    int rc = 1;
+
+    raise_fd_limit();
+    pthread_mutex_init(&s.lock, NULL);
+    s.listen_fd = open_socket(socket_path);
+    if (s.listen_fd < 0) goto done;
+    s.epfd = epoll_create1(EPOLL_CLOEXEC);
+    stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event lev = { .events = EPOLLIN | EPOLLONESHOT, .data.ptr = &listen_tag };
+    struct epoll_event sev = { .events = EPOLLIN, .data.ptr = &stop_tag };
+    if (s.epfd < 0 || stop_fd < 0 ||
+        epoll_ctl(s.epfd, EPOLL_CTL_ADD, s.listen_fd, &lev) != 0 ||
+        epoll_ctl(s.epfd, EPOLL_CTL_ADD, stop_fd, &sev) != 0) {
+        printf("Error: cannot set up epoll\n");
+        goto done;
+    }
+
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, &old_int);
+    sigaction(SIGTERM, &sa, &old_term);
+
+    int workers = par_threads();
+    if (workers > SERVE_MAX_THREADS) workers = SERVE_MAX_THREADS;
+    printf("Serving on %s with %d worker threads (Ctrl+C to stop)\n", socket_path, workers);
+    fflush(stdout);
+
+    pthread_t tid[SERVE_MAX_THREADS];
+    int started = 0;
+    for (int i = 1; i < workers; i++) {
+        if (pthread_create(&tid[started], NULL, serve_worker, &s) != 0) break;
+        started++;
+    }
+    serve_worker(&s);
+    for (int i = 0; i < started; i++) pthread_join(tid[i], NULL);
+
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    while (s.conns) conn_close(&s, s.conns);
+    printf("Served %llu requests on %llu connections\n",
+           (unsigned long long)s.n_requests, (unsigned long long)s.n_conns);
+    unlink(socket_path);
+    rc = 0;
+
+done:
+    if (stop_fd >= 0) close(stop_fd);
+    stop_fd = -1;
+    if (s.epfd >= 0) close(s.epfd);
+    if (s.listen_fd >= 0) close(s.listen_fd);
+    pthread_mutex_destroy(&s.lock);
+    return rc;
+}
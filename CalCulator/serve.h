@@ -0,0 +1,21 @@
+#ifndef SERVE_H
+#define SERVE_H
+
+/* Calculation server: listens on a Unix domain socket and answers the
+   batch request language (see batch_mode.h), one result line per request
+   line, e.g.
+       $ printf 'ohm_v 10m 4.7k\nexpr 2k*(3+4m)\n' | nc -U /tmp/calc.sock
+       47
+       6008
+   Clients may pipeline any number of requests; the replies on a
+   connection always come back in request order. Connections are
+   multiplexed with epoll over par_threads() worker threads. */
+
+/* Runs until SIGINT / SIGTERM or serve_stop(). Returns 0 on a clean
+   shutdown, 1 (after printing why) if the socket could not be set up. */
+int serve_run(const char *socket_path);
+
+/* Ask a running server to shut down; safe from a signal handler */
+void serve_stop(void);
+
+#endif
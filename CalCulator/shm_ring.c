@@ -0,0 +1,473 @@
+#define _GNU_SOURCE             /* syscall() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "shm_ring.h"
+#include "batch_mode.h"
+#include "expression_eval.h"
+#include "expr_jit.h"
+
+#define SHM_MAGIC   0x4d485343u     /* "CSHM" */
+#define SHM_VERSION 1
+#define SHM_SPIN    4000            /* polls before sleeping on the futex */
+#define SHM_NAME    64
+
+_Static_assert(sizeof(shm_request_t) == 128, "request slot must stay 128 bytes");
+_Static_assert(sizeof(shm_reply_t) == 128, "reply slot must stay 128 bytes");
+_Static_assert((SHM_SLOTS & (SHM_SLOTS - 1)) == 0, "SHM_SLOTS must be a power of two");
+_Static_assert(ATOMIC_INT_LOCK_FREE == 2, "ring indices must be lock-free to be shared");
+
+/* ────────────────────────────────────────────────
+   SEGMENT LAYOUT
+   Each index sits on its own cache line so the
+   producer and consumer never write the same line.
+   head counts slots published, tail slots taken;
+   both only grow and wrap through 2^32.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    _Alignas(64) atomic_uint head;  /* written by the producer */
+    _Alignas(64) atomic_uint tail;  /* written by the consumer */
+    _Alignas(64) atomic_uint bell;  /* futex word, bumped when the consumer sleeps */
+    atomic_uint sleeping;
+} ring_ctl_t;
+
+typedef struct {
+    atomic_uint magic;              /* set last, once the rest is filled in */
+    uint32_t version, slot_size, n_slots;
+    atomic_int server_pid;          /* 0 once the server has stopped */
+    atomic_int client_pid;          /* 0 while no client is attached */
+    ring_ctl_t req, rep;
+    _Alignas(64) shm_request_t req_slot[SHM_SLOTS];
+    _Alignas(64) shm_reply_t rep_slot[SHM_SLOTS];
+} shm_segment_t;
+
+static void futex_wait(atomic_uint *word, unsigned seen, long timeout_ns) {
+    struct timespec ts = { timeout_ns / 1000000000L, timeout_ns % 1000000000L };
+    syscall(SYS_futex, word, FUTEX_WAIT, seen, timeout_ns ? &ts : NULL, NULL, 0);
+}
+
+static void futex_wake(atomic_uint *word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/* With one CPU the other side cannot run while we poll, so sleep at once */
+static atomic_int spin_limit = -1;
+
+static void init_spin(void) {
+    atomic_store_explicit(&spin_limit, sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_SPIN : 0,
+                          memory_order_relaxed);
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/* Producer: make slots up to 'head' visible, waking the consumer if it
+   went to sleep. The fence pairs with the one in ring_wait(): either the
+   consumer sees the new head or we see it sleeping. */
+static void ring_publish(ring_ctl_t *r, unsigned head) {
+    atomic_store_explicit(&r->head, head, memory_order_release);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&r->sleeping, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&r->bell, 1, memory_order_relaxed);
+        futex_wake(&r->bell);
+    }
+}
+
+/* Consumer: returns the head once it differs from 'tail'. Spins first,
+   then sleeps; gives up (returning 'tail') when *stop becomes set, or
+   when give_up() says so after a sleep of timeout_ns. */
+static unsigned ring_wait(ring_ctl_t *r, unsigned tail, const atomic_int *stop,
+                          long timeout_ns, int (*give_up)(void *), void *ctx) {
+    int limit = atomic_load_explicit(&spin_limit, memory_order_relaxed);
+    for (int spin = 0;; spin++) {
+        unsigned head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (head != tail) return head;
+        if (atomic_load_explicit(stop, memory_order_relaxed)) return tail;
+        if (spin < limit) { cpu_relax(); continue; }
+
+        unsigned bell = atomic_load_explicit(&r->bell, memory_order_relaxed);
+        atomic_store_explicit(&r->sleeping, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (head == tail && !atomic_load_explicit(stop, memory_order_relaxed))
+            futex_wait(&r->bell, bell, timeout_ns);
+        atomic_store_explicit(&r->sleeping, 0, memory_order_relaxed);
+        if (give_up && give_up(ctx)) return tail;
+        spin = 0;
+    }
+}
+
+static int shm_path(const char *name, char path[SHM_NAME]) {
+    int n = snprintf(path, SHM_NAME, "%s%s", name[0] == '/' ? "" : "/", name);
+    if (n >= SHM_NAME || strchr(path + 1, '/')) {
+        printf("Error: shared memory name must be a single word under %d characters\n", SHM_NAME - 1);
+        return 0;
+    }
+    return 1;
+}
+
+static int process_alive(int pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+/* ────────────────────────────────────────────────
+   SERVER
+   Requests are answered in runs: every slot between
+   tail and head is read, its reply written, the
+   replies published, and only then is the request
+   tail advanced. A client that sees the request
+   ring empty therefore also has every reply.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    expr_program_t *prog;
+    expr_jit_t *jit;
+} shm_expr_t;
+
+typedef struct {
+    shm_segment_t *seg;
+    int numeric[SHM_OP_RELEASE + 1];    /* batch request for each numeric op, or -1 */
+    shm_expr_t expr[SHM_MAX_EXPRS];
+    unsigned long long n_requests;
+} shm_server_t;
+
+static atomic_int stop_flag;
+static _Atomic(shm_segment_t *) live_seg;
+static atomic_int stoppers;         /* shm_stop() calls still using live_seg */
+
+void shm_stop(void) {
+    atomic_store(&stop_flag, 1);
+    atomic_fetch_add(&stoppers, 1);
+    shm_segment_t *seg = atomic_load(&live_seg);
+    if (seg) {
+        atomic_fetch_add(&seg->req.bell, 1);
+        futex_wake(&seg->req.bell);
+    }
+    atomic_fetch_sub(&stoppers, 1);
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    shm_stop();
+}
+
+static const char *op_compile(shm_server_t *s, const shm_request_t *q, shm_reply_t *r) {
+    char text[SHM_TEXT + 1];
+    memcpy(text, q->text, SHM_TEXT);
+    text[SHM_TEXT] = '\0';
+
+    const char *names[SHM_MAX_ARGS];
+    int n_names = 0;
+    char *body = strchr(text, ':');
+    if (body) {
+        *body++ = '\0';
+        for (char *t = strtok(text, ", \t"); t; t = strtok(NULL, ", \t")) {
+            if (n_names == SHM_MAX_ARGS) return "too many variables";
+            names[n_names++] = t;
+        }
+    } else {
+        body = text;
+    }
+
+    int id = 0;
+    while (id < SHM_MAX_EXPRS && s->expr[id].prog) id++;
+    if (id == SHM_MAX_EXPRS) return "expression table full";
+
+    expr_set_quiet(1);
+    expr_program_t *prog = expr_compile_vars(body, names, n_names);
+    if (!prog) return expr_last_error();
+    expr_jit_t *jit = expr_jit_compile(prog);
+    if (!jit) { expr_free(prog); return "out of memory"; }
+
+    s->expr[id].prog = prog;
+    s->expr[id].jit = jit;
+    r->id = id;
+    r->value = id;
+    return NULL;
+}
+
+static const shm_expr_t *find_expr(const shm_server_t *s, uint32_t id) {
+    return id < SHM_MAX_EXPRS && s->expr[id].prog ? &s->expr[id] : NULL;
+}
+
+static const char *dispatch(shm_server_t *s, const shm_request_t *q, shm_reply_t *r) {
+    const shm_expr_t *e;
+    if (q->n > SHM_MAX_ARGS && q->op != SHM_OP_COMPILE) return "too many arguments";
+
+    switch (q->op) {
+    case SHM_OP_COMPILE:
+        return op_compile(s, q, r);
+    case SHM_OP_EXPR:
+        if (!(e = find_expr(s, q->id))) return "no such expression";
+        if (q->n != e->prog->n_vars) return "wrong number of values for this expression";
+        r->value = expr_jit_eval(e->jit, q->arg);
+        return NULL;
+    case SHM_OP_RELEASE:
+        if (!find_expr(s, q->id)) return "no such expression";
+        expr_jit_free(s->expr[q->id].jit);
+        expr_free(s->expr[q->id].prog);
+        s->expr[q->id].prog = NULL;
+        s->expr[q->id].jit = NULL;
+        return NULL;
+    default:
+        if (q->op > SHM_OP_RELEASE || s->numeric[q->op] < 0) return "unknown request";
+        return batch_eval_numeric(s->numeric[q->op], q->arg, q->n, &r->value);
+    }
+}
+
+static void answer(shm_server_t *s, const shm_request_t *slot, shm_reply_t *r) {
+    /* The client can write the slot at any time; work on a private copy */
+    shm_request_t q;
+    memcpy(&q, slot, sizeof q);
+
+    r->tag = q.tag;
+    r->id = q.id;
+    r->value = 0.0;
+    const char *err = dispatch(s, &q, r);
+    r->status = err != NULL;
+    if (err) snprintf(r->error, sizeof r->error, "%s", err);
+    else r->error[0] = '\0';
+}
+
+static void serve_loop(shm_server_t *s) {
+    shm_segment_t *seg = s->seg;
+    unsigned tail = atomic_load_explicit(&seg->req.tail, memory_order_relaxed);
+    unsigned out = atomic_load_explicit(&seg->rep.head, memory_order_relaxed);
+
+    for (;;) {
+        unsigned head = ring_wait(&seg->req, tail, &stop_flag, 0, NULL, NULL);
+        if (head == tail) return;
+
+        while (tail != head) {
+            /* Only a client breaking the in-flight limit can fill the reply ring */
+            if (out - atomic_load_explicit(&seg->rep.tail, memory_order_acquire) >= SHM_SLOTS) {
+                struct timespec pause = { 0, 50000 };
+                ring_publish(&seg->rep, out);
+                if (atomic_load(&stop_flag)) return;
+                nanosleep(&pause, NULL);
+                continue;
+            }
+            answer(s, &seg->req_slot[tail % SHM_SLOTS], &seg->rep_slot[out % SHM_SLOTS]);
+            tail++;
+            out++;
+            s->n_requests++;
+        }
+        ring_publish(&seg->rep, out);
+        atomic_store_explicit(&seg->req.tail, tail, memory_order_release);
+    }
+}
+
+/* Map the segment, creating it; one left by a server that died is replaced */
+static shm_segment_t *create_segment(const char *path) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            shm_segment_t *seg = NULL;
+            if (ftruncate(fd, sizeof *seg) == 0) {
+                seg = mmap(NULL, sizeof *seg, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (seg == MAP_FAILED) seg = NULL;
+            }
+            close(fd);
+            if (!seg) { shm_unlink(path); break; }
+            return seg;
+        }
+        if (errno != EEXIST) break;
+
+        fd = shm_open(path, O_RDONLY, 0);
+        struct stat st;
+        if (fd >= 0 && fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(shm_segment_t)) {
+            shm_segment_t *old = mmap(NULL, sizeof *old, PROT_READ, MAP_SHARED, fd, 0);
+            int live = old != MAP_FAILED && old->magic == SHM_MAGIC &&
+                       process_alive(atomic_load(&old->server_pid));
+            if (old != MAP_FAILED) munmap(old, sizeof *old);
+            if (live) {
+                close(fd);
+                printf("Error: a server is already running on %s\n", path);
+                return NULL;
+            }
+        }
+        if (fd >= 0) close(fd);
+        shm_unlink(path);
+    }
+    printf("Error: cannot create shared memory %s: %s\n", path, strerror(errno));
+    return NULL;
+}
+
+int shm_serve(const char *name) {
+    static const char *const numeric_names[SHM_OP_RELEASE + 1] = {
+        [SHM_OP_SERIES] = "series", [SHM_OP_PARALLEL] = "parallel",
+        [SHM_OP_OHM_V] = "ohm_v", [SHM_OP_OHM_I] = "ohm_i",
+        [SHM_OP_OHM_R] = "ohm_r", [SHM_OP_OHM_P] = "ohm_p",
+        [SHM_OP_XC] = "xc", [SHM_OP_XL] = "xl",
+    };
+    char path[SHM_NAME];
+    if (!shm_path(name, path)) return 1;
+    init_spin();
+
+    shm_server_t *s = calloc(1, sizeof *s);
+    if (!s) { printf("Error: out of memory\n"); return 1; }
+    for (int op = 0; op <= SHM_OP_RELEASE; op++)
+        s->numeric[op] = numeric_names[op] ? batch_find_numeric(numeric_names[op]) : -1;
+
+    s->seg = create_segment(path);
+    if (!s->seg) { free(s); return 1; }
+    shm_segment_t *seg = s->seg;
+    seg->version = SHM_VERSION;
+    seg->slot_size = sizeof(shm_request_t);
+    seg->n_slots = SHM_SLOTS;
+    atomic_store(&seg->server_pid, getpid());
+    atomic_store_explicit(&seg->magic, SHM_MAGIC, memory_order_release);
+
+    struct sigaction sa = { .sa_handler = on_signal }, old_int, old_term;
+    sigemptyset(&sa.sa_mask);
+    atomic_store(&stop_flag, 0);
+    atomic_store(&live_seg, seg);
+    sigaction(SIGINT, &sa, &old_int);
+    sigaction(SIGTERM, &sa, &old_term);
+
+    printf("Serving on shared memory %s, %d slots per ring (Ctrl+C to stop)\n", path, SHM_SLOTS);
+    fflush(stdout);
+    serve_loop(s);
+
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    atomic_store(&live_seg, NULL);
+    while (atomic_load(&stoppers)) sched_yield();   /* before the unmap below */
+
+    /* Wake a client blocked on a reply so it sees the server has gone */
+    atomic_store(&seg->server_pid, 0);
+    atomic_fetch_add(&seg->rep.bell, 1);
+    futex_wake(&seg->rep.bell);
+    printf("Served %llu requests\n", s->n_requests);
+
+    for (int i = 0; i < SHM_MAX_EXPRS; i++) {
+        if (!s->expr[i].prog) continue;
+        expr_jit_free(s->expr[i].jit);
+        expr_free(s->expr[i].prog);
+    }
+    munmap(seg, sizeof *seg);
+    shm_unlink(path);
+    free(s);
+    return 0;
+}
+
+/* ────────────────────────────────────────────────
+   CLIENT
+   ──────────────────────────────────────────────── */
+
+struct shm_client {
+    shm_segment_t *seg;
+    unsigned sent, received;        /* this client's request and reply counts */
+    unsigned head, tail;            /* next request slot, next reply slot */
+    unsigned rung;                  /* request head the server was last woken for */
+    atomic_int never;               /* ring_wait() stop flag that stays clear */
+};
+
+static int server_gone(void *ctx) {
+    shm_segment_t *seg = ctx;
+    return !process_alive(atomic_load(&seg->server_pid));
+}
+
+shm_client_t *shm_client_open(const char *name) {
+    char path[SHM_NAME];
+    if (!shm_path(name, path)) return NULL;
+    init_spin();
+
+    int fd = shm_open(path, O_RDWR, 0);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(shm_segment_t)) {
+        printf("Error: no server on shared memory %s\n", path);
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+    shm_segment_t *seg = mmap(NULL, sizeof *seg, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) { printf("Error: cannot map shared memory %s\n", path); return NULL; }
+
+    if (atomic_load_explicit(&seg->magic, memory_order_acquire) != SHM_MAGIC ||
+        seg->version != SHM_VERSION || !process_alive(atomic_load(&seg->server_pid))) {
+        printf("Error: no server on shared memory %s\n", path);
+        munmap(seg, sizeof *seg);
+        return NULL;
+    }
+
+    int me = getpid(), owner = 0;
+    while (!atomic_compare_exchange_strong(&seg->client_pid, &owner, me)) {
+        if (process_alive(owner)) {
+            printf("Error: another client (pid %d) is attached to %s\n", owner, path);
+            munmap(seg, sizeof *seg);
+            return NULL;
+        }
+    }
+
+    shm_client_t *c = calloc(1, sizeof *c);
+    if (!c) { atomic_store(&seg->client_pid, 0); munmap(seg, sizeof *seg); return NULL; }
+    c->seg = seg;
+
+    /* A client that closed or died may have left requests behind, perhaps
+       never rung for: wake the server, let it finish them, then skip
+       their replies */
+    c->head = c->rung = atomic_load_explicit(&seg->req.head, memory_order_relaxed);
+    ring_publish(&seg->req, c->head);
+    while (atomic_load_explicit(&seg->req.tail, memory_order_acquire) != c->head) {
+        if (server_gone(seg)) break;
+        atomic_store_explicit(&seg->rep.tail, atomic_load(&seg->rep.head), memory_order_release);
+        sched_yield();
+    }
+    c->tail = atomic_load_explicit(&seg->rep.head, memory_order_acquire);
+    atomic_store_explicit(&seg->rep.tail, c->tail, memory_order_release);
+    return c;
+}
+
+void shm_client_close(shm_client_t *c) {
+    if (!c) return;
+    if (c->rung != c->head) ring_publish(&c->seg->req, c->head);
+    atomic_store(&c->seg->client_pid, 0);
+    munmap(c->seg, sizeof *c->seg);
+    free(c);
+}
+
+int shm_submit(shm_client_t *c, const shm_request_t *req) {
+    if (c->sent - c->received >= SHM_SLOTS) return -1;
+    memcpy(&c->seg->req_slot[c->head % SHM_SLOTS], req, sizeof *req);
+    /* A polling server sees this at once; a sleeping one is woken by
+       shm_receive(), so a pipelined burst costs one wakeup, not one each */
+    atomic_store_explicit(&c->seg->req.head, ++c->head, memory_order_release);
+    c->sent++;
+    return 0;
+}
+
+int shm_receive(shm_client_t *c, shm_reply_t *rep) {
+    shm_segment_t *seg = c->seg;
+    if (c->sent == c->received) return -1;
+    if (c->rung != c->head) {
+        ring_publish(&seg->req, c->head);
+        c->rung = c->head;
+    }
+    if (ring_wait(&seg->rep, c->tail, &c->never, 100000000L, server_gone, seg) == c->tail)
+        return -1;
+    memcpy(rep, &seg->rep_slot[c->tail % SHM_SLOTS], sizeof *rep);
+    atomic_store_explicit(&seg->rep.tail, ++c->tail, memory_order_release);
+    c->received++;
+    return 0;
+}
+
+int shm_call(shm_client_t *c, const shm_request_t *req, shm_reply_t *rep) {
+    return shm_submit(c, req) == 0 ? shm_receive(c, rep) : -1;
+}
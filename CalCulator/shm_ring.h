@@ -0,0 +1,74 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stdint.h>
+
+/* Shared-memory front end for test benches that query at kHz rates,
+   where even a Unix-socket round trip costs too much. The server owns a
+   POSIX shm segment holding two single-producer / single-consumer rings
+   of fixed 128-byte slots: requests from one client, replies back. Both
+   sides publish with a release store of their index and spin briefly
+   before sleeping on a futex, so a busy bench never enters the kernel.
+   Replies come back in request order; up to SHM_SLOTS requests may be
+   in flight at once. */
+
+#define SHM_SLOTS     256       /* slots per ring, a power of two */
+#define SHM_MAX_ARGS  14
+#define SHM_TEXT      112       /* SHM_OP_COMPILE text, NUL included */
+#define SHM_MAX_EXPRS 256       /* compiled expressions held per server */
+
+typedef enum {
+    SHM_OP_SERIES = 1,      /* arg[0 .. n-1] */
+    SHM_OP_PARALLEL,        /* arg[0 .. n-1] */
+    SHM_OP_OHM_V,           /* I R */
+    SHM_OP_OHM_I,           /* V R */
+    SHM_OP_OHM_R,           /* V I */
+    SHM_OP_OHM_P,           /* V I */
+    SHM_OP_XC,              /* f C */
+    SHM_OP_XL,              /* f L */
+    SHM_OP_COMPILE,         /* text "V, R1, R2: V/(R1+R2)*R2"; reply.id names it */
+    SHM_OP_EXPR,            /* id, with one arg per variable in compile order */
+    SHM_OP_RELEASE          /* id: the expression is no longer needed */
+} shm_op_t;
+
+typedef struct {
+    uint64_t tag;           /* copied into the reply */
+    uint16_t op;            /* shm_op_t */
+    uint16_t n;             /* arguments used */
+    uint32_t id;            /* compiled expression, SHM_OP_EXPR / RELEASE */
+    union {
+        double arg[SHM_MAX_ARGS];
+        char text[SHM_TEXT];
+    };
+} shm_request_t;
+
+typedef struct {
+    uint64_t tag;
+    int32_t status;         /* 0, or 1 with the reason in error */
+    uint32_t id;            /* SHM_OP_COMPILE result */
+    double value;
+    char error[104];
+} shm_reply_t;
+
+/* Create the segment ("/calc" or "calc": both name /dev/shm/calc) and
+   answer until SIGINT / SIGTERM or shm_stop(). Returns 0 on a clean
+   shutdown, 1 (after printing why) if the segment could not be set up. */
+int shm_serve(const char *name);
+void shm_stop(void);        /* safe from a signal handler */
+
+/* Client side, for the bench process. Only one client may be attached
+   to a segment; one left attached by a process that died is reclaimed. */
+typedef struct shm_client shm_client_t;
+
+shm_client_t *shm_client_open(const char *name);   /* NULL after printing why */
+void shm_client_close(shm_client_t *c);
+
+/* shm_submit() queues a request, returning -1 if SHM_SLOTS already
+   await replies; shm_receive() sends any queued ones on, blocks for the
+   oldest reply and returns -1 if the server has gone away. shm_call()
+   is one full round trip. */
+int shm_submit(shm_client_t *c, const shm_request_t *req);
+int shm_receive(shm_client_t *c, shm_reply_t *rep);
+int shm_call(shm_client_t *c, const shm_request_t *req, shm_reply_t *rep);
+
+#endif
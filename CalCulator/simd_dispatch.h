@@ -0,0 +1,25 @@
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+/* Runtime AVX2 dispatch for the vector-extension kernels.
+   SIMD_KERNEL(name, (params), (args)) wraps an always_inline
+   name##_body(params) in a generic copy and, on x86, a copy built for
+   AVX2, and defines name##_pick() returning the one this CPU runs best.
+   The AVX2 copy does not enable FMA, so both round alike and results
+   are bit-identical whichever copy is picked. */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_KERNEL(name, params, args)                                         \
+    static void name##_generic params { name##_body args; }                     \
+    __attribute__((target("avx2")))                                             \
+    static void name##_avx2 params { name##_body args; }                        \
+    static __typeof__(&name##_generic) name##_pick(void) {                      \
+        return __builtin_cpu_supports("avx2") ? name##_avx2 : name##_generic;   \
+    }
+#else
+#define SIMD_KERNEL(name, params, args)                                         \
+    static void name##_generic params { name##_body args; }                     \
+    static __typeof__(&name##_generic) name##_pick(void) { return name##_generic; }
+#endif
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+/* Minimal assertions for the tests/ programs. A failed CHECK prints
+   where and what and is counted; main() ends with check_result(). */
+
+#include <stdio.h>
+
+static int check_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            check_failures++;                                               \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        }                                                                   \
+    } while (0)
+
+static inline int check_result(const char *name) {
+    printf("%-18s %s\n", name, check_failures ? "FAILED" : "ok");
+    return check_failures != 0;
+}
+
+#endif
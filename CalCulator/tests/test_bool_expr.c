@@ -0,0 +1,100 @@
+/*
+ * Two-level minimizer: known functions minimize to their textbook SOP,
+ * and on random functions both methods return a cover of primes that
+ * matches the on-set outside the don't-cares, the same for every thread
+ * count.
+ *
+ * Built and run by `make test`.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "../bool_expr.h"
+#include "../parallel.h"
+#include "check.h"
+
+static int row(const uint64_t *v, uint32_t r) { return v[r >> 6] >> (r & 63) & 1; }
+
+static int inside(const bool_cube_t *c, uint32_t r) { return (r & c->mask) == c->value; }
+
+static void check_sop(const char *expr, const char *want) {
+    bool_expr_t *e = bool_parse(expr);
+    uint64_t *on = e ? bool_on_set(e) : NULL;
+    bool_cube_t *cubes = NULL;
+    char buf[256] = "";
+    int n = on ? bool_minimize(e->n_vars, on, NULL, BOOL_EXACT, &cubes) : -1;
+    if (n >= 0) bool_format_sop(e, cubes, n, buf, sizeof buf);
+    if (strcmp(buf, want)) printf("  %s -> \"%s\", want \"%s\"\n", expr, buf, want);
+    CHECK(strcmp(buf, want) == 0);
+    free(cubes);
+    free(on);
+    bool_free(e);
+}
+
+static void test_known(void) {
+    check_sop("A&B | A&!B", "A");
+    check_sop("A B | !A C | B C", "!A & C | A & B");         /* consensus term dropped */
+    check_sop("A^B^C", "!A & !B & C | !A & B & !C | A & !B & !C | A & B & C");
+    check_sop("A & !A", "0");
+    check_sop("A | !A", "1");
+    check_sop("!(A|B)", "!A & !B");
+    check_sop("NAND(A,B,C)", "!A | !B | !C");
+    check_sop("A(B+C)'", "A & !B & !C");
+}
+
+/* A valid cover is inside on|dc, covers every on-only row, and every
+   cube is prime: dropping any literal leaves the care set. */
+static void check_cover(int n, const uint64_t *on, const uint64_t *dc, const bool_cube_t *c, int k) {
+    uint32_t rows = 1u << n;
+    for (uint32_t r = 0; r < rows; r++) {
+        int covered = 0;
+        for (int i = 0; i < k && !covered; i++) covered = inside(&c[i], r);
+        int care_on = row(on, r), dont = dc && row(dc, r);
+        CHECK(dont || covered == care_on);
+    }
+    for (int i = 0; i < k; i++)
+        for (int b = 0; b < n; b++) {
+            if (!(c[i].mask >> b & 1)) continue;
+            bool_cube_t wider = { c[i].value & ~(1u << b), c[i].mask & ~(1u << b) };
+            int leaves = 0;
+            for (uint32_t r = 0; r < rows && !leaves; r++)
+                leaves = inside(&wider, r) && !row(on, r) && !(dc && row(dc, r));
+            CHECK(leaves);
+        }
+}
+
+static void test_random(void) {
+    srand(12345);
+    for (int n = 2; n <= 12; n++) {
+        size_t words = n >= 6 ? (size_t)1 << (n - 6) : 1;
+        uint64_t *on = calloc(words, sizeof(uint64_t)), *dc = calloc(words, sizeof(uint64_t));
+        if (!on || !dc) { CHECK(on && dc); free(on); free(dc); return; }
+        for (uint32_t r = 0; r < 1u << n; r++) {
+            int x = rand() % 8;
+            if (x < 3) on[r >> 6] |= 1ull << (r & 63);
+            else if (x == 3) dc[r >> 6] |= 1ull << (r & 63);
+        }
+        for (int method = BOOL_EXACT; method <= BOOL_HEURISTIC; method++)
+            for (int with_dc = 0; with_dc < 2; with_dc++) {
+                const uint64_t *d = with_dc ? dc : NULL;
+                bool_cube_t *ref = NULL, *c = NULL;
+                par_set_threads(1);
+                int k = bool_minimize(n, on, d, method, &ref);
+                CHECK(k >= 0);
+                if (k >= 0) check_cover(n, on, d, ref, k);
+                par_set_threads(4);
+                int k4 = bool_minimize(n, on, d, method, &c);
+                CHECK(k4 == k && (k <= 0 || memcmp(c, ref, k * sizeof *c) == 0));
+                free(ref);
+                free(c);
+            }
+        par_set_threads(0);
+        free(on);
+        free(dc);
+    }
+}
+
+int main(void) {
+    test_known();
+    test_random();
+    return check_result("bool_expr");
+}
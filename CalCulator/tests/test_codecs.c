@@ -0,0 +1,128 @@
+/*
+ * Resistor markings: known SMD codes decode to their values, and every
+ * E24 / E96 value survives an SMD or colour-band encode and decode. The
+ * bulk encoders agree with the single-value ones.
+ *
+ * Built and run by `make test`.
+ */
+#include <string.h>
+#include <math.h>
+#include "../resistor_calc.h"
+#include "../bom_decode.h"
+#include "../eseries.h"
+#include "check.h"
+
+static int close_to(double a, double b) { return fabs(a - b) <= 1e-12 * fabs(b); }
+
+static int smd(const char *code, double *ohms) { return smd_resistor_value(code, strlen(code), ohms); }
+
+/* Mantissa i of a series scaled to the decade starting at 10^e ohms */
+static double preferred(int series, int i, int e) {
+    return eseries_mantissa(series, i) / 100.0 * pow(10, e);
+}
+
+static void test_smd_decode(void) {
+    double r;
+    CHECK(smd("472", &r) == SMD_DIGITS && r == 4700);
+    CHECK(smd("102", &r) == SMD_DIGITS && r == 1000);
+    CHECK(smd("000", &r) == SMD_DIGITS && r == 0);
+    CHECK(smd("4R7", &r) == SMD_DIGITS && close_to(r, 4.7));
+    CHECK(smd("R47", &r) == SMD_DIGITS && close_to(r, 0.47));
+    CHECK(smd("1001", &r) == SMD_DIGITS && r == 1000);
+    CHECK(smd("49R9", &r) == SMD_DIGITS && close_to(r, 49.9));
+    CHECK(smd("01A", &r) == SMD_EIA96 && r == 100);
+    CHECK(smd("01C", &r) == SMD_EIA96 && r == 10000);
+    CHECK(smd("49C", &r) == SMD_EIA96 && r == 31600);
+    CHECK(smd("96Z", &r) == SMD_EIA96 && close_to(r, 9.76));
+    CHECK(smd("0", &r) == SMD_INVALID);
+    CHECK(smd("12", &r) == SMD_INVALID);
+    CHECK(smd("abc", &r) == SMD_INVALID);
+    /* length-delimited: only "47" of "472" */
+    CHECK(smd_resistor_value("472", 2, &r) == SMD_INVALID);
+}
+
+static void round_trip_smd(int series, int style, int e_lo, int e_hi) {
+    for (int e = e_lo; e <= e_hi; e++)
+        for (int i = 0; i < eseries_count(series); i++) {
+            double v = preferred(series, i, e), back = -1;
+            char code[8];
+            size_t n = smd_resistor_code(v, style, code);
+            CHECK(n > 0 && n == strlen(code));
+            CHECK(smd_resistor_value(code, n, &back) != SMD_INVALID && close_to(back, v));
+        }
+}
+
+static void test_smd_round_trip(void) {
+    round_trip_smd(24, SMD_STYLE_3DIGIT, 0, 6);
+    round_trip_smd(96, SMD_STYLE_4DIGIT, 0, 6);
+    round_trip_smd(96, SMD_STYLE_EIA96, 0, 7);
+
+    char code[8];
+    CHECK(smd_resistor_code(0.001, SMD_STYLE_3DIGIT, code) == 0);
+
+    /* Bulk form matches the scalar one, unmarkable values included */
+    double ohms[] = { 4700, 4.7, 0.47, 49.9, 1e9, 0.001, 221000 };
+    char codes[7][8];
+    int styles[] = { SMD_STYLE_3DIGIT, SMD_STYLE_4DIGIT, SMD_STYLE_EIA96 };
+    for (int s = 0; s < 3; s++) {
+        smd_encode_array(ohms, 7, styles[s], codes);
+        for (int i = 0; i < 7; i++) {
+            size_t n = smd_resistor_code(ohms[i], styles[s], code);
+            CHECK(n ? strcmp(codes[i], code) == 0 : codes[i][0] == '\0');
+        }
+    }
+}
+
+static void test_colors(void) {
+    const char *b[6];
+    double r, tol;
+
+    CHECK(color_encode_bands(4700, 4, b) &&
+          !strcmp(b[0], "yellow") && !strcmp(b[1], "violet") && !strcmp(b[2], "red") && !strcmp(b[3], "gold"));
+    const char *mixed[] = { "Yellow", "VIOLET", "red", "gold" };
+    CHECK(color_decode(mixed, 4, &r, &tol) && r == 4700 && tol == 5);
+    const char *bad[] = { "red", "purple", "black", "gold" };
+    CHECK(!color_decode(bad, 4, &r, &tol));
+    CHECK(color_tempco("brown") == 100 && color_tempco("gold") == -1);
+
+    for (int n_bands = 4; n_bands <= 6; n_bands++) {
+        int series = n_bands == 4 ? 24 : 96;
+        for (int e = 0; e <= 5; e++)
+            for (int i = 0; i < eseries_count(series); i++) {
+                double v = preferred(series, i, e);
+                CHECK(color_encode_bands(v, n_bands, b));
+                CHECK(color_decode(b, n_bands, &r, &tol) && close_to(r, v) && tol == (n_bands == 4 ? 5 : 1));
+                if (n_bands == 6) CHECK(color_tempco(b[5]) == 100);
+            }
+    }
+
+    /* Bulk forms over colour indices agree with the scalar ones */
+    double ohms[] = { 4700, 10, 1e6, 49.9, 1e12 }, back[5];
+    unsigned char idx[5 * 5];
+    CHECK(color_encode_array(ohms, 5, 5, idx) == 4);           /* 1e12 does not fit */
+    CHECK(color_decode_array(idx, 5, 5, back) == 4);
+    for (int i = 0; i < 5; i++) {
+        if (!color_encode_bands(ohms[i], 5, b)) { CHECK(idx[i * 5] == 0xFF && isnan(back[i])); continue; }
+        for (int k = 0; k < 5; k++) CHECK(!strcmp(color_name(idx[i * 5 + k]), b[k]));
+        CHECK(color_decode(b, 5, &r, &tol) && back[i] == r);
+    }
+}
+
+static void test_bom(void) {
+    char out[64];
+    int invalid;
+    size_t n = bom_decode_line("\"4R7\", L", 8, out, sizeof out, &invalid);
+    CHECK(n == 13 && !memcmp(out, "4R7,L,4.7e-06", n) && !invalid);
+    n = bom_decode_line("104,C", 5, out, sizeof out, &invalid);
+    CHECK(n == 11 && !memcmp(out, "104,C,1e-07", n) && !invalid);
+    n = bom_decode_line("9Z9,R", 5, out, sizeof out, &invalid);
+    CHECK(n == 11 && !memcmp(out, "9Z9,R,error", n) && invalid);
+}
+
+int main(void) {
+    test_smd_decode();
+    test_smd_round_trip();
+    test_colors();
+    test_bom();
+    return check_result("codecs");
+}
@@ -0,0 +1,116 @@
+/*
+ * Expression parser: precedence, SI prefixes, variables, gradients and
+ * the malformed inputs it must reject with a message.
+ * Expression cache: a repeated expression is a hit, expressions of a new
+ * shape are misses, and cached programs give the compiled value.
+ *
+ * Built and run by `make test`.
+ */
+#include <string.h>
+#include <math.h>
+#include "../expression_eval.h"
+#include "check.h"
+
+static int same(double a, double b) { return memcmp(&a, &b, sizeof a) == 0; }
+
+static double compiled(const char *expr) {
+    expr_program_t *p = expr_compile(expr);
+    double v = p ? expr_run(p) : -1;
+    expr_free(p);
+    return v;
+}
+
+/* NULL program, and the recorded message mentions 'why' */
+static int rejected(const char *expr, const char *why) {
+    expr_program_t *p = expr_compile(expr);
+    expr_free(p);
+    return p == NULL && strstr(expr_last_error(), why) != NULL;
+}
+
+static void test_parse(void) {
+    CHECK(compiled("2+3*4") == 14);
+    CHECK(compiled("(2+3)*4") == 20);
+    CHECK(compiled("10-4-3") == 3);
+    CHECK(compiled("8/4/2") == 1);
+    CHECK(compiled("((1))") == 1);
+    CHECK(compiled("10 / 4") == 2.5);
+    CHECK(compiled("7/8") == 0.875);
+    CHECK(compiled("4.7k") == 4700);
+    CHECK(compiled("1e3") == 1000);
+    CHECK(same(compiled("3m"), 3e-3));
+    CHECK(same(compiled("2.2u*1M"), 2.2e-6 * 1e6));
+    CHECK(isinf(compiled("1/0")));
+
+    CHECK(rejected("1+2)", "unbalanced parentheses"));
+    CHECK(rejected("(1+2", "unbalanced parentheses"));
+    CHECK(rejected("2 3", "missing operator"));
+    CHECK(rejected("1+", "missing an operand"));
+    CHECK(rejected("", "Empty expression"));
+    CHECK(rejected("R1+2", "Unknown variable 'R1'"));
+
+    const char *names[] = { "V", "R1", "R2" };
+    const double vals[] = { 12, 1000, 2000 };
+    expr_program_t *p = expr_compile_vars("V/(R1+R2)*R2", names, 3);
+    CHECK(p && expr_eval(p, vals) == 8);
+    expr_free(p);
+
+    p = expr_compile_vars("V*X", names, 3);
+    CHECK(p == NULL && strstr(expr_last_error(), "Unknown variable 'X'"));
+    expr_free(p);
+
+    double grad[3];
+    p = expr_compile_vars("V*R1+R2/R1", names, 3);
+    CHECK(p && expr_eval_grad(p, vals, grad) == 12002);
+    CHECK(grad[0] == 1000 && fabs(grad[1] - 11.998) < 1e-12 && grad[2] == 1e-3);
+
+    /* Batch rows match one-at-a-time evaluation */
+    double col_v[5], col_r1[5], col_r2[5], out[5];
+    const double *cols[] = { col_v, col_r1, col_r2 };
+    for (int r = 0; r < 5; r++) { col_v[r] = r + 1; col_r1[r] = 10.0 * (r + 1); col_r2[r] = 3.3 - r; }
+    if (p) expr_eval_batch(p, cols, 5, out);
+    for (int r = 0; p && r < 5; r++) {
+        double row[] = { col_v[r], col_r1[r], col_r2[r] };
+        CHECK(same(out[r], expr_eval(p, row)));
+    }
+    expr_free(p);
+}
+
+static void test_cache(void) {
+    expr_cache_stats_t st;
+    double r;
+
+    expr_cache_clear();
+    CHECK(expr_cache_eval("1+2*3", &r) == 0 && r == 7);
+    expr_cache_stats(&st);
+    CHECK(st.misses == 1 && st.hits == 0 && st.entries == 1);
+    CHECK(expr_cache_eval("1+2*3", &r) == 0 && r == 7);
+    expr_cache_stats(&st);
+    CHECK(st.misses == 1 && st.hits == 1);
+
+    /* The expr_cache/varied bench inputs: one shape, so one miss */
+    expr_cache_clear();
+    for (int i = 0; i < 16; i++) {
+        char e[64];
+        snprintf(e, sizeof e, "((%dk*%d)+(22-%d)/((45k-44k)*(%dm+44k)))", 40 + i, 30 + i, i, 20 + i);
+        CHECK(expr_cache_eval(e, &r) == 0 && same(r, compiled(e)));
+    }
+    expr_cache_stats(&st);
+    CHECK(st.misses == 1 && st.hits == 15 && st.entries == 1);
+
+    CHECK(expr_cache_eval("(1+2)/4", &r) == 0 && r == 0.75);
+    expr_cache_stats(&st);
+    CHECK(st.misses == 2 && st.entries == 2);
+
+    CHECK(expr_cache_eval("1+2)", &r) == 1);
+    CHECK(expr_cache_eval("2 3", &r) == 1);
+    expr_cache_clear();
+    expr_cache_stats(&st);
+    CHECK(st.hits == 0 && st.misses == 0 && st.entries == 0);
+}
+
+int main(void) {
+    expr_set_quiet(1);
+    test_parse();
+    test_cache();
+    return check_result("expression");
+}
@@ -0,0 +1,74 @@
+/*
+ * Monte Carlo: a seed gives the same statistics for every thread count,
+ * draws stay inside their tolerance bands, and the sensitivity pass
+ * reports the exact derivatives and worst case.
+ *
+ * Built and run by `make test`.
+ */
+#include <string.h>
+#include "../monte_carlo.h"
+#include "../expression_eval.h"
+#include "../parallel.h"
+#include "check.h"
+
+static const mc_param_t divider[3] = {
+    { "V",  5,     2, MC_GAUSSIAN },
+    { "R1", 10e3,  5, MC_UNIFORM },
+    { "R2", 4.7e3, 1, MC_FIXED },
+};
+
+static void test_seed_determinism(void) {
+    const char *expr = "V*R2/(R1+R2)";
+    mc_result_t ref, r;
+
+    par_set_threads(1);
+    CHECK(mc_run(expr, divider, 3, 100000, 42, &ref) == 0);
+    CHECK(ref.trials == 100000 && ref.valid == 100000);
+    CHECK(ref.nominal == 5 * 4.7e3 / (10e3 + 4.7e3));
+    for (int t = 2; t <= 8; t *= 2) {
+        par_set_threads(t);
+        CHECK(mc_run(expr, divider, 3, 100000, 42, &r) == 0 && memcmp(&r, &ref, sizeof r) == 0);
+    }
+    par_set_threads(0);
+
+    CHECK(mc_run(expr, divider, 3, 100000, 43, &r) == 0 && r.mean != ref.mean);
+
+    uint64_t binned = 0;
+    for (int b = 0; b < MC_HIST_BINS; b++) binned += ref.hist[b];
+    CHECK(binned == ref.valid);
+    for (int p = 1; p < MC_N_PCT; p++) CHECK(ref.percentile[p - 1] <= ref.percentile[p]);
+    CHECK(ref.min <= ref.percentile[0] && ref.percentile[MC_N_PCT - 1] <= ref.max);
+}
+
+static void test_bands(void) {
+    mc_result_t r;
+
+    /* R1 uniform within ±5 %, R2 fixed */
+    CHECK(mc_run("R1+R2", divider + 1, 2, 50000, 7, &r) == 0);
+    CHECK(r.min >= 9.5e3 + 4.7e3 && r.max <= 10.5e3 + 4.7e3);
+    CHECK(r.max - r.min > 900);
+
+    CHECK(mc_run("R2*2", divider + 2, 1, 1000, 7, &r) == 0);
+    CHECK(r.min == 9.4e3 && r.max == 9.4e3 && r.stddev == 0);
+
+    CHECK(mc_run("V*Q", divider, 3, 10, 1, &r) == 1);
+}
+
+static void test_sensitivity(void) {
+    double nominal, partial[3], lo, hi;
+    CHECK(mc_sensitivity("R1+R2", divider + 1, 2, &nominal, partial, &lo, &hi) == 0);
+    CHECK(nominal == 14.7e3 && partial[0] == 1 && partial[1] == 1);
+    CHECK(lo == 14.2e3 && hi == 15.2e3);               /* R2 is fixed */
+
+    CHECK(mc_sensitivity("V*R2/(R1+R2)", divider, 3, &nominal, partial, &lo, &hi) == 0);
+    CHECK(partial[0] > 0 && partial[1] < 0 && partial[2] > 0);
+    CHECK(lo < nominal && nominal < hi);
+}
+
+int main(void) {
+    expr_set_quiet(1);
+    test_seed_determinism();
+    test_bands();
+    test_sensitivity();
+    return check_result("monte_carlo");
+}
@@ -0,0 +1,68 @@
+/*
+ * Compensated sums: bit-identical results for every thread count, exact
+ * recovery of what a naive sum cancels away, and accuracy against a
+ * long double reference.
+ *
+ * Built and run by `make test`.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../reduce.h"
+#include "../parallel.h"
+#include "check.h"
+
+static int same(double a, double b) { return memcmp(&a, &b, sizeof a) == 0; }
+
+/* Values from 1 mΩ to 1 GΩ, fixed by the index */
+static double part(size_t i) {
+    uint64_t x = i * 0x9E3779B97F4A7C15ull;
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 29;
+    return ldexp((double)(x >> 11), -53) * pow(10, (double)(x % 13) - 3) + 1e-3;
+}
+
+static void test_thread_invariance(void) {
+    static const size_t sizes[] = { 0, 1, 7, 8, 9, 1000, 8191, 8193, (1 << 20) + 3, 3000000 };
+    size_t max = sizes[sizeof sizes / sizeof *sizes - 1];
+    double *v = malloc(max * sizeof(double));
+    if (!v) { CHECK(v != NULL); return; }
+    for (size_t i = 0; i < max; i++) v[i] = part(i);
+
+    for (size_t s = 0; s < sizeof sizes / sizeof *sizes; s++) {
+        size_t n = sizes[s];
+        par_set_threads(1);
+        double sum = sum_array(v, n), rsum = reciprocal_sum_array(v, n);
+        for (int t = 2; t <= 8; t *= 2) {
+            par_set_threads(t);
+            CHECK(same(sum_array(v, n), sum));
+            CHECK(same(reciprocal_sum_array(v, n), rsum));
+        }
+
+        long double ref = 0, rref = 0;
+        for (size_t i = 0; i < n; i++) { ref += v[i]; rref += 1.0L / v[i]; }
+        CHECK(fabs(sum - (double)ref) <= 1e-15 * fabs((double)ref));
+        CHECK(fabs(rsum - (double)rref) <= 1e-15 * fabs((double)rref));
+    }
+    par_set_threads(0);
+    free(v);
+}
+
+static void test_cancellation(void) {
+    double v[3000];
+    for (int i = 0; i < 3000; i += 3) { v[i] = 1e16; v[i + 1] = 1; v[i + 2] = -1e16; }
+    CHECK(sum_array(v, 3000) == 1000);
+    CHECK(sum_array(v, 0) == 0);
+
+    /* 1000 x 1 kΩ in parallel is exactly 1 Ω */
+    for (int i = 0; i < 1000; i++) v[i] = 1000;
+    CHECK(1 / reciprocal_sum_array(v, 1000) == 1);
+}
+
+int main(void) {
+    test_thread_invariance();
+    test_cancellation();
+    return check_result("reduce");
+}
@@ -0,0 +1,108 @@
+/*
+ * Split ranges: a transient capture or frequency sweep computed in
+ * pieces, or on any number of threads, is bit-identical to computing it
+ * in one call, and both still agree with the closed form.
+ *
+ * Built and run by `make test`.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../transient.h"
+#include "../freq_sweep.h"
+#include "../parallel.h"
+#include "check.h"
+
+#define N 40000                         /* spans several worker blocks */
+
+static const size_t cuts[] = { 1, 3, 777, 1023, 1024, 1025, 2500, 16385, 39999 };
+#define N_CUTS (sizeof cuts / sizeof *cuts)
+
+static int same_array(const double *a, const double *b, size_t n) { return memcmp(a, b, n * sizeof *a) == 0; }
+
+static void test_transient(double *v, double *i, double *v2, double *i2) {
+    static const tran_circuit_t circuits[] = {
+        { TRAN_RC,  1e3, 0,    1e-6, 5, 0,  0 },
+        { TRAN_RL,  10,  1e-3, 0,    5, 0,  0.1 },
+        { TRAN_RLC, 10,  1e-3, 1e-6, 5, 0,  0 },        /* underdamped */
+        { TRAN_RLC, 1e3, 1e-3, 1e-6, 0, 3,  0 },        /* overdamped discharge */
+    };
+    const double rate = 1e6;
+
+    for (size_t c = 0; c < sizeof circuits / sizeof *circuits; c++) {
+        par_set_threads(1);
+        CHECK(tran_samples(&circuits[c], rate, 0, N, v, i) == 0);
+        for (size_t q = 0; q < N_CUTS; q++) {
+            size_t s = cuts[q];
+            tran_samples(&circuits[c], rate, 0, s, v2, i2);
+            tran_samples(&circuits[c], rate, s, N - s, v2 + s, i2 + s);
+            CHECK(same_array(v, v2, N) && same_array(i, i2, N));
+        }
+        par_set_threads(4);
+        tran_samples(&circuits[c], rate, 0, N, v2, i2);
+        CHECK(same_array(v, v2, N) && same_array(i, i2, N));
+        /* a window far from t = 0 */
+        tran_samples(&circuits[c], rate, 12345, 1000, v2, i2);
+        CHECK(same_array(v + 12345, v2, 1000) && same_array(i + 12345, i2, 1000));
+    }
+    par_set_threads(0);
+
+    /* RC charge: v = 5 (1 - e^(-t/RC)); no drift by the last sample */
+    tran_samples(&circuits[0], rate, 0, N, v, i);
+    for (size_t k = 0; k < N; k += 997) {
+        double want = 5 * -expm1(-(k / rate) / 1e-3);
+        CHECK(fabs(v[k] - want) <= 1e-12 * 5);
+    }
+}
+
+static void test_sweep(double *mag, double *phase, double *mag2, double *phase2) {
+    static const fs_circuit_t circuits[] = {
+        { FS_SERIES,   10, 1e-3, 1e-6 },
+        { FS_PARALLEL, 50, 1e-3, 1e-6 },
+        { FS_PARALLEL, 0,  1e-3, 1e-6 },
+    };
+    static const fs_grid_t grids[] = {
+        { FS_LOG,    10,  1e7, N },
+        { FS_LINEAR, 100, 1e5, N },
+    };
+
+    for (size_t c = 0; c < sizeof circuits / sizeof *circuits; c++)
+        for (size_t g = 0; g < sizeof grids / sizeof *grids; g++) {
+            const fs_result_t all = { NULL, NULL, NULL, mag, phase };
+            par_set_threads(1);
+            CHECK(fs_sweep(&circuits[c], &grids[g], 0, N, &all) == 0);
+            for (size_t q = 0; q < N_CUTS; q++) {
+                size_t s = cuts[q];
+                const fs_result_t head = { NULL, NULL, NULL, mag2, phase2 };
+                const fs_result_t tail = { NULL, NULL, NULL, mag2 + s, phase2 + s };
+                fs_sweep(&circuits[c], &grids[g], 0, s, &head);
+                fs_sweep(&circuits[c], &grids[g], s, N - s, &tail);
+                CHECK(same_array(mag, mag2, N) && same_array(phase, phase2, N));
+            }
+            par_set_threads(4);
+            const fs_result_t again = { NULL, NULL, NULL, mag2, phase2 };
+            fs_sweep(&circuits[c], &grids[g], 0, N, &again);
+            CHECK(same_array(mag, mag2, N) && same_array(phase, phase2, N));
+        }
+    par_set_threads(0);
+
+    /* Series RLC at resonance is just R, with zero phase */
+    double f0 = 1 / (2 * M_PI * sqrt(1e-3 * 1e-6)), m[3], p[3];
+    const fs_grid_t around = { FS_LINEAR, f0 / 2, 1.5 * f0, 3 };
+    const fs_result_t out = { NULL, NULL, NULL, m, p };
+    CHECK(fs_sweep(&circuits[0], &around, 0, 3, &out) == 0);
+    CHECK(fabs(m[1] - 10) <= 1e-9 && fabs(p[1]) <= 1e-6);
+    CHECK(p[0] < 0 && p[2] > 0);                        /* capacitive below, inductive above */
+}
+
+int main(void) {
+    double *a = malloc(N * sizeof(double)), *b = malloc(N * sizeof(double));
+    double *c = malloc(N * sizeof(double)), *d = malloc(N * sizeof(double));
+    CHECK(a && b && c && d);
+    if (a && b && c && d) {
+        test_transient(a, b, c, d);
+        test_sweep(a, b, c, d);
+    }
+    free(a); free(b); free(c); free(d);
+    return check_result("split");
+}
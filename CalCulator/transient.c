@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "transient.h"
+#include "math_ops.h"
+#include "parallel.h"
+#include "simd_dispatch.h"
+
+#define LANES   4
+#define ANCHOR  1024                /* samples between exact e^(st) */
+#define BLOCK   16384               /* samples per task, multiple of ANCHOR */
+#define CSV_MAX 80                  /* longest "t,v,i\n" line */
+
+typedef double tr_vec_t __attribute__((vector_size(LANES * sizeof(double))));
+
+/* ────────────────────────────────────────────────
+   CLOSED FORM
+   Channel y (0 = voltage, 1 = current):
+       y(t) = off[y] + Σ_m Re[(c[y][m] + d[y][m] t) e^(s[m] t)]
+   with one or two modes s = sr + j si.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    int n_modes;
+    double sr[2], si[2];
+    double off[2];
+    double cr[2][2], ci[2][2];      /* [channel][mode] */
+    double dr[2][2], di[2][2];
+} wave_t;
+
+static void set_mode(wave_t *w, int m, double sr, double si) {
+    w->sr[m] = sr;
+    w->si[m] = si;
+    if (m + 1 > w->n_modes) w->n_modes = m + 1;
+}
+
+/* Current through C from the capacitor voltage mode: i = C dv/dt, and
+   d/dt (c + d t) e^(st) = (s c + d + s d t) e^(st) */
+static void current_from_voltage(wave_t *w, int m, double C) {
+    double sr = w->sr[m], si = w->si[m];
+    double cr = w->cr[0][m], ci = w->ci[0][m], dr = w->dr[0][m], di = w->di[0][m];
+    w->cr[1][m] = C * (sr * cr - si * ci + dr);
+    w->ci[1][m] = C * (sr * ci + si * cr + di);
+    w->dr[1][m] = C * (sr * dr - si * di);
+    w->di[1][m] = C * (sr * di + si * dr);
+}
+
+static int build_wave(const tran_circuit_t *c, wave_t *w) {
+    double V = c->v_source;
+    memset(w, 0, sizeof *w);
+
+    switch (c->kind) {
+        case TRAN_RC:
+            if (!(c->R > 0) || !(c->C > 0)) { printf("Error: R and C must be positive.\n"); return 1; }
+            set_mode(w, 0, -1.0 / (c->R * c->C), 0.0);
+            w->off[0] = V;
+            w->cr[0][0] = c->v0 - V;
+            w->cr[1][0] = (V - c->v0) / c->R;
+            return 0;
+
+        case TRAN_RL:
+            if (!(c->R > 0) || !(c->L > 0)) { printf("Error: R and L must be positive.\n"); return 1; }
+            set_mode(w, 0, -c->R / c->L, 0.0);
+            w->off[1] = V / c->R;
+            w->cr[1][0] = c->i0 - V / c->R;
+            w->cr[0][0] = V - c->i0 * c->R;
+            return 0;
+
+        case TRAN_RLC: {
+            if (!(c->R >= 0) || !(c->L > 0) || !(c->C > 0)) {
+                printf("Error: L and C must be positive and R not negative.\n");
+                return 1;
+            }
+            double alpha = c->R / (2.0 * c->L), w0sq = 1.0 / (c->L * c->C);
+            double A = c->v0 - V, D = c->i0 / c->C;      /* v(0) - V, dv/dt(0) */
+            double disc = alpha * alpha - w0sq;
+            w->off[0] = V;
+
+            if (fabs(disc) <= 1e-9 * w0sq) {             /* critically damped */
+                set_mode(w, 0, -alpha, 0.0);
+                w->cr[0][0] = A;
+                w->dr[0][0] = D + alpha * A;
+            } else if (disc < 0) {                       /* underdamped: A cos + B sin */
+                double wd = sqrt(-disc);
+                set_mode(w, 0, -alpha, wd);
+                w->cr[0][0] = A;
+                w->ci[0][0] = -(D + alpha * A) / wd;
+            } else {                                     /* overdamped: two real modes */
+                double r = sqrt(disc), s1 = -alpha + r, s2 = -alpha - r;
+                double A1 = (D - s2 * A) / (s1 - s2);
+                set_mode(w, 0, s1, 0.0);
+                set_mode(w, 1, s2, 0.0);
+                w->cr[0][0] = A1;
+                w->cr[0][1] = A - A1;
+            }
+            for (int m = 0; m < w->n_modes; m++) current_from_voltage(w, m, c->C);
+            return 0;
+        }
+    }
+    printf("Error: unknown circuit.\n");
+    return 1;
+}
+
+/* ────────────────────────────────────────────────
+   KERNEL
+   Four consecutive samples per vector; e^(st) for each
+   lane advances by e^(4sh) per step.
+   ──────────────────────────────────────────────── */
+
+/* Samples skip .. skip+n-1 after the anchor k0, written from v[0] and
+   i[0]. The recurrence always starts at the anchor and steps over the
+   skipped vectors, so a sample's value does not depend on where the
+   caller's range began. */
+static inline __attribute__((always_inline))
+void wave_segment(const wave_t *w, double h, uint64_t k0, size_t skip, size_t n, double *v, double *i) {
+    tr_vec_t zr[2], zi[2], t;
+    double stepr[2], stepi[2];
+    for (int m = 0; m < w->n_modes; m++) {
+        double e = exp(w->sr[m] * LANES * h);
+        stepr[m] = e * cos(w->si[m] * LANES * h);
+        stepi[m] = e * sin(w->si[m] * LANES * h);
+        for (int l = 0; l < LANES; l++) {
+            double tl = (double)(k0 + l) * h, el = exp(w->sr[m] * tl);
+            zr[m][l] = el * cos(w->si[m] * tl);
+            zi[m][l] = el * sin(w->si[m] * tl);
+        }
+    }
+    tr_vec_t k;
+    for (int l = 0; l < LANES; l++) k[l] = (double)(k0 + l);
+
+    size_t end = skip + n;
+    for (size_t j = 0; j < end; j += LANES) {
+        if (j + LANES > skip) {
+            t = k * h;
+            tr_vec_t y[2];
+            for (int ch = 0; ch < 2; ch++) {
+                y[ch] = (tr_vec_t){ 0 } + w->off[ch];
+                for (int m = 0; m < w->n_modes; m++) {
+                    y[ch] += w->cr[ch][m] * zr[m] - w->ci[ch][m] * zi[m];
+                    y[ch] += t * (w->dr[ch][m] * zr[m] - w->di[ch][m] * zi[m]);
+                }
+            }
+            size_t from = j < skip ? skip - j : 0, cnt = end - j < LANES ? end - j : LANES;
+            for (size_t l = from; l < cnt; l++) {
+                if (v) v[j + l - skip] = y[0][l];
+                if (i) i[j + l - skip] = y[1][l];
+            }
+        }
+        for (int m = 0; m < w->n_modes; m++) {
+            tr_vec_t r = zr[m] * stepr[m] - zi[m] * stepi[m];
+            zi[m] = zr[m] * stepi[m] + zi[m] * stepr[m];
+            zr[m] = r;
+        }
+        k += LANES;
+    }
+}
+
+/* Every segment starts from the multiple of ANCHOR at or below it */
+static inline __attribute__((always_inline))
+void wave_fill_body(const wave_t *w, double h, uint64_t first, size_t n, double *v, double *i) {
+    size_t done = 0;
+    while (done < n) {
+        uint64_t k = first + done;
+        size_t skip = (size_t)(k % ANCHOR), len = ANCHOR - skip;
+        if (len > n - done) len = n - done;
+        wave_segment(w, h, k - skip, skip, len, v ? v + done : NULL, i ? i + done : NULL);
+        done += len;
+    }
+}
+
+SIMD_KERNEL(wave_fill, (const wave_t *w, double h, uint64_t first, size_t n, double *v, double *i),
+            (w, h, first, n, v, i))
+
+typedef void (*fill_fn)(const wave_t *w, double h, uint64_t first, size_t n, double *v, double *i);
+
+int tran_samples(const tran_circuit_t *c, double rate, uint64_t first, size_t n, double *v, double *i) {
+    wave_t w;
+    if (!(rate > 0)) { printf("Error: sample rate must be positive.\n"); return 1; }
+    if (build_wave(c, &w)) return 1;
+    wave_fill_pick()(&w, 1.0 / rate, first, n, v, i);
+    return 0;
+}
+
+/* ────────────────────────────────────────────────
+   STREAMING
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    double *v, *i;
+    char *buf;
+    size_t len;
+} tran_out_t;
+
+typedef struct {
+    const wave_t *w;
+    fill_fn fill;
+    double h;
+    uint64_t pos, n;                /* window start, total samples */
+    int format;
+    tran_out_t *outs;
+} tran_chunk_t;
+
+static size_t sample_bytes(int format) {
+    return format == TRAN_CSV ? CSV_MAX : format == TRAN_F64 ? 3 * sizeof(double) : 3 * sizeof(float);
+}
+
+static void tran_task(void *ctx, int task) {
+    tran_chunk_t *ch = ctx;
+    tran_out_t *o = &ch->outs[task];
+    uint64_t first = ch->pos + (uint64_t)task * BLOCK;
+    o->len = 0;
+    if (first >= ch->n) return;
+    size_t n = ch->n - first < BLOCK ? (size_t)(ch->n - first) : BLOCK;
+    ch->fill(ch->w, ch->h, first, n, o->v, o->i);
+
+    char *p = o->buf;
+    for (size_t s = 0; s < n; s++) {
+        double t = (double)(first + s) * ch->h;
+        if (ch->format == TRAN_CSV) {
+            p += format_shortest(p, 32, t);
+            *p++ = ',';
+            p += format_shortest(p, 32, o->v[s]);
+            *p++ = ',';
+            p += format_shortest(p, 32, o->i[s]);
+            *p++ = '\n';
+        } else if (ch->format == TRAN_F64) {
+            double rec[3] = { t, o->v[s], o->i[s] };
+            memcpy(p, rec, sizeof rec);
+            p += sizeof rec;
+        } else {
+            float rec[3] = { (float)t, (float)o->v[s], (float)o->i[s] };
+            memcpy(p, rec, sizeof rec);
+            p += sizeof rec;
+        }
+    }
+    o->len = (size_t)(p - o->buf);
+}
+
+int tran_write(const tran_circuit_t *c, double rate, uint64_t n_samples, int format, const char *path) {
+    wave_t w;
+    if (format != TRAN_CSV && format != TRAN_F64 && format != TRAN_F32) {
+        printf("Error: unknown output format.\n");
+        return 1;
+    }
+    if (!(rate > 0)) { printf("Error: sample rate must be positive.\n"); return 1; }
+    if (build_wave(c, &w)) return 1;
+    FILE *out = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+    if (!out) { printf("Error: cannot create %s\n", path); return 1; }
+
+    int n_tasks = par_threads() * 2;
+    tran_out_t *outs = calloc(n_tasks, sizeof(tran_out_t));
+    int rc = outs ? 0 : 1;
+    for (int t = 0; !rc && t < n_tasks; t++) {
+        outs[t].v = malloc(BLOCK * sizeof(double));
+        outs[t].i = malloc(BLOCK * sizeof(double));
+        outs[t].buf = malloc(BLOCK * sample_bytes(format));
+        if (!outs[t].v || !outs[t].i || !outs[t].buf) rc = 1;
+    }
+    if (rc) printf("Error: out of memory\n");
+
+    if (!rc && format == TRAN_CSV && fputs("time,voltage,current\n", out) == EOF) rc = 2;
+    tran_chunk_t chunk = { &w, wave_fill_pick(), 1.0 / rate, 0, n_samples, format, outs };
+    for (uint64_t pos = 0; !rc && pos < n_samples; pos += (uint64_t)n_tasks * BLOCK) {
+        chunk.pos = pos;
+        uint64_t left = (n_samples - pos + BLOCK - 1) / BLOCK;
+        int tasks = left < (uint64_t)n_tasks ? (int)left : n_tasks;
+        par_for(tasks, tran_task, &chunk);
+        for (int t = 0; t < tasks; t++)
+            if (fwrite(outs[t].buf, 1, outs[t].len, out) != outs[t].len) rc = 2;
+    }
+
+    if (outs)
+        for (int t = 0; t < n_tasks; t++) {
+            free(outs[t].v);
+            free(outs[t].i);
+            free(outs[t].buf);
+        }
+    free(outs);
+    if (out != stdout) { if (fclose(out) != 0 && !rc) rc = 2; }
+    else fflush(out);
+    if (rc == 2) printf("Error: writing %s failed\n", path);
+    return rc != 0;
+}
+
+/* ────────────────────────────────────────────────
+   SUMMARY AND PROMPTS
+   ──────────────────────────────────────────────── */
+
+static void print_quantity(const char *label, double value, const char *unit) {
+    char buf[PREFIX_FMT_MAX + 16];
+    format_with_prefix(buf, sizeof buf, value, unit);
+    printf("%s%s\n", label, buf);
+}
+
+void tran_describe(const tran_circuit_t *c) {
+    wave_t w;
+    if (build_wave(c, &w)) return;
+    if (c->kind != TRAN_RLC) {
+        double tau = -1.0 / w.sr[0];
+        print_quantity(c->kind == TRAN_RC ? "Time constant τ = RC: " : "Time constant τ = L/R: ", tau, "s");
+        print_quantity("Settles within 1% after 5τ: ", 5 * tau, "s");
+        return;
+    }
+
+    double alpha = c->R / (2.0 * c->L), w0 = 1.0 / sqrt(c->L * c->C);
+    double zeta = alpha / w0;
+    print_quantity("Resonant frequency f0: ", w0 / (2 * M_PI), "Hz");
+    printf("Damping ratio ζ = %.4g (%s)\n", zeta,
+           w.si[0] != 0 ? "underdamped" : w.n_modes == 2 ? "overdamped" : "critically damped");
+    if (w.si[0] != 0) {
+        print_quantity("Ringing frequency fd: ", w.si[0] / (2 * M_PI), "Hz");
+        if (zeta > 0) printf("Overshoot on a step: %.4g %%\n", 100 * exp(-M_PI * zeta / sqrt(1 - zeta * zeta)));
+    }
+    double slowest = w.n_modes == 2 ? fmax(w.sr[0], w.sr[1]) : w.sr[0];
+    if (slowest < 0) print_quantity("Settles within 2% after about: ", 4.0 / -slowest, "s");
+    else printf("No resistance: oscillates forever.\n");
+}
+
+void transient_dialog(int kind) {
+    tran_circuit_t c = { 0 };
+    int choice;
+    printf("Circuit (1 = series %s, 2 = series RLC): ", kind == TRAN_RL ? "RL" : "RC");
+    if (scanf("%d", &choice) != 1 || (choice != 1 && choice != 2)) { printf("Invalid option.\n"); return; }
+    c.kind = choice == 2 ? TRAN_RLC : kind;
+
+    c.R = read_number("Resistance (Ω): ");
+    if (c.kind != TRAN_RC) c.L = read_number("Inductance (H): ");
+    if (c.kind != TRAN_RL) c.C = read_number("Capacitance (F): ");
+    c.v_source = read_number("Step voltage applied at t = 0 (0 for discharge/decay): ");
+    if (c.kind != TRAN_RL) c.v0 = read_number("Initial capacitor voltage (V): ");
+    if (c.kind != TRAN_RC) c.i0 = read_number("Initial inductor current (A): ");
+    if (isnan(c.R) || isnan(c.L) || isnan(c.C) || isnan(c.v_source) || isnan(c.v0) || isnan(c.i0)) {
+        printf("Invalid input.\n");
+        return;
+    }
+    tran_describe(&c);
+
+    double rate = read_number("Sample rate (samples/s, e.g. 10M): ");
+    double count = read_number("Number of samples (e.g. 1G, 0 = none): ");
+    if (!(count >= 1)) return;
+    int format;
+    printf("Output format (0 = CSV, 1 = binary double t/v/i, 2 = binary float t/v/i): ");
+    if (scanf("%d", &format) != 1) return;
+    char path[256];
+    printf("Output file: ");
+    if (scanf("%255s", path) != 1) return;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int rc = tran_write(&c, rate, (uint64_t)count, format, path);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc) return;
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    printf("%.0f samples (%.6g s of signal) in %.3f s: %.1f M samples/s\n",
+           count, (uint64_t)count / rate, secs, secs > 0 ? (uint64_t)count / secs / 1e6 : 0.0);
+}
@@ -0,0 +1,53 @@
+#ifndef TRANSIENT_H
+#define TRANSIENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Step and natural responses of series RC, RL and RLC circuits.
+
+   At t = 0 a step source v_source is switched across the series circuit
+   (0 V for a discharge / decay); the capacitor starts at v0 and the
+   inductor at i0. Each sample gives a voltage and the loop current:
+       RC:  capacitor voltage, current
+       RL:  inductor voltage, inductor current
+       RLC: capacitor voltage, current
+   Waveforms are built from the closed-form solution, four consecutive
+   samples at a time: each lane's e^(st) advances by one complex multiply
+   with e^(4sh) per step, and is recomputed exactly at every multiple of
+   1024 samples so long captures do not drift. Every range replays the
+   recurrence from the multiple of 1024 below it, so a sample's value does
+   not depend on how the capture was split. */
+
+#define TRAN_RC  0
+#define TRAN_RL  1
+#define TRAN_RLC 2
+
+typedef struct {
+    int kind;                   /* TRAN_RC, TRAN_RL or TRAN_RLC */
+    double R, L, C;             /* ohms, henries, farads (unused ones ignored) */
+    double v_source;            /* step applied at t = 0 */
+    double v0, i0;              /* initial capacitor voltage, inductor current */
+} tran_circuit_t;
+
+/* Samples first .. first+n-1 at 'rate' samples/s into v and i (either may
+   be NULL). Returns 0, or 1 (after printing why) for an invalid circuit. */
+int tran_samples(const tran_circuit_t *c, double rate, uint64_t first, size_t n, double *v, double *i);
+
+#define TRAN_CSV 0              /* "time,voltage,current" lines */
+#define TRAN_F64 1              /* raw native doubles: t, v, i per sample */
+#define TRAN_F32 2              /* raw native floats:  t, v, i per sample */
+
+/* Stream n_samples to path ("-" = stdout), generated in blocks on the
+   worker pool and written in order, so captures far larger than memory
+   work. Returns 0 on success. */
+int tran_write(const tran_circuit_t *c, double rate, uint64_t n_samples, int format, const char *path);
+
+/* Time constant, damping and settling summary for the circuit */
+void tran_describe(const tran_circuit_t *c);
+
+/* Interactive prompts behind the capacitor / inductor menus; kind is the
+   first-order circuit offered next to the series RLC */
+void transient_dialog(int kind);
+
+#endif
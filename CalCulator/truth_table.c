@@ -0,0 +1,388 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel.h"
+#include "truth_table.h"
+
+/* 256 rows per word; the interpreter handles UNROLL consecutive blocks per
+   instruction so that dispatch is paid once per 1024 rows */
+typedef uint64_t tt_word_t __attribute__((vector_size(32)));
+
+#define UNROLL        4
+#define MAX_SLOTS     65535
+#define TEXT_BLOCKS   64        /* blocks per task per round when writing text */
+#define PACKED_BLOCKS 4096      /* ... and when writing packed bits */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TT_X86 1
+#endif
+
+/* ────────────────────────────────────────────────
+   PROGRAM CONSTRUCTION
+   ──────────────────────────────────────────────── */
+
+tt_program_t *tt_program_new(int n_inputs) {
+    if (n_inputs < 1 || n_inputs > TT_MAX_INPUTS) return NULL;
+    tt_program_t *p = calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->n_inputs = n_inputs;
+    p->n_slots = n_inputs;
+    return p;
+}
+
+void tt_program_free(tt_program_t *p) {
+    if (!p) return;
+    free(p->code);
+    free(p);
+}
+
+int tt_emit(tt_program_t *p, int op, int a, int b) {
+    int operands = op == TT_NOT ? 1 : op <= TT_XOR ? 2 : 0;
+    if (op < TT_AND || op > TT_CONST1 || p->n_slots >= MAX_SLOTS) return -1;
+    if ((operands >= 1 && (a < 0 || a >= p->n_slots)) || (operands == 2 && (b < 0 || b >= p->n_slots)))
+        return -1;
+    if (p->n_code == p->cap_code) {
+        int cap = p->cap_code ? p->cap_code * 2 : 32;
+        tt_insn_t *c = realloc(p->code, cap * sizeof(tt_insn_t));
+        if (!c) return -1;
+        p->code = c;
+        p->cap_code = cap;
+    }
+    tt_insn_t *in = &p->code[p->n_code++];
+    in->op = (unsigned char)op;
+    in->dst = (unsigned short)p->n_slots;
+    in->a = (unsigned short)(operands >= 1 ? a : 0);
+    in->b = (unsigned short)(operands == 2 ? b : 0);
+    return p->n_slots++;
+}
+
+int tt_add_output(tt_program_t *p, int slot) {
+    if (slot < 0 || slot >= p->n_slots || p->n_outputs == TT_MAX_OUTPUTS) return 1;
+    p->outputs[p->n_outputs++] = (unsigned short)slot;
+    return 0;
+}
+
+tt_program_t *tt_gate_program(int gate_type, int n_inputs) {
+    static const int chain_op[6] = { TT_AND, TT_OR, TT_AND, TT_OR, TT_XOR, TT_XOR };
+    if (gate_type < 0 || gate_type > 6) return NULL;
+    tt_program_t *p = tt_program_new(n_inputs);
+    if (!p) return NULL;
+
+    int s;
+    if (gate_type == 6) {
+        s = tt_emit(p, TT_NOT, 0, 0);
+    } else {
+        s = 0;
+        for (int i = 1; i < n_inputs && s >= 0; i++) s = tt_emit(p, chain_op[gate_type], s, i);
+        if (s >= 0 && (gate_type == 2 || gate_type == 3 || gate_type == 5))
+            s = tt_emit(p, TT_NOT, s, 0);
+    }
+    if (s < 0 || tt_add_output(p, s)) { tt_program_free(p); return NULL; }
+    return p;
+}
+
+/* ────────────────────────────────────────────────
+   BIT-SLICED EVALUATION
+   Row r = block·256 + lane·64 + bit. Row bits 0-5
+   are fixed patterns inside each 64-bit lane, bits
+   6-7 select lanes, higher bits are constant over a
+   block.
+   ──────────────────────────────────────────────── */
+
+static const uint64_t in_lane_pattern[6] = {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+};
+
+/* Fill the input slots for blocks block..block+UNROLL-1. When the
+   previous group is given and both groups are UNROLL-aligned, only the
+   inputs whose value differs are rewritten: row bits 0-9 repeat
+   identically in every aligned group. */
+static void load_inputs(const tt_program_t *p, tt_word_t (*slots)[UNROLL],
+                        uint64_t block, const uint64_t *prev) {
+    int aligned = prev && block % UNROLL == 0 && *prev % UNROLL == 0;
+    for (int i = 0; i < p->n_inputs; i++) {
+        int bit = p->n_inputs - 1 - i;
+        if (aligned && (bit < 10 || !(((block ^ *prev) >> (bit - 8)) & 1)))
+            continue;
+        for (int u = 0; u < UNROLL; u++) {
+            uint64_t *w = (uint64_t *)&slots[i][u];
+            for (int lane = 0; lane < 4; lane++) {
+                if (bit < 6)       w[lane] = in_lane_pattern[bit];
+                else if (bit < 8)  w[lane] = (lane >> (bit - 6)) & 1 ? ~0ull : 0;
+                else               w[lane] = ((block + u) >> (bit - 8)) & 1 ? ~0ull : 0;
+            }
+        }
+    }
+}
+
+static inline __attribute__((always_inline))
+void run_code(const tt_program_t *p, tt_word_t (*slots)[UNROLL]) {
+    const tt_word_t zero = { 0, 0, 0, 0 }, ones = ~zero;
+    for (int k = 0; k < p->n_code; k++) {
+        const tt_insn_t *in = &p->code[k];
+        tt_word_t *d = slots[in->dst];
+        const tt_word_t *a = slots[in->a], *b = slots[in->b];
+        switch (in->op) {
+            case TT_AND:    for (int u = 0; u < UNROLL; u++) d[u] = a[u] & b[u]; break;
+            case TT_OR:     for (int u = 0; u < UNROLL; u++) d[u] = a[u] | b[u]; break;
+            case TT_XOR:    for (int u = 0; u < UNROLL; u++) d[u] = a[u] ^ b[u]; break;
+            case TT_NOT:    for (int u = 0; u < UNROLL; u++) d[u] = ~a[u]; break;
+            case TT_CONST0: for (int u = 0; u < UNROLL; u++) d[u] = zero; break;
+            default:        for (int u = 0; u < UNROLL; u++) d[u] = ones; break;
+        }
+    }
+}
+
+static void run_code_generic(const tt_program_t *p, tt_word_t (*slots)[UNROLL]) {
+    run_code(p, slots);
+}
+
+#ifdef TT_X86
+__attribute__((target("avx2")))
+static void run_code_avx2(const tt_program_t *p, tt_word_t (*slots)[UNROLL]) {
+    run_code(p, slots);
+}
+#endif
+
+typedef void (*run_fn)(const tt_program_t *p, tt_word_t (*slots)[UNROLL]);
+
+static run_fn pick_run_fn(void) {
+#ifdef TT_X86
+    if (__builtin_cpu_supports("avx2")) return run_code_avx2;
+#endif
+    return run_code_generic;
+}
+
+static tt_word_t (*alloc_slots(const tt_program_t *p))[UNROLL] {
+    return aligned_alloc(32, (size_t)p->n_slots * UNROLL * sizeof(tt_word_t));
+}
+
+static uint64_t total_blocks(const tt_program_t *p) {
+    return p->n_inputs >= 8 ? 1ull << (p->n_inputs - 8) : 1;
+}
+
+/* As tt_eval_blocks, with caller-provided slot storage */
+static void eval_blocks(const tt_program_t *p, run_fn run, tt_word_t (*slots)[UNROLL],
+                        uint64_t first, uint64_t n, uint64_t *out) {
+    int n_out = p->n_outputs;
+    uint64_t last = total_blocks(p);
+
+    for (uint64_t g = 0; g < n; g += UNROLL) {
+        uint64_t prev = first + g - UNROLL;
+        load_inputs(p, slots, first + g, g ? &prev : NULL);
+        run(p, slots);
+        for (int u = 0; u < UNROLL && g + u < n; u++) {
+            uint64_t *dst = out + (g + u) * n_out * 4;
+            for (int o = 0; o < n_out; o++) {
+                if (first + g + u >= last) { memset(dst + o * 4, 0, 32); continue; }
+                memcpy(dst + o * 4, &slots[p->outputs[o]][u], 32);
+            }
+        }
+    }
+
+    /* Tables under 256 rows: clear the bits past the last row */
+    if (p->n_inputs < 8 && first == 0 && n > 0) {
+        int rows = 1 << p->n_inputs;
+        for (int o = 0; o < n_out; o++)
+            for (int lane = 0; lane < 4; lane++) {
+                int lo = lane * 64;
+                uint64_t keep = rows >= lo + 64 ? ~0ull : rows <= lo ? 0 : (1ull << (rows - lo)) - 1;
+                out[o * 4 + lane] &= keep;
+            }
+    }
+}
+
+void tt_eval_blocks(const tt_program_t *p, uint64_t first_block, uint64_t n_blocks, uint64_t *out) {
+    tt_word_t (*slots)[UNROLL] = alloc_slots(p);
+    if (!slots) { memset(out, 0, n_blocks * p->n_outputs * 32); return; }
+    eval_blocks(p, pick_run_fn(), slots, first_block, n_blocks, out);
+    free(slots);
+}
+
+/* ────────────────────────────────────────────────
+   PARALLEL COUNT
+   ──────────────────────────────────────────────── */
+
+#define COUNT_BATCH 256         /* blocks evaluated per inner step */
+
+typedef struct {
+    const tt_program_t *p;
+    run_fn run;
+    int output, n_tasks;
+    uint64_t *counts;
+} count_job_t;
+
+static void count_task(void *ctx, int task) {
+    count_job_t *job = ctx;
+    const tt_program_t *p = job->p;
+    uint64_t total = total_blocks(p);
+    uint64_t begin = total * task / job->n_tasks / UNROLL * UNROLL;
+    uint64_t end = task == job->n_tasks - 1 ? total : total * (task + 1) / job->n_tasks / UNROLL * UNROLL;
+    uint64_t *bits = malloc((size_t)COUNT_BATCH * p->n_outputs * 32);
+    tt_word_t (*slots)[UNROLL] = alloc_slots(p);
+    uint64_t count = 0;
+
+    if (bits && slots) {
+        for (uint64_t b = begin; b < end; b += COUNT_BATCH) {
+            uint64_t n = end - b < COUNT_BATCH ? end - b : COUNT_BATCH;
+            eval_blocks(p, job->run, slots, b, n, bits);
+            for (uint64_t k = 0; k < n; k++)
+                for (int lane = 0; lane < 4; lane++)
+                    count += __builtin_popcountll(bits[(k * p->n_outputs + job->output) * 4 + lane]);
+        }
+    } else {
+        count = UINT64_MAX;
+    }
+    free(bits);
+    free(slots);
+    job->counts[task] = count;
+}
+
+uint64_t tt_count_ones(const tt_program_t *p, int output) {
+    if (output < 0 || output >= p->n_outputs) return 0;
+    uint64_t blocks = total_blocks(p);
+    uint64_t batches = blocks / COUNT_BATCH ? blocks / COUNT_BATCH : 1;
+    int n_tasks = par_threads() * 4;
+    if (n_tasks > 1024) n_tasks = 1024;
+    if ((uint64_t)n_tasks > batches) n_tasks = (int)batches;
+
+    uint64_t counts[1024], total = 0;
+    count_job_t job = { p, pick_run_fn(), output, n_tasks, counts };
+    par_for(n_tasks, count_task, &job);
+    for (int t = 0; t < n_tasks; t++) {
+        if (counts[t] == UINT64_MAX) return UINT64_MAX;
+        total += counts[t];
+    }
+    return total;
+}
+
+/* ────────────────────────────────────────────────
+   STREAMING WRITER
+   Each round, every task fills a run of blocks into
+   its own buffer; buffers are written in task order.
+   ──────────────────────────────────────────────── */
+
+typedef struct {
+    char *buf;
+    size_t len;
+} tt_out_t;
+
+typedef struct {
+    const tt_program_t *p;
+    run_fn run;
+    int format;
+    uint64_t first, per_task, end;
+    size_t line_len;
+    char (*low_text)[16];       /* text of the 8 lowest-order inputs, per row % 256 */
+    tt_out_t *outs;
+    int failed;
+} write_job_t;
+
+static size_t packed_block_bytes(const tt_program_t *p) {
+    return p->n_inputs >= 8 ? 32 : ((1u << p->n_inputs) + 7) / 8;
+}
+
+static void put_text_block(const write_job_t *job, uint64_t block, const uint64_t *bits, char *dst) {
+    const tt_program_t *p = job->p;
+    int n = p->n_inputs, n_low = n < 8 ? n : 8, n_high = n - n_low;
+    int rows = n < 8 ? 1 << n : TT_BLOCK_ROWS;
+    char high[2 * TT_MAX_INPUTS];
+
+    for (int i = 0; i < n_high; i++) {
+        high[2 * i] = '0' + (int)((block >> (n_high - 1 - i)) & 1);
+        high[2 * i + 1] = ' ';
+    }
+    for (int r = 0; r < rows; r++) {
+        char *line = dst + (size_t)r * job->line_len;
+        memcpy(line, high, 2 * n_high);
+        memcpy(line + 2 * n_high, job->low_text[r], 2 * n_low);
+        char *o = line + 2 * n;
+        *o++ = '|';
+        for (int k = 0; k < p->n_outputs; k++) {
+            *o++ = ' ';
+            *o++ = '0' + (int)((bits[k * 4 + r / 64] >> (r % 64)) & 1);
+        }
+        *o = '\n';
+    }
+}
+
+static void write_task(void *ctx, int task) {
+    write_job_t *job = ctx;
+    const tt_program_t *p = job->p;
+    tt_out_t *out = &job->outs[task];
+    uint64_t begin = job->first + job->per_task * task;
+    uint64_t end = begin + job->per_task < job->end ? begin + job->per_task : job->end;
+    size_t block_words = (size_t)p->n_outputs * 4;
+
+    out->len = 0;
+    if (begin >= end) return;
+
+    uint64_t *bits = malloc((end - begin) * block_words * sizeof(uint64_t));
+    tt_word_t (*slots)[UNROLL] = alloc_slots(p);
+    if (!bits || !slots) { job->failed = 1; free(bits); free(slots); return; }
+    eval_blocks(p, job->run, slots, begin, end - begin, bits);
+
+    for (uint64_t b = begin; b < end; b++) {
+        const uint64_t *blk = bits + (b - begin) * block_words;
+        if (job->format == TT_TEXT) {
+            int rows = p->n_inputs < 8 ? 1 << p->n_inputs : TT_BLOCK_ROWS;
+            put_text_block(job, b, blk, out->buf + out->len);
+            out->len += (size_t)rows * job->line_len;
+        } else {
+            size_t nb = packed_block_bytes(p);
+            for (int o = 0; o < p->n_outputs; o++) {
+                unsigned char *d = (unsigned char *)out->buf + out->len;
+                for (size_t k = 0; k < nb; k++)                 /* byte order independent of host */
+                    d[k] = (unsigned char)(blk[o * 4 + k / 8] >> (8 * (k % 8)));
+                out->len += nb;
+            }
+        }
+    }
+    free(bits);
+    free(slots);
+}
+
+int tt_write(const tt_program_t *p, FILE *f, int format) {
+    if (p->n_outputs == 0 || (format != TT_TEXT && format != TT_PACKED)) return 1;
+
+    int n_tasks = par_threads() * 4;
+    uint64_t blocks = total_blocks(p);
+    uint64_t per_task = format == TT_TEXT ? TEXT_BLOCKS : PACKED_BLOCKS;
+    size_t line_len = 2 * p->n_inputs + 1 + 2 * p->n_outputs + 1;
+    size_t block_bytes = format == TT_TEXT ? TT_BLOCK_ROWS * line_len
+                                           : packed_block_bytes(p) * p->n_outputs;
+    char (*low_text)[16] = malloc(TT_BLOCK_ROWS * sizeof(*low_text));
+    tt_out_t *outs = calloc(n_tasks, sizeof(tt_out_t));
+    int rc = 0;
+
+    if (!low_text || !outs) rc = 1;
+    for (int t = 0; !rc && t < n_tasks; t++)
+        if (!(outs[t].buf = malloc(per_task * block_bytes))) rc = 1;
+
+    if (!rc) {
+        int n_low = p->n_inputs < 8 ? p->n_inputs : 8;
+        for (int r = 0; r < TT_BLOCK_ROWS; r++)
+            for (int i = 0; i < n_low; i++) {
+                low_text[r][2 * i] = '0' + ((r >> (n_low - 1 - i)) & 1);
+                low_text[r][2 * i + 1] = ' ';
+            }
+    }
+
+    write_job_t job = { p, pick_run_fn(), format, 0, per_task, blocks, line_len, low_text, outs, 0 };
+    for (uint64_t first = 0; !rc && first < blocks; first += per_task * n_tasks) {
+        int tasks = (int)((blocks - first + per_task - 1) / per_task);
+        if (tasks > n_tasks) tasks = n_tasks;
+        job.first = first;
+        par_for(tasks, write_task, &job);
+        if (job.failed) rc = 1;
+        for (int t = 0; !rc && t < tasks; t++)
+            if (fwrite(outs[t].buf, 1, outs[t].len, f) != outs[t].len) rc = 1;
+    }
+
+    if (outs)
+        for (int t = 0; t < n_tasks; t++) free(outs[t].buf);
+    free(outs);
+    free(low_text);
+    return rc;
+}
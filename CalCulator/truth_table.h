@@ -0,0 +1,61 @@
+#ifndef TRUTH_TABLE_H
+#define TRUTH_TABLE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Bit-sliced truth tables for functions of up to 32 inputs. A function is
+   a straight-line program over "slots", each holding one bit of many rows
+   at once; inputs occupy slots 0..n_inputs-1, input 0 being the most
+   significant bit of the row number (the leftmost column when printed). */
+
+#define TT_MAX_INPUTS  32
+#define TT_MAX_OUTPUTS 16
+#define TT_BLOCK_ROWS  256      /* rows per evaluated word */
+
+#define TT_AND    0
+#define TT_OR     1
+#define TT_XOR    2
+#define TT_NOT    3             /* a only */
+#define TT_CONST0 4             /* no operands */
+#define TT_CONST1 5
+
+typedef struct {
+    unsigned char op;
+    unsigned short dst, a, b;
+} tt_insn_t;
+
+typedef struct {
+    int n_inputs, n_slots;
+    int n_code, cap_code;
+    tt_insn_t *code;
+    int n_outputs;
+    unsigned short outputs[TT_MAX_OUTPUTS];
+} tt_program_t;
+
+tt_program_t *tt_program_new(int n_inputs);             /* NULL if out of range */
+void tt_program_free(tt_program_t *p);
+int tt_emit(tt_program_t *p, int op, int a, int b);     /* new slot, -1 on error */
+int tt_add_output(tt_program_t *p, int slot);           /* 0 on success */
+
+/* One gate (gate_eval() numbering) across all inputs */
+tt_program_t *tt_gate_program(int gate_type, int n_inputs);
+
+/* Output bits of blocks [first_block, first_block + n_blocks): for each
+   block and each output, 4 words of 64 rows, row r at bit r % 64 of word
+   (r % 256) / 64. Rows past the end of the table read 0. */
+void tt_eval_blocks(const tt_program_t *p, uint64_t first_block, uint64_t n_blocks, uint64_t *out);
+
+/* Number of rows where output 'output' is 1, counted on all threads */
+uint64_t tt_count_ones(const tt_program_t *p, int output);
+
+/* Stream the whole table, filling rows on all threads in bounded memory.
+   TT_TEXT: one "0 1 1 | 1" line per row.
+   TT_PACKED: per 256-row block, each output's 32 bytes of row bits
+   (row r at bit r % 8 of byte r / 8); tables under 256 rows are cut to
+   whole bytes. Returns 0 on success. */
+#define TT_TEXT   0
+#define TT_PACKED 1
+int tt_write(const tt_program_t *p, FILE *f, int format);
+
+#endif